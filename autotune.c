@@ -0,0 +1,355 @@
+/******************************************************************************
+* File Name: autotune.c
+*
+* Description: This file contains the production threshold derivation: raw
+*              count statistics of a no-touch and a touch window, thresholds
+*              from the README rules, and their persistence in the profile
+*              store.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <string.h>
+#include "autotune.h"
+#include "scratch.h"
+
+#if AUTOTUNE_EN
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+/* Tuning record, provided by the register map */
+static autotune_t *autotune;
+
+/* Raw count statistics of the running window */
+static uint32_t autotune_sum[CY_CAPSENSE_SENSOR_COUNT];
+static uint16_t autotune_min[CY_CAPSENSE_SENSOR_COUNT];
+static uint16_t autotune_max[CY_CAPSENSE_SENSOR_COUNT];
+
+/* Frames of the running window including the settle frames */
+static uint32_t autotune_count;
+
+/* A no-touch window was completed */
+static bool autotune_have_idle = false;
+
+/*******************************************************************************
+* Function Name: autotune_init
+********************************************************************************
+* Summary:
+*  Sets the storage of the tuning record and clears it.
+*
+* Parameters:
+*  storage - storage of the record
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void autotune_init(autotune_t *storage)
+{
+    autotune = storage;
+    memset(autotune, 0, sizeof(autotune_t));
+    autotune->window = AUTOTUNE_WINDOW_NONE;
+    autotune->sensors = CY_CAPSENSE_SENSOR_COUNT;
+    autotune->widgets = CY_CAPSENSE_WIDGET_COUNT;
+}
+
+/*******************************************************************************
+* Function Name: autotune_start
+********************************************************************************
+* Summary:
+*  Starts a measurement window. The no-touch window gives the raw count mean
+*  and peak-to-peak noise of every sensor. A touch window gives the signal of
+*  every sensor that rises above its noise, so the fixture can touch all
+*  sensors at once or in groups over several windows.
+*
+* Parameters:
+*  window - AUTOTUNE_WINDOW_NO_TOUCH or AUTOTUNE_WINDOW_TOUCH
+*
+* Return:
+*  bool - false for an unknown window, or a touch window before a no-touch one
+*
+*******************************************************************************/
+bool autotune_start(uint32_t window)
+{
+    uint32_t i;
+
+    if ((AUTOTUNE_WINDOW_NO_TOUCH != window) &&
+        ((AUTOTUNE_WINDOW_TOUCH != window) || !autotune_have_idle))
+    {
+        return false;
+    }
+
+    for (i = 0u; i < CY_CAPSENSE_SENSOR_COUNT; i++)
+    {
+        autotune_sum[i] = 0u;
+        autotune_min[i] = UINT16_MAX;
+        autotune_max[i] = 0u;
+    }
+    autotune_count = 0u;
+
+    if (AUTOTUNE_WINDOW_NO_TOUCH == window)
+    {
+        autotune_have_idle = false;
+        memset(autotune->signal, 0, sizeof(autotune->signal));
+    }
+
+    autotune->frames = 0u;
+    autotune->window = (uint8_t)window;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: autotune_update
+********************************************************************************
+* Summary:
+*  Adds the raw counts of the processed frame to the running window.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool - true when this frame completed the window
+*
+*******************************************************************************/
+bool autotune_update(void)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    uint32_t sns_index = 0u;
+    uint32_t raw;
+    uint32_t mean;
+    uint32_t wd;
+    uint32_t sns;
+    uint32_t i;
+
+    if (AUTOTUNE_WINDOW_NONE == autotune->window)
+    {
+        return false;
+    }
+
+    if (++autotune_count <= AUTOTUNE_SETTLE_FRAMES)
+    {
+        return false;
+    }
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+
+        for (sns = 0u; sns < wd_cfg->numSns; sns++)
+        {
+            raw = wd_cfg->ptrSnsContext[sns].raw;
+            autotune_sum[sns_index] += raw;
+            if (raw < autotune_min[sns_index])
+            {
+                autotune_min[sns_index] = (uint16_t)raw;
+            }
+            if (raw > autotune_max[sns_index])
+            {
+                autotune_max[sns_index] = (uint16_t)raw;
+            }
+            sns_index++;
+        }
+    }
+
+    autotune->frames = (uint16_t)(autotune_count - AUTOTUNE_SETTLE_FRAMES);
+    if (autotune->frames < AUTOTUNE_FRAMES)
+    {
+        return false;
+    }
+
+    for (i = 0u; i < CY_CAPSENSE_SENSOR_COUNT; i++)
+    {
+        mean = (autotune_sum[i] + (AUTOTUNE_FRAMES / 2u)) / AUTOTUNE_FRAMES;
+
+        if (AUTOTUNE_WINDOW_NO_TOUCH == autotune->window)
+        {
+            autotune->idle_mean[i] = (uint16_t)mean;
+            autotune->noise_pp[i] = (uint16_t)(autotune_max[i] - autotune_min[i]);
+        }
+        else if (mean > ((uint32_t)autotune->idle_mean[i] + autotune->noise_pp[i]))
+        {
+            autotune->signal[i] = (uint16_t)(mean - autotune->idle_mean[i]);
+        }
+        else
+        {
+            /* Not touched in this window, an earlier signal is kept */
+        }
+    }
+
+    if (AUTOTUNE_WINDOW_NO_TOUCH == autotune->window)
+    {
+        autotune_have_idle = true;
+    }
+    autotune->window = AUTOTUNE_WINDOW_NONE;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: autotune_apply
+********************************************************************************
+* Summary:
+*  Derives the thresholds of every widget from the smallest signal of its
+*  sensors, applies them and programs them into the NORMAL profile of the
+*  profile store, so that they are used after a reset. Call at the frame
+*  boundary while no scan is in progress; programming blocks the CPU for the
+*  flash write time of the store. The CapSense context is only updated while
+*  the NORMAL profile is active. Nothing is applied when a widget fails the
+*  checks.
+*
+* Parameters:
+*  bad_widget - set to 1 + the index of the first failing widget, or 0
+*
+* Return:
+*  bool - true if the thresholds were applied and persisted
+*
+*******************************************************************************/
+bool autotune_apply(uint8_t *bad_widget)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    cy_stc_capsense_widget_context_t *wd_cxt;
+    profile_params_t *params;
+    profile_store_t *image;
+    uint32_t sns_index = 0u;
+    uint32_t signal;
+    uint32_t noise;
+    uint32_t wd;
+    uint32_t sns;
+    uint8_t result = AUTOTUNE_RESULT_APPLIED;
+
+    *bad_widget = 0u;
+
+    for (wd = 0u; (wd < CY_CAPSENSE_WIDGET_COUNT) && (AUTOTUNE_RESULT_APPLIED == result); wd++)
+    {
+        wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+        params = &autotune->params[wd];
+        signal = UINT16_MAX;
+        noise = 0u;
+
+        for (sns = 0u; sns < wd_cfg->numSns; sns++)
+        {
+            if (autotune->signal[sns_index] < signal)
+            {
+                signal = autotune->signal[sns_index];
+            }
+            if (autotune->noise_pp[sns_index] > noise)
+            {
+                noise = autotune->noise_pp[sns_index];
+            }
+            sns_index++;
+        }
+
+        autotune->widget_signal[wd] = (uint16_t)signal;
+        autotune->widget_noise[wd] = (uint16_t)noise;
+
+        if (!autotune_have_idle)
+        {
+            result = AUTOTUNE_RESULT_NO_BASELINE;
+        }
+        else if (0u == signal)
+        {
+            result = AUTOTUNE_RESULT_NO_SIGNAL;
+        }
+        else if (signal < (AUTOTUNE_MIN_SNR * noise))
+        {
+            result = AUTOTUNE_RESULT_LOW_SNR;
+        }
+        else
+        {
+            params->resolution = wd_cfg->ptrWdContext->resolution;
+            params->on_debounce = AUTOTUNE_ON_DEBOUNCE;
+            params->finger_th = (uint16_t)((signal * AUTOTUNE_FINGER_TH_PERCENT) / 100u);
+            params->noise_th = (uint16_t)((signal * AUTOTUNE_NOISE_TH_PERCENT) / 100u);
+            params->nnoise_th = (uint16_t)((signal * AUTOTUNE_NNOISE_TH_PERCENT) / 100u);
+            params->hysteresis = (uint16_t)((signal * AUTOTUNE_HYSTERESIS_PERCENT) / 100u);
+            params->low_bsln_rst = wd_cfg->ptrWdContext->lowBslnRst;
+        }
+
+        if (AUTOTUNE_RESULT_APPLIED != result)
+        {
+            *bad_widget = (uint8_t)(wd + 1u);
+        }
+    }
+
+    autotune->result = result;
+    autotune->widget = *bad_widget;
+    if (AUTOTUNE_RESULT_APPLIED != result)
+    {
+        return false;
+    }
+
+    /* The store keeps the calibrated IDAC values, only the thresholds change */
+    scratch_begin(SCRATCH_PHASE_CALIBRATION);
+    image = (profile_store_t *)scratch_alloc(sizeof(profile_store_t));
+    *image = *profiles_get_store();
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        params = &image->profile[PROFILE_NORMAL].widget[wd].params;
+        params->on_debounce = autotune->params[wd].on_debounce;
+        params->finger_th = autotune->params[wd].finger_th;
+        params->noise_th = autotune->params[wd].noise_th;
+        params->nnoise_th = autotune->params[wd].nnoise_th;
+        params->hysteresis = autotune->params[wd].hysteresis;
+
+        if (PROFILE_NORMAL == profiles_get_active())
+        {
+            wd_cxt = cy_capsense_context.ptrWdConfig[wd].ptrWdContext;
+            wd_cxt->onDebounce = (uint8_t)params->on_debounce;
+            wd_cxt->fingerTh = params->finger_th;
+            wd_cxt->noiseTh = params->noise_th;
+            wd_cxt->nNoiseTh = params->nnoise_th;
+            wd_cxt->hysteresis = params->hysteresis;
+        }
+    }
+
+    if (CY_FLASH_DRV_SUCCESS != profiles_commit(image))
+    {
+        autotune->result = AUTOTUNE_RESULT_FLASH_ERROR;
+    }
+
+    scratch_end(SCRATCH_PHASE_CALIBRATION);
+
+    return (AUTOTUNE_RESULT_APPLIED == autotune->result);
+}
+
+#endif /* AUTOTUNE_EN */
+
+/* [] END OF FILE */
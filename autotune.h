@@ -0,0 +1,139 @@
+/******************************************************************************
+* File Name: autotune.h
+*
+* Description: This file contains the macros, data types and function
+*              prototypes of the production threshold derivation.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef AUTOTUNE_H_
+#define AUTOTUNE_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_pdl.h"
+#include "cycfg_capsense.h"
+#include "profiles.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Enables threshold derivation from a no-touch and a touch window */
+#define AUTOTUNE_EN                      (0u)
+
+/* Frames per measurement window, after AUTOTUNE_SETTLE_FRAMES */
+#define AUTOTUNE_FRAMES                  (512u)
+
+/* Frames skipped at the start of a window while the fixture settles */
+#define AUTOTUNE_SETTLE_FRAMES           (32u)
+
+/* Thresholds in percent of the signal, and the debounce, from Stage 4 of
+ * README.md. LOW_BSLN_RST is kept.
+ */
+#define AUTOTUNE_FINGER_TH_PERCENT       (80u)
+#define AUTOTUNE_NOISE_TH_PERCENT        (40u)
+#define AUTOTUNE_NNOISE_TH_PERCENT       (40u)
+#define AUTOTUNE_HYSTERESIS_PERCENT      (10u)
+#define AUTOTUNE_ON_DEBOUNCE             (3u)
+
+/* Lowest accepted signal to peak-to-peak noise ratio */
+#define AUTOTUNE_MIN_SNR                 (5u)
+
+/* Windows */
+#define AUTOTUNE_WINDOW_NO_TOUCH         (0u)
+#define AUTOTUNE_WINDOW_TOUCH            (1u)
+#define AUTOTUNE_WINDOW_NONE             (0xFFu)
+
+/* Result of the last apply */
+#define AUTOTUNE_RESULT_NONE             (0u)
+#define AUTOTUNE_RESULT_APPLIED          (1u)
+#define AUTOTUNE_RESULT_NO_BASELINE      (2u) /* no no-touch window measured */
+#define AUTOTUNE_RESULT_NO_SIGNAL        (3u) /* a sensor was never touched */
+#define AUTOTUNE_RESULT_LOW_SNR          (4u) /* SNR below AUTOTUNE_MIN_SNR */
+#define AUTOTUNE_RESULT_FLASH_ERROR      (5u) /* applied, but not persisted */
+
+#if AUTOTUNE_EN
+
+#if !PROFILES_EN
+#error "AUTOTUNE_EN persists the thresholds in the profile store and requires PROFILES_EN"
+#endif
+
+#if AUTOTUNE_FRAMES > UINT16_MAX
+#error "AUTOTUNE_FRAMES must fit the 16-bit frame count"
+#endif
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Tuning record of the board. window is the running window and frames its
+ * progress. The raw count statistics are from the last windows. An apply
+ * fills in the smallest signal and largest noise of every widget and, on
+ * success, the derived widget parameters. widget is 1 + the first failing
+ * widget when result is an error.
+ */
+typedef struct
+{
+    uint8_t window;
+    uint8_t result;
+    uint8_t widget;
+    uint8_t sensors;
+    uint8_t widgets;
+    uint8_t reserved;
+    uint16_t frames;
+    uint16_t idle_mean[CY_CAPSENSE_SENSOR_COUNT];
+    uint16_t noise_pp[CY_CAPSENSE_SENSOR_COUNT];
+    uint16_t signal[CY_CAPSENSE_SENSOR_COUNT];
+    uint16_t widget_signal[CY_CAPSENSE_WIDGET_COUNT];
+    uint16_t widget_noise[CY_CAPSENSE_WIDGET_COUNT];
+    profile_params_t params[CY_CAPSENSE_WIDGET_COUNT];
+} autotune_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void autotune_init(autotune_t *storage);
+bool autotune_start(uint32_t window);
+bool autotune_update(void);
+bool autotune_apply(uint8_t *bad_widget);
+
+#endif /* AUTOTUNE_EN */
+
+#endif /* AUTOTUNE_H_ */
+
+/* [] END OF FILE */
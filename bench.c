@@ -0,0 +1,424 @@
+/******************************************************************************
+* File Name: bench.c
+*
+* Description: This file contains the synthetic-load benchmark: raw count
+*              frames for virtual sensors and cycle counts per processing stage.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <string.h>
+#include "bench.h"
+#include "timestamp.h"
+
+#if BENCH_EN
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Synthetic raw counts: a per-sensor offset from the base, up to 7 counts of
+ * noise, and touches of BENCH_TOUCH_COUNTS for a quarter of the touch period
+ */
+#define BENCH_RAW_BASE                   (600u)
+#define BENCH_RAW_SPREAD                 (64u)
+#define BENCH_TOUCH_COUNTS               (200u)
+#define BENCH_TOUCH_PERIOD               (256u)
+
+/* Marks used to measure the cost of one mark */
+#define BENCH_CALIBRATE_MARKS            (16u)
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+/* Result storage, provided by the register map */
+static bench_t *bench;
+
+/* Sensor contexts of the virtual sensors, swapped in pass by pass */
+static cy_stc_capsense_sensor_context_t bench_sns[BENCH_SLOTS];
+
+/* Virtual sensors of the current run, and the count requested by the host */
+static uint32_t bench_sensors = BENCH_SLOTS;
+static volatile uint32_t bench_pending = BENCH_SLOTS;
+
+/* Synthetic frame number and noise generator state */
+static uint32_t bench_frame = 0u;
+static uint32_t bench_lfsr = 0xACE1u;
+
+/* Start of the running stage */
+static uint32_t bench_start;
+
+/* Cycles of the current frame and totals of the run */
+static uint32_t bench_cycles[BENCH_STAGE_COUNT];
+static uint64_t bench_sum[BENCH_STAGE_COUNT];
+static uint32_t bench_max[BENCH_STAGE_COUNT];
+static uint64_t bench_frame_sum;
+static uint32_t bench_frame_max;
+static uint32_t bench_frames;
+
+/*******************************************************************************
+* Function Name: bench_clear_run
+********************************************************************************
+* Summary:
+*  Clears the totals of the measurement run.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void bench_clear_run(void)
+{
+    memset(bench_sum, 0, sizeof(bench_sum));
+    memset(bench_max, 0, sizeof(bench_max));
+    bench_frame_sum = 0u;
+    bench_frame_max = 0u;
+    bench_frames = 0u;
+}
+
+/*******************************************************************************
+* Function Name: bench_reset
+********************************************************************************
+* Summary:
+*  Starts a run with the requested number of virtual sensors. Every virtual
+*  sensor starts from the context of a configured sensor with the baseline set
+*  to its untouched raw count.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void bench_reset(void)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    uint32_t sns_index = 0u;
+    uint32_t wd;
+    uint32_t sns;
+    uint32_t v;
+
+    bench_sensors = bench_pending;
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+
+        for (sns = 0u; sns < wd_cfg->numSns; sns++)
+        {
+            for (v = sns_index; v < bench_sensors; v += CY_CAPSENSE_SENSOR_COUNT)
+            {
+                bench_sns[v] = wd_cfg->ptrSnsContext[sns];
+                bench_sns[v].raw = (uint16_t)(BENCH_RAW_BASE + ((v * 37u) % BENCH_RAW_SPREAD));
+                bench_sns[v].bsln = bench_sns[v].raw;
+                bench_sns[v].bslnExt = 0u;
+                bench_sns[v].diff = 0u;
+                bench_sns[v].status = 0u;
+                bench_sns[v].negBslnRstCnt = 0u;
+            }
+            sns_index++;
+        }
+    }
+
+    bench_clear_run();
+}
+
+/*******************************************************************************
+* Function Name: bench_init
+********************************************************************************
+* Summary:
+*  Sets the result storage, measures the cost of a stage mark and starts the
+*  first run with BENCH_SENSORS virtual sensors, rounded up.
+*
+* Parameters:
+*  storage - storage of the results
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void bench_init(bench_t *storage)
+{
+    uint32_t start;
+    uint32_t i;
+
+    bench = storage;
+    memset(bench, 0, sizeof(bench_t));
+    bench->clock_hz = timestamp_cycles_per_ms * TIMESTAMP_TICKS_PER_SEC;
+
+    bench_start = timestamp_get_cycles();
+    start = bench_start;
+    for (i = 0u; i < BENCH_CALIBRATE_MARKS; i++)
+    {
+        bench_mark(BENCH_STAGE_HOST);
+    }
+    bench->mark_cycles = (uint16_t)((timestamp_get_cycles() - start) / BENCH_CALIBRATE_MARKS);
+
+    bench_reset();
+}
+
+/*******************************************************************************
+* Function Name: bench_set_sensors
+********************************************************************************
+* Summary:
+*  Requests a run with another number of virtual sensors, rounded up to a
+*  multiple of the configured sensors. The run restarts at the next frame.
+*
+* Parameters:
+*  sensors - virtual sensors per frame, 0 for BENCH_SENSORS
+*
+* Return:
+*  bool - false if the rounded count exceeds the rounded BENCH_SENSORS
+*
+*******************************************************************************/
+bool bench_set_sensors(uint32_t sensors)
+{
+    if (0u == sensors)
+    {
+        sensors = BENCH_SENSORS;
+    }
+
+    sensors = ((sensors + CY_CAPSENSE_SENSOR_COUNT - 1u) / CY_CAPSENSE_SENSOR_COUNT) * CY_CAPSENSE_SENSOR_COUNT;
+    if (sensors > BENCH_SLOTS)
+    {
+        return false;
+    }
+
+    bench_pending = sensors;
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: bench_begin_frame
+********************************************************************************
+* Summary:
+*  Starts a synthetic frame, restarting the run if the host changed the number
+*  of virtual sensors.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - passes over the configured sensors in this frame
+*
+*******************************************************************************/
+uint32_t bench_begin_frame(void)
+{
+    if (bench_pending != bench_sensors)
+    {
+        bench_reset();
+    }
+
+    memset(bench_cycles, 0, sizeof(bench_cycles));
+    bench_frame++;
+
+    return (bench_sensors / CY_CAPSENSE_SENSOR_COUNT);
+}
+
+/*******************************************************************************
+* Function Name: bench_load
+********************************************************************************
+* Summary:
+*  Swaps the contexts of the virtual sensors of a pass into the configured
+*  sensors and writes their synthetic raw counts. Filter histories and
+*  debounce counters stay shared between passes, which changes some decisions
+*  but not the work done per sensor.
+*
+* Parameters:
+*  pass - pass number within the frame
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void bench_load(uint32_t pass)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    uint32_t v = pass * CY_CAPSENSE_SENSOR_COUNT;
+    uint32_t raw;
+    uint32_t wd;
+    uint32_t sns;
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+
+        for (sns = 0u; sns < wd_cfg->numSns; sns++)
+        {
+            /* Galois LFSR, x^16 + x^14 + x^13 + x^11 + 1 */
+            bench_lfsr = (bench_lfsr >> 1u) ^ ((0u - (bench_lfsr & 1u)) & 0xB400u);
+
+            raw = BENCH_RAW_BASE + ((v * 37u) % BENCH_RAW_SPREAD) + (bench_lfsr & 7u);
+            if (((bench_frame + (v * 61u)) % BENCH_TOUCH_PERIOD) < (BENCH_TOUCH_PERIOD / 4u))
+            {
+                raw += BENCH_TOUCH_COUNTS;
+            }
+
+            wd_cfg->ptrSnsContext[sns] = bench_sns[v];
+            wd_cfg->ptrSnsContext[sns].raw = (uint16_t)raw;
+            v++;
+        }
+    }
+
+    bench_start = timestamp_get_cycles();
+}
+
+/*******************************************************************************
+* Function Name: bench_store
+********************************************************************************
+* Summary:
+*  Saves the processed contexts of the virtual sensors of a pass.
+*
+* Parameters:
+*  pass - pass number within the frame
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void bench_store(uint32_t pass)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    uint32_t v = pass * CY_CAPSENSE_SENSOR_COUNT;
+    uint32_t wd;
+    uint32_t sns;
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+
+        for (sns = 0u; sns < wd_cfg->numSns; sns++)
+        {
+            bench_sns[v] = wd_cfg->ptrSnsContext[sns];
+            v++;
+        }
+    }
+
+    bench_start = timestamp_get_cycles();
+}
+
+/*******************************************************************************
+* Function Name: bench_mark
+********************************************************************************
+* Summary:
+*  Charges the cycles since the previous mark to a stage.
+*
+* Parameters:
+*  stage - BENCH_STAGE_* that just ended
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void bench_mark(uint32_t stage)
+{
+    uint32_t now = timestamp_get_cycles();
+
+    bench_cycles[stage] += now - bench_start;
+    bench_start = now;
+}
+
+/*******************************************************************************
+* Function Name: bench_end_frame
+********************************************************************************
+* Summary:
+*  Ends the host stage and the frame. Publishes the results after
+*  BENCH_FRAMES frames and starts the next run, which continues with the
+*  sensor states of the previous one.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void bench_end_frame(void)
+{
+    uint32_t frame = 0u;
+    uint32_t i;
+
+    bench_mark(BENCH_STAGE_HOST);
+
+    for (i = 0u; i < BENCH_STAGE_COUNT; i++)
+    {
+        bench_sum[i] += bench_cycles[i];
+        if (bench_cycles[i] > bench_max[i])
+        {
+            bench_max[i] = bench_cycles[i];
+        }
+        frame += bench_cycles[i];
+    }
+
+    bench_frame_sum += frame;
+    if (frame > bench_frame_max)
+    {
+        bench_frame_max = frame;
+    }
+
+    if (++bench_frames < BENCH_FRAMES)
+    {
+        return;
+    }
+
+    /* seq_end first and seq last, see host_regs_publish_frame() */
+    bench->seq_end = bench->seq + 1u;
+    __DMB();
+    bench->sensors = (uint16_t)bench_sensors;
+    bench->passes = (uint16_t)(bench_sensors / CY_CAPSENSE_SENSOR_COUNT);
+    bench->frames = (uint16_t)bench_frames;
+    for (i = 0u; i < BENCH_STAGE_COUNT; i++)
+    {
+        bench->stage_mean[i] = (uint32_t)(bench_sum[i] / bench_frames);
+        bench->stage_max[i] = bench_max[i];
+    }
+    bench->frame_mean = (uint32_t)(bench_frame_sum / bench_frames);
+    bench->frame_max = bench_frame_max;
+    bench->fps_mean = bench->clock_hz / bench->frame_mean;
+    bench->fps_min = bench->clock_hz / bench->frame_max;
+    __DMB();
+    bench->seq = bench->seq_end;
+
+    bench_clear_run();
+}
+
+#endif /* BENCH_EN */
+
+/* [] END OF FILE */
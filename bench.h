@@ -0,0 +1,127 @@
+/******************************************************************************
+* File Name: bench.h
+*
+* Description: This file contains the macros, data types and function
+*              prototypes of the synthetic-load benchmark mode.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_pdl.h"
+#include "cycfg_capsense.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Enables the benchmark mode: synthetic frames instead of scans */
+#define BENCH_EN                         (0u)
+
+/* Most virtual sensors per frame, rounded up to a multiple of the configured
+ * sensors
+ */
+#define BENCH_SENSORS                    (64u)
+
+/* Frames per measurement run */
+#define BENCH_FRAMES                     (256u)
+
+/* Stages of a frame. Filter, process and telemetry run once per pass over the
+ * configured sensors, host once per frame.
+ */
+#define BENCH_STAGE_FILTER               (0u)
+#define BENCH_STAGE_PROCESS              (1u)
+#define BENCH_STAGE_TELEMETRY            (2u)
+#define BENCH_STAGE_HOST                 (3u)
+#define BENCH_STAGE_COUNT                (4u)
+
+#if BENCH_EN
+
+/* Virtual sensor slots, whole passes over the configured sensors */
+#define BENCH_SLOTS                      (((BENCH_SENSORS + CY_CAPSENSE_SENSOR_COUNT - 1u) / \
+                                           CY_CAPSENSE_SENSOR_COUNT) * CY_CAPSENSE_SENSOR_COUNT)
+
+/* Ends a stage, compiles to nothing when the benchmark is disabled */
+#define BENCH_MARK(stage)                bench_mark(stage)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Result of the last measurement run, all times in CPU cycles per frame.
+ * Stage times include one mark of mark_cycles. The frame rates count
+ * processing only, without the scan time. seq and seq_end match when the
+ * block was read consistently.
+ */
+typedef struct
+{
+    uint32_t seq;
+    uint32_t clock_hz;
+    uint16_t sensors;
+    uint16_t passes;
+    uint16_t frames;
+    uint16_t mark_cycles;
+    uint32_t stage_mean[BENCH_STAGE_COUNT];
+    uint32_t stage_max[BENCH_STAGE_COUNT];
+    uint32_t frame_mean;
+    uint32_t frame_max;
+    uint32_t fps_mean;
+    uint32_t fps_min;
+    uint32_t seq_end;
+} bench_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void bench_init(bench_t *storage);
+bool bench_set_sensors(uint32_t sensors);
+uint32_t bench_begin_frame(void);
+void bench_load(uint32_t pass);
+void bench_store(uint32_t pass);
+void bench_mark(uint32_t stage);
+void bench_end_frame(void);
+
+#else
+#define BENCH_MARK(stage)                ((void)0)
+#endif /* BENCH_EN */
+
+#endif /* BENCH_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,153 @@
+/******************************************************************************
+* File Name: burst.c
+*
+* Description: This file contains the raw count accumulation of the burst
+*              sampling mode. The raw counts of every scan in a burst are summed
+*              per sensor in an integrator and decimated once per burst, like a
+*              first order CIC filter.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "burst.h"
+#include "scratch.h"
+
+#if BURST_SCAN_EN
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+burst_stats_t burst_stats;
+
+/* Integrator per sensor, borrowed from the scan scratch phase. 16-bit raw
+ * counts allow bursts of up to 2^16 scans.
+ */
+static uint32_t *burst_acc;
+
+/*******************************************************************************
+* Function Name: burst_begin
+********************************************************************************
+* Summary:
+*  Starts a burst with cleared integrators.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void burst_begin(void)
+{
+    scratch_begin(SCRATCH_PHASE_SCAN);
+    burst_acc = (uint32_t *)scratch_alloc(CY_CAPSENSE_SENSOR_COUNT * sizeof(uint32_t));
+}
+
+/*******************************************************************************
+* Function Name: burst_accumulate
+********************************************************************************
+* Summary:
+*  Adds the raw counts of the completed scan to the integrators.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void burst_accumulate(void)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    uint32_t sns_index = 0u;
+    uint32_t wd;
+    uint32_t sns;
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+
+        for (sns = 0u; sns < wd_cfg->numSns; sns++)
+        {
+            burst_acc[sns_index] += wd_cfg->ptrSnsContext[sns].raw;
+            sns_index++;
+        }
+    }
+
+    burst_stats.scans++;
+}
+
+/*******************************************************************************
+* Function Name: burst_decimate
+********************************************************************************
+* Summary:
+*  Replaces the raw counts with the burst average and ends the burst. The
+*  average keeps the raw count scale, so the thresholds stay valid.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void burst_decimate(void)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    uint32_t sns_index = 0u;
+    uint32_t wd;
+    uint32_t sns;
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+
+        for (sns = 0u; sns < wd_cfg->numSns; sns++)
+        {
+            wd_cfg->ptrSnsContext[sns].raw = (uint16_t)((burst_acc[sns_index] + (BURST_SIZE >> 1u)) >>
+                                                    BURST_SIZE_LOG2);
+            sns_index++;
+        }
+    }
+
+    scratch_end(SCRATCH_PHASE_SCAN);
+}
+
+#endif /* BURST_SCAN_EN */
+
+/* [] END OF FILE */
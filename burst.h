@@ -0,0 +1,104 @@
+/******************************************************************************
+* File Name: burst.h
+*
+* Description: This file contains the interface of the burst sampling mode.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef BURST_H_
+#define BURST_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include "cy_pdl.h"
+#include "cycfg_capsense.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Enables burst sampling: N short scans, on-device averaging, then sleep */
+#define BURST_SCAN_EN                    (0u)
+
+/* Scans per burst as a power of two, 2 gives bursts of 4 scans */
+#define BURST_SIZE_LOG2                  (2u)
+
+#define BURST_SIZE                       (1uL << BURST_SIZE_LOG2)
+
+/* Burst period in milliseconds */
+#define BURST_PERIOD_MS                  (20u)
+
+/* Scan scratch: one integrator per sensor */
+#if BURST_SCAN_EN
+#define BURST_SCRATCH_SIZE               (CY_CAPSENSE_SENSOR_COUNT * sizeof(uint32_t))
+#else
+#define BURST_SCRATCH_SIZE               (0u)
+#endif
+
+#if BURST_SCAN_EN
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Time spent in each part of the burst period, for energy estimation */
+typedef struct
+{
+    uint32_t periods;
+    uint32_t scans;
+    uint32_t scan_us;
+    uint32_t process_us;
+    uint32_t idle_us;
+    uint32_t overruns;
+} burst_stats_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern burst_stats_t burst_stats;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void burst_begin(void);
+void burst_accumulate(void);
+void burst_decimate(void);
+
+#endif /* BURST_SCAN_EN */
+
+#endif /* BURST_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,228 @@
+/******************************************************************************
+* File Name: common_mode.c
+*
+* Description: This file contains the common-mode noise rejection stage. Supply
+*              and ground noise shift the raw counts of all sensors together. The
+*              stage estimates that shift from the sensors that are not touched and
+*              subtracts it from every sensor before processing.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "common_mode.h"
+#include "scratch.h"
+
+#if COMMON_MODE_EN
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+common_mode_stats_t common_mode_stats;
+
+/* Deviations of the sensors that take part in the estimate, sorted. Borrowed
+ * from the processing scratch phase.
+ */
+static int32_t *cm_sorted;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static bool common_mode_estimate(uint32_t count, int32_t *estimate);
+
+/*******************************************************************************
+* Function Name: common_mode_run
+********************************************************************************
+* Summary:
+*  Estimates the common-mode shift of the scanned frame and subtracts its fast
+*  part from the raw counts of all sensors. Must be called before
+*  Cy_CapSense_ProcessAllWidgets().
+*
+*  Guards against cancelling a touch:
+*  - a sensor does not take part in the estimate while it is touched, or while
+*    its difference count of the last frame or its deviation in this frame is
+*    above the noise threshold. A touch that is developing or debouncing has
+*    crossed the noise threshold, so it cannot pull the estimate.
+*  - sensors further than COMMON_MODE_SPREAD_TH from the median deviation do
+*    not take part either
+*  - no correction is done unless COMMON_MODE_MIN_SENSORS sensors, and a
+*    majority of those taking part, agree
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void common_mode_run(void)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    cy_stc_capsense_sensor_context_t *sns_cxt;
+    uint32_t count = 0u;
+    uint32_t wd;
+    uint32_t sns;
+    uint32_t i;
+    int32_t estimate;
+    int32_t cm = 0;
+    int32_t noise_th;
+    int32_t dev;
+    int32_t raw;
+
+    scratch_begin(SCRATCH_PHASE_PROCESSING);
+    cm_sorted = (int32_t *)scratch_alloc(CY_CAPSENSE_SENSOR_COUNT * sizeof(int32_t));
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+        noise_th = (int32_t)wd_cfg->ptrWdContext->noiseTh;
+
+        for (sns = 0u; sns < wd_cfg->numSns; sns++)
+        {
+            sns_cxt = &wd_cfg->ptrSnsContext[sns];
+            dev = (int32_t)sns_cxt->raw - (int32_t)sns_cxt->bsln;
+
+            if ((0u == (sns_cxt->status & CY_CAPSENSE_SNS_TOUCH_STATUS_MASK)) &&
+                ((int32_t)sns_cxt->diff <= noise_th) && (dev <= noise_th))
+            {
+                /* Insertion sort, the sensor count is small */
+                i = count;
+                while ((i > 0u) && (cm_sorted[i - 1u] > dev))
+                {
+                    cm_sorted[i] = cm_sorted[i - 1u];
+                    i--;
+                }
+                cm_sorted[i] = dev;
+                count++;
+            }
+        }
+    }
+
+    common_mode_stats.frames++;
+    if (common_mode_estimate(count, &estimate))
+    {
+        common_mode_stats.level_q8 += ((estimate * 256) - common_mode_stats.level_q8) /
+                                      (int32_t)(1uL << COMMON_MODE_LEVEL_SHIFT);
+        cm = estimate - (common_mode_stats.level_q8 / 256);
+    }
+    common_mode_stats.last = (int16_t)cm;
+
+    if (0 != cm)
+    {
+        common_mode_stats.corrected_frames++;
+        common_mode_stats.abs_sum += (uint32_t)((cm < 0) ? -cm : cm);
+
+        for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+        {
+            wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+
+            for (sns = 0u; sns < wd_cfg->numSns; sns++)
+            {
+                sns_cxt = &wd_cfg->ptrSnsContext[sns];
+                raw = (int32_t)sns_cxt->raw - cm;
+
+                if (raw < 0)
+                {
+                    raw = 0;
+                }
+                else if (raw > (int32_t)wd_cfg->ptrWdContext->maxRawCount)
+                {
+                    raw = (int32_t)wd_cfg->ptrWdContext->maxRawCount;
+                }
+                else
+                {
+                    /* In range */
+                }
+                sns_cxt->raw = (uint16_t)raw;
+            }
+        }
+    }
+
+    scratch_end(SCRATCH_PHASE_PROCESSING);
+}
+
+/*******************************************************************************
+* Function Name: common_mode_estimate
+********************************************************************************
+* Summary:
+*  Averages the sorted deviations that lie within COMMON_MODE_SPREAD_TH of
+*  their median. The agreeing sensors must also be a majority of the sorted
+*  ones.
+*
+* Parameters:
+*  count - number of sorted deviations
+*  estimate - receives the common-mode shift in raw counts
+*
+* Return:
+*  bool - true if enough sensors agree for an estimate
+*
+*******************************************************************************/
+static bool common_mode_estimate(uint32_t count, int32_t *estimate)
+{
+    int32_t median;
+    int32_t sum = 0;
+    uint32_t agree = 0u;
+    uint32_t i;
+    bool valid = false;
+
+    if (count >= COMMON_MODE_MIN_SENSORS)
+    {
+        median = ((cm_sorted[(count - 1u) / 2u] + cm_sorted[count / 2u]) / 2);
+
+        for (i = 0u; i < count; i++)
+        {
+            if (((cm_sorted[i] - median) <= COMMON_MODE_SPREAD_TH) &&
+                ((median - cm_sorted[i]) <= COMMON_MODE_SPREAD_TH))
+            {
+                sum += cm_sorted[i];
+                agree++;
+            }
+        }
+
+        if ((agree >= COMMON_MODE_MIN_SENSORS) && ((2u * agree) > count))
+        {
+            *estimate = sum / (int32_t)agree;
+            valid = true;
+        }
+    }
+
+    return valid;
+}
+
+#endif /* COMMON_MODE_EN */
+
+/* [] END OF FILE */
@@ -0,0 +1,119 @@
+/******************************************************************************
+* File Name: common_mode.h
+*
+* Description: This file contains the interface of the common-mode noise rejection
+*              stage.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef COMMON_MODE_H_
+#define COMMON_MODE_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "cy_pdl.h"
+#include "cycfg_capsense.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Enables the common-mode noise rejection stage */
+#define COMMON_MODE_EN                   (0u)
+
+/* Minimum number of agreeing sensors for an estimate */
+#define COMMON_MODE_MIN_SENSORS          (2u)
+
+/* Maximum distance of a sensor deviation from the median deviation for the
+ * sensor to take part in the estimate, in raw counts. A touch moves a sensor
+ * away from the others, so it is excluded from the estimate.
+ */
+#define COMMON_MODE_SPREAD_TH            (20)
+
+/* The slow part of the estimate is tracked with a weight of
+ * 1 / 2^COMMON_MODE_LEVEL_SHIFT per frame and left in the raw counts, so the
+ * baselines follow a drift common to all sensors. Only the faster part is
+ * subtracted.
+ */
+#define COMMON_MODE_LEVEL_SHIFT          (4u)
+
+/* Processing scratch: the sorted deviations */
+#if COMMON_MODE_EN
+#define COMMON_MODE_SCRATCH_SIZE         (CY_CAPSENSE_SENSOR_COUNT * sizeof(int32_t))
+#else
+#define COMMON_MODE_SCRATCH_SIZE         (0u)
+#endif
+
+#if COMMON_MODE_EN
+
+#if COMMON_MODE_MIN_SENSORS < 2u
+#error "COMMON_MODE_MIN_SENSORS must be at least 2"
+#endif
+
+#if CY_CAPSENSE_SENSOR_COUNT < COMMON_MODE_MIN_SENSORS
+#error "COMMON_MODE_EN needs at least COMMON_MODE_MIN_SENSORS sensors"
+#endif
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Rejection statistics */
+typedef struct
+{
+    uint32_t frames;
+    uint32_t corrected_frames;
+    uint32_t abs_sum;
+    int32_t level_q8;
+    int16_t last;
+} common_mode_stats_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern common_mode_stats_t common_mode_stats;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void common_mode_run(void);
+
+#endif /* COMMON_MODE_EN */
+
+#endif /* COMMON_MODE_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,305 @@
+/******************************************************************************
+* File Name: cp_estimate.c
+*
+* Description: This file contains the sensor Cp estimation from the IDAC
+*              codes and baselines of the calibration, and the scheduling of
+*              BIST measurements from it.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cp_estimate.h"
+
+#if CP_ESTIMATE_EN
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+/* Estimation state, read with the debugger */
+cp_estimate_t cp_estimate;
+
+/*******************************************************************************
+* Function Name: estimate_sensor
+********************************************************************************
+* Summary:
+*  Estimates the Cp of a sensor from the charge balance of the conversion.
+*  The IDACs supply on average (raw / max raw) * Imod + Icomp, and the sensor
+*  takes Cp * Vref every sense clock period, so
+*  Cp = (raw / max raw * Imod + Icomp) / (Vref * Fsw). The baseline stands
+*  in for the raw count so touches and noise do not move the estimate.
+*
+* Parameters:
+*  wd_cfg - widget of the sensor
+*  sns - sensor index in the widget
+*
+* Return:
+*  uint32_t - estimated Cp in fF, 0 when the configuration gives none
+*
+*******************************************************************************/
+static uint32_t estimate_sensor(const cy_stc_capsense_widget_config_t *wd_cfg, uint32_t sns)
+{
+    const cy_stc_capsense_common_config_t *common = cy_capsense_context.ptrCommonConfig;
+    const cy_stc_capsense_widget_context_t *wd_ctx = wd_cfg->ptrWdContext;
+    uint64_t current_pa;
+    uint64_t divisor;
+    uint32_t gain_pa;
+
+    if (0u == wd_ctx->maxRawCount)
+    {
+        return 0u;
+    }
+
+    gain_pa = common->idacGainTable[wd_ctx->idacGainIndex].gainValue;
+    current_pa = ((uint64_t)wd_ctx->idacMod[CY_CAPSENSE_MFS_CH0_INDEX] * gain_pa *
+                  wd_cfg->ptrSnsContext[sns].bsln) / wd_ctx->maxRawCount;
+    current_pa += (uint64_t)wd_cfg->ptrSnsContext[sns].idacComp * gain_pa;
+
+    /* Fsw = CLK_CSD / (modulator divider * sense divider), Cp in fF is
+     * current in pA * 1e6 / (Vref in mV * Fsw)
+     */
+    divisor = (uint64_t)common->csdVref * (common->periClkHz / 1000000u);
+    if (0u == divisor)
+    {
+        return 0u;
+    }
+
+    return (uint32_t)((current_pa * cy_capsense_context.ptrCommonContext->modCsdClk *
+                       wd_ctx->snsClk) / divisor);
+}
+
+/*******************************************************************************
+* Function Name: check_sensor
+********************************************************************************
+* Summary:
+*  Updates the estimate of a sensor and returns why it needs a BIST, if it
+*  does.
+*
+* Parameters:
+*  wd_cfg - widget of the sensor
+*  sns - sensor index in the widget
+*  index - flat sensor index
+*
+* Return:
+*  uint32_t - a CP_ESTIMATE_DUE_* reason
+*
+*******************************************************************************/
+static uint32_t check_sensor(const cy_stc_capsense_widget_config_t *wd_cfg, uint32_t sns,
+                             uint32_t index)
+{
+    const cy_stc_capsense_widget_context_t *wd_ctx = wd_cfg->ptrWdContext;
+    uint32_t estimate = estimate_sensor(wd_cfg, sns);
+    uint32_t reference = cp_estimate.bist_estimate_ff[index];
+    uint32_t scaled = estimate;
+    uint32_t delta;
+
+    if ((0u != reference) && cp_estimate.bist_ok[index])
+    {
+        scaled = (uint32_t)(((uint64_t)estimate * cp_estimate.bist_ff[index]) / reference);
+    }
+    cp_estimate.estimate_ff[index] = estimate;
+    cp_estimate.scaled_ff[index] = scaled;
+
+    if (!cp_estimate.bist_ok[index])
+    {
+        return CP_ESTIMATE_DUE_FAILED;
+    }
+
+    if ((cp_estimate.bist_idac_mod[index] != wd_ctx->idacMod[CY_CAPSENSE_MFS_CH0_INDEX]) ||
+        (cp_estimate.bist_idac_comp[index] != wd_cfg->ptrSnsContext[sns].idacComp) ||
+        (cp_estimate.bist_gain_index[index] != wd_ctx->idacGainIndex))
+    {
+        return CP_ESTIMATE_DUE_RECALIBRATED;
+    }
+
+    if (((uint32_t)wd_cfg->ptrSnsContext[sns].bsln * 100u) >=
+        ((uint32_t)wd_ctx->maxRawCount * CP_ESTIMATE_SATURATION_PERCENT))
+    {
+        return CP_ESTIMATE_DUE_SATURATED;
+    }
+
+    delta = (estimate > reference) ? (estimate - reference) : (reference - estimate);
+    if (((uint64_t)delta * 100u) > ((uint64_t)reference * CP_ESTIMATE_MOVE_PERCENT))
+    {
+        return CP_ESTIMATE_DUE_MOVED;
+    }
+
+    if ((scaled < CP_ESTIMATE_GUARD_LOW_FF) || (scaled > CP_ESTIMATE_GUARD_HIGH_FF))
+    {
+        return CP_ESTIMATE_DUE_GUARD;
+    }
+
+    return CP_ESTIMATE_DUE_NONE;
+}
+
+/*******************************************************************************
+* Function Name: cp_estimate_bist_due
+********************************************************************************
+* Summary:
+*  Updates the estimates of all sensors and decides whether BIST runs now.
+*  The first check always runs it. After that, BIST runs at most every
+*  CP_ESTIMATE_MIN_INTERVAL checks, when a BIST failed, the IDAC codes
+*  changed, a baseline nears saturation, an estimate moved by more than
+*  CP_ESTIMATE_MOVE_PERCENT, or a scaled estimate is outside the guard bounds.
+*  Call it once per frame before the BIST measurements and call
+*  cp_estimate_bist_done() with each result when it returns true.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  bool - true when BIST is to run now
+*
+*******************************************************************************/
+bool cp_estimate_bist_due(void)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    uint32_t reason = CP_ESTIMATE_DUE_NONE;
+    uint32_t sensor = 0u;
+    uint32_t sns_index = 0u;
+    uint32_t wd;
+    uint32_t sns;
+    uint32_t due;
+
+    cp_estimate.checks++;
+    cp_estimate.since_bist++;
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+
+        for (sns = 0u; sns < wd_cfg->numSns; sns++)
+        {
+            /* Keep the first reason but update every estimate */
+            due = check_sensor(wd_cfg, sns, sns_index);
+            if ((CP_ESTIMATE_DUE_NONE == reason) && (CP_ESTIMATE_DUE_NONE != due))
+            {
+                reason = due;
+                sensor = sns_index;
+            }
+            sns_index++;
+        }
+    }
+
+    if (0u == cp_estimate.bist_runs)
+    {
+        reason = CP_ESTIMATE_DUE_FIRST;
+        sensor = 0u;
+    }
+    else if (cp_estimate.since_bist < CP_ESTIMATE_MIN_INTERVAL)
+    {
+        return false;
+    }
+#if CP_ESTIMATE_MAX_INTERVAL
+    else if ((CP_ESTIMATE_DUE_NONE == reason) &&
+             (cp_estimate.since_bist >= CP_ESTIMATE_MAX_INTERVAL))
+    {
+        reason = CP_ESTIMATE_DUE_INTERVAL;
+    }
+#endif
+    else
+    {
+        /* Due only for a sensor reason */
+    }
+
+    if (CP_ESTIMATE_DUE_NONE == reason)
+    {
+        return false;
+    }
+
+    cp_estimate.reason = (uint8_t)reason;
+    cp_estimate.sensor = (uint8_t)sensor;
+    cp_estimate.bist_runs++;
+    cp_estimate.since_bist = 0u;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: cp_estimate_bist_done
+********************************************************************************
+* Summary:
+*  Takes the BIST result of a sensor as the new reference: the measured Cp,
+*  the estimate and the IDAC codes at that time. A failed measurement keeps
+*  the sensor due.
+*
+* Parameters:
+*  widget - widget ID, as passed to Cy_CapSense_MeasureCapacitanceSensor()
+*  sensor - sensor ID in the widget
+*  cp_ff - measured Cp in fF
+*  ok - the measurement succeeded
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void cp_estimate_bist_done(uint32_t widget, uint32_t sensor, uint32_t cp_ff, bool ok)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    uint32_t index = sensor;
+    uint32_t wd;
+
+    if ((widget >= CY_CAPSENSE_WIDGET_COUNT) ||
+        (sensor >= cy_capsense_context.ptrWdConfig[widget].numSns))
+    {
+        return;
+    }
+
+    for (wd = 0u; wd < widget; wd++)
+    {
+        index += cy_capsense_context.ptrWdConfig[wd].numSns;
+    }
+
+    wd_cfg = &cy_capsense_context.ptrWdConfig[widget];
+    cp_estimate.bist_ok[index] = ok;
+    if (!ok)
+    {
+        return;
+    }
+
+    cp_estimate.bist_ff[index] = cp_ff;
+    cp_estimate.bist_estimate_ff[index] = estimate_sensor(wd_cfg, sensor);
+    cp_estimate.bist_idac_mod[index] = wd_cfg->ptrWdContext->idacMod[CY_CAPSENSE_MFS_CH0_INDEX];
+    cp_estimate.bist_idac_comp[index] = wd_cfg->ptrSnsContext[sensor].idacComp;
+    cp_estimate.bist_gain_index[index] = wd_cfg->ptrWdContext->idacGainIndex;
+    cp_estimate.estimate_ff[index] = cp_estimate.bist_estimate_ff[index];
+    cp_estimate.scaled_ff[index] = cp_ff;
+}
+
+#endif /* CP_ESTIMATE_EN */
+
+/* [] END OF FILE */
@@ -0,0 +1,144 @@
+/******************************************************************************
+* File Name: cp_estimate.h
+*
+* Description: This file contains the macros, data types and function
+*              prototypes of the sensor Cp estimation from the calibration
+*              state.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef CP_ESTIMATE_H_
+#define CP_ESTIMATE_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_pdl.h"
+#include "cycfg_capsense.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Estimates the sensor Cp from the IDAC codes and baselines, and runs BIST
+ * only when the estimate calls for it
+ */
+#define CP_ESTIMATE_EN                   (0u)
+
+/* BIST is repeated when an estimate moves by more than this percentage from
+ * its value at the last BIST
+ */
+#define CP_ESTIMATE_MOVE_PERCENT         (5u)
+
+/* BIST is repeated while a scaled estimate is outside these bounds, in fF.
+ * Set them to the Cp limits of the design with a margin.
+ */
+#define CP_ESTIMATE_GUARD_LOW_FF         (6000u)
+#define CP_ESTIMATE_GUARD_HIGH_FF        (40000u)
+
+/* Baselines above this percentage of the maximum raw count no longer follow
+ * Cp, so BIST is repeated
+ */
+#define CP_ESTIMATE_SATURATION_PERCENT   (95u)
+
+/* Least checks between two BIST runs, so a sensor that stays outside the
+ * bounds does not take BIST every frame
+ */
+#define CP_ESTIMATE_MIN_INTERVAL         (64u)
+
+/* Most checks between two BIST runs, 0 for no limit */
+#define CP_ESTIMATE_MAX_INTERVAL         (0u)
+
+/* Reasons for a BIST run */
+#define CP_ESTIMATE_DUE_NONE             (0u)
+#define CP_ESTIMATE_DUE_FIRST            (1u) /* no BIST since reset */
+#define CP_ESTIMATE_DUE_FAILED           (2u) /* the last BIST failed */
+#define CP_ESTIMATE_DUE_RECALIBRATED     (3u) /* IDAC codes changed */
+#define CP_ESTIMATE_DUE_SATURATED        (4u) /* baseline near the maximum */
+#define CP_ESTIMATE_DUE_MOVED            (5u) /* estimate moved */
+#define CP_ESTIMATE_DUE_GUARD            (6u) /* estimate outside the bounds */
+#define CP_ESTIMATE_DUE_INTERVAL         (7u) /* CP_ESTIMATE_MAX_INTERVAL */
+
+#if CP_ESTIMATE_EN
+
+#if !CY_CAPSENSE_BIST_EN
+#error "CP_ESTIMATE_EN schedules BIST and requires the self-test library"
+#endif
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Estimation state of the board, for the debugger. estimate_ff is the
+ * estimate with the nominal IDAC gain and Vref. scaled_ff is the estimate
+ * scaled by the ratio of BIST to estimate at the last BIST of the sensor,
+ * which takes out the gain and Vref errors of the board. The IDAC codes are
+ * those of the last BIST. reason is the reason of the last BIST run and
+ * sensor the flat index of the sensor that caused it.
+ */
+typedef struct
+{
+    uint32_t estimate_ff[CY_CAPSENSE_SENSOR_COUNT];
+    uint32_t scaled_ff[CY_CAPSENSE_SENSOR_COUNT];
+    uint32_t bist_ff[CY_CAPSENSE_SENSOR_COUNT];
+    uint32_t bist_estimate_ff[CY_CAPSENSE_SENSOR_COUNT];
+    uint8_t bist_idac_mod[CY_CAPSENSE_SENSOR_COUNT];
+    uint8_t bist_idac_comp[CY_CAPSENSE_SENSOR_COUNT];
+    uint8_t bist_gain_index[CY_CAPSENSE_SENSOR_COUNT];
+    bool bist_ok[CY_CAPSENSE_SENSOR_COUNT];
+    uint8_t reason;
+    uint8_t sensor;
+    uint32_t checks;
+    uint32_t bist_runs;
+    uint32_t since_bist;
+} cp_estimate_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern cp_estimate_t cp_estimate;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool cp_estimate_bist_due(void);
+void cp_estimate_bist_done(uint32_t widget, uint32_t sensor, uint32_t cp_ff, bool ok);
+
+#endif /* CP_ESTIMATE_EN */
+
+#endif /* CP_ESTIMATE_H_ */
+
+/* [] END OF FILE */
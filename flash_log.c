@@ -0,0 +1,481 @@
+/******************************************************************************
+* File Name: flash_log.c
+*
+* Description: This file contains the log-structured flash event log. Records
+*              are batched in RAM and written a whole row at a time in the idle
+*              slack between frames, rotating over the reserved rows.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <string.h>
+#include "flash_log.h"
+#include "timestamp.h"
+
+#if FLASH_LOG_EN
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define FLASH_LOG_NO_BUFFER              (0xFFu)
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+flash_log_stats_t flash_log_stats;
+
+/* Flash rows holding the log */
+CY_ALIGN(CY_FLASH_SIZEOF_ROW)
+static const uint8_t log_flash[FLASH_LOG_ROWS * CY_FLASH_SIZEOF_ROW] = {0u};
+
+/* Log rows in flash. Volatile so that reads of the zero-initialized flash
+ * array are not folded.
+ */
+static const flash_log_row_t * volatile log_rows;
+
+/* RAM rows: one is filled while the other waits for the flash write */
+static flash_log_row_t log_buf[2];
+static uint8_t fill_buf = 0u;
+static uint8_t pending_buf = FLASH_LOG_NO_BUFFER;
+static uint32_t fill_start_ms;
+static uint32_t last_write_ms;
+static uint32_t next_seq;
+static uint32_t dropped_unlogged = 0u;
+
+/* Touch counting between touch records */
+static uint16_t touch_count[CY_CAPSENSE_SENSOR_COUNT];
+static uint8_t touch_active[CY_CAPSENSE_SENSOR_COUNT];
+static bool touch_any = false;
+static uint32_t touch_period_start_ms;
+
+/* Last logged BIST status of each sensor */
+static uint32_t bist_status[CY_CAPSENSE_SENSOR_COUNT];
+
+/*******************************************************************************
+* Function Name: flash_log_checksum
+********************************************************************************
+* Summary:
+*  Returns the inverted byte sum of a row without its check byte. A row that
+*  was interrupted by a reset during the write fails the check.
+*
+* Parameters:
+*  row - log row
+*
+* Return:
+*  uint8_t - check value
+*
+*******************************************************************************/
+static uint8_t flash_log_checksum(const flash_log_row_t *row)
+{
+    const uint8_t *bytes = (const uint8_t *)row;
+    uint8_t sum = 0u;
+    uint32_t i;
+
+    for (i = 0u; i < sizeof(flash_log_row_t); i++)
+    {
+        sum += bytes[i];
+    }
+
+    return (uint8_t)~(uint8_t)(sum - row->header.check);
+}
+
+/*******************************************************************************
+* Function Name: flash_log_row_valid
+********************************************************************************
+* Summary:
+*  Checks the header and the checksum of a row.
+*
+* Parameters:
+*  row - log row
+*
+* Return:
+*  bool - true if the row holds records
+*
+*******************************************************************************/
+static bool flash_log_row_valid(const flash_log_row_t *row)
+{
+    return ((FLASH_LOG_MAGIC == row->header.magic) && (0u != row->header.count) &&
+            (row->header.count <= FLASH_LOG_RECORDS_PER_ROW) &&
+            (flash_log_checksum(row) == row->header.check));
+}
+
+/*******************************************************************************
+* Function Name: flash_log_swap
+********************************************************************************
+* Summary:
+*  Hands the filled RAM row to the writer and starts filling the other one.
+*  Called with interrupts disabled and no row pending.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void flash_log_swap(void)
+{
+    pending_buf = fill_buf;
+    fill_buf ^= 1u;
+    log_buf[fill_buf].header.count = 0u;
+}
+
+/*******************************************************************************
+* Function Name: flash_log_init
+********************************************************************************
+* Summary:
+*  Recovers the write position by scanning the row headers: the row after the
+*  one with the highest sequence number is the next to write. Logs a boot
+*  record.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void flash_log_init(void)
+{
+    uint32_t start = timestamp_get_cycles();
+    uint32_t newest_seq = 0u;
+    uint32_t row;
+    bool found = false;
+
+    log_rows = (const flash_log_row_t *)log_flash;
+
+    memset(&flash_log_stats, 0, sizeof(flash_log_stats));
+
+    for (row = 0u; row < FLASH_LOG_ROWS; row++)
+    {
+        if (flash_log_row_valid(&log_rows[row]))
+        {
+            flash_log_stats.valid_rows++;
+
+            if ((!found) || ((int32_t)(log_rows[row].header.seq - newest_seq) > 0))
+            {
+                newest_seq = log_rows[row].header.seq;
+                flash_log_stats.next_row = (uint16_t)((row + 1u) % FLASH_LOG_ROWS);
+                found = true;
+            }
+        }
+    }
+
+    next_seq = newest_seq + 1u;
+    flash_log_stats.recover_cycles = timestamp_get_cycles() - start;
+
+    memset(log_buf, 0, sizeof(log_buf));
+    memset(touch_count, 0, sizeof(touch_count));
+    memset(touch_active, 0, sizeof(touch_active));
+    memset(bist_status, 0, sizeof(bist_status));
+    fill_buf = 0u;
+    pending_buf = FLASH_LOG_NO_BUFFER;
+    touch_any = false;
+    last_write_ms = timestamp_ms;
+    touch_period_start_ms = timestamp_ms;
+
+    flash_log_add(FLASH_LOG_BOOT, 0u, flash_log_stats.valid_rows);
+}
+
+/*******************************************************************************
+* Function Name: flash_log_add
+********************************************************************************
+* Summary:
+*  Appends a record to the RAM row. When both RAM rows are full the record is
+*  dropped and counted.
+*
+* Parameters:
+*  type - FLASH_LOG_* record type
+*  arg - record argument
+*  value - record value
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void flash_log_add(uint8_t type, uint8_t arg, uint16_t value)
+{
+    flash_log_row_t *buf;
+    flash_log_record_t *rec;
+    uint32_t intr_state;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+
+    buf = &log_buf[fill_buf];
+    if (buf->header.count >= FLASH_LOG_RECORDS_PER_ROW)
+    {
+        flash_log_stats.dropped++;
+        dropped_unlogged++;
+    }
+    else
+    {
+        rec = &buf->record[buf->header.count];
+        rec->type = type;
+        rec->arg = arg;
+        rec->value = value;
+        rec->time_s = timestamp_ms / 1000u;
+
+        if (0u == buf->header.count)
+        {
+            fill_start_ms = timestamp_ms;
+        }
+        buf->header.count++;
+
+        if ((FLASH_LOG_RECORDS_PER_ROW == buf->header.count) && (FLASH_LOG_NO_BUFFER == pending_buf))
+        {
+            flash_log_swap();
+        }
+    }
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+}
+
+/*******************************************************************************
+* Function Name: flash_log_bist_status
+********************************************************************************
+* Summary:
+*  Logs the BIST status of a sensor when it changes.
+*
+* Parameters:
+*  sensor - sensor index
+*  status - result of the BIST measurement
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void flash_log_bist_status(uint8_t sensor, uint32_t status)
+{
+    if (status != bist_status[sensor])
+    {
+        bist_status[sensor] = status;
+        flash_log_add(FLASH_LOG_BIST, sensor, (uint16_t)status);
+    }
+}
+
+/*******************************************************************************
+* Function Name: flash_log_update
+********************************************************************************
+* Summary:
+*  Counts the touches of the processed frame and logs the counts every
+*  FLASH_LOG_TOUCH_PERIOD_MS.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void flash_log_update(void)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    uint32_t sns_index = 0u;
+    uint8_t touched;
+    bool any = false;
+    uint32_t wd;
+    uint32_t sns;
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+
+        for (sns = 0u; sns < wd_cfg->numSns; sns++)
+        {
+            touched = (0u != (wd_cfg->ptrSnsContext[sns].status & CY_CAPSENSE_SNS_TOUCH_STATUS_MASK)) ? 1u : 0u;
+            if ((0u != touched) && (0u == touch_active[sns_index]) && (UINT16_MAX != touch_count[sns_index]))
+            {
+                touch_count[sns_index]++;
+            }
+            touch_active[sns_index] = touched;
+            any = any || (0u != touched);
+            sns_index++;
+        }
+    }
+    touch_any = any;
+
+    if ((timestamp_ms - touch_period_start_ms) >= FLASH_LOG_TOUCH_PERIOD_MS)
+    {
+        touch_period_start_ms += FLASH_LOG_TOUCH_PERIOD_MS;
+
+        for (sns_index = 0u; sns_index < CY_CAPSENSE_SENSOR_COUNT; sns_index++)
+        {
+            flash_log_add(FLASH_LOG_TOUCH, (uint8_t)sns_index, touch_count[sns_index]);
+            touch_count[sns_index] = 0u;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: flash_log_service
+********************************************************************************
+* Summary:
+*  Writes the pending RAM row to the next flash row. Call between frames,
+*  while no scan is in progress. The write blocks the CPU and all interrupts
+*  for one row write time, so it is done only in idle slack: no sensor
+*  touched and at least FLASH_LOG_MIN_WRITE_MS since the previous write. A
+*  partly filled row is written after FLASH_LOG_FLUSH_MS. The longest write
+*  is kept in flash_log_stats.write_max_cycles.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void flash_log_service(void)
+{
+    cy_en_flashdrv_status_t status;
+    flash_log_row_t *buf;
+    uint32_t intr_state;
+    uint32_t dropped;
+    uint32_t stall;
+
+    if (touch_any || ((timestamp_ms - last_write_ms) < FLASH_LOG_MIN_WRITE_MS))
+    {
+        return;
+    }
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+    if ((FLASH_LOG_NO_BUFFER == pending_buf) && (0u != log_buf[fill_buf].header.count) &&
+        ((timestamp_ms - fill_start_ms) >= FLASH_LOG_FLUSH_MS))
+    {
+        flash_log_swap();
+    }
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    if (FLASH_LOG_NO_BUFFER == pending_buf)
+    {
+        return;
+    }
+
+    buf = &log_buf[pending_buf];
+    buf->header.magic = FLASH_LOG_MAGIC;
+    buf->header.seq = next_seq;
+    buf->header.check = flash_log_checksum(buf);
+
+    /* The write blocks all interrupts, SysTick measures it without losing ticks */
+    intr_state = Cy_SysLib_EnterCriticalSection();
+    timestamp_stall_begin();
+    status = Cy_Flash_WriteRow((uint32_t)&log_flash[flash_log_stats.next_row * CY_FLASH_SIZEOF_ROW],
+                               (const uint32_t *)buf);
+    stall = timestamp_stall_end();
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    if (stall > flash_log_stats.write_max_cycles)
+    {
+        flash_log_stats.write_max_cycles = stall;
+    }
+
+    if (CY_FLASH_DRV_SUCCESS == status)
+    {
+        next_seq++;
+        flash_log_stats.next_row = (uint16_t)((flash_log_stats.next_row + 1u) % FLASH_LOG_ROWS);
+        flash_log_stats.rows_written++;
+        if (flash_log_stats.valid_rows < FLASH_LOG_ROWS)
+        {
+            flash_log_stats.valid_rows++;
+        }
+
+        intr_state = Cy_SysLib_EnterCriticalSection();
+        pending_buf = FLASH_LOG_NO_BUFFER;
+        if (FLASH_LOG_RECORDS_PER_ROW == log_buf[fill_buf].header.count)
+        {
+            flash_log_swap();
+        }
+        dropped = dropped_unlogged;
+        dropped_unlogged = 0u;
+        Cy_SysLib_ExitCriticalSection(intr_state);
+
+        if (0u != dropped)
+        {
+            flash_log_add(FLASH_LOG_DROPPED, 0u, (uint16_t)((dropped > UINT16_MAX) ? UINT16_MAX : dropped));
+        }
+    }
+    else
+    {
+        /* Retried after FLASH_LOG_MIN_WRITE_MS */
+        flash_log_stats.write_errors++;
+    }
+
+    last_write_ms = timestamp_ms;
+}
+
+/*******************************************************************************
+* Function Name: flash_log_read
+********************************************************************************
+* Summary:
+*  Reads a record from flash, oldest first. Records still in RAM are not
+*  included.
+*
+* Parameters:
+*  index - record index
+*  record - returns the record
+*
+* Return:
+*  bool - false if index is past the newest record
+*
+*******************************************************************************/
+bool flash_log_read(uint32_t index, flash_log_record_t *record)
+{
+    const flash_log_row_t *row;
+    uint32_t i;
+
+    /* Rows are written in order, so the oldest one follows the write position */
+    for (i = 0u; i < FLASH_LOG_ROWS; i++)
+    {
+        row = &log_rows[(flash_log_stats.next_row + i) % FLASH_LOG_ROWS];
+
+        if (flash_log_row_valid(row))
+        {
+            if (index < row->header.count)
+            {
+                *record = row->record[index];
+                return true;
+            }
+            index -= row->header.count;
+        }
+    }
+
+    return false;
+}
+
+#endif /* FLASH_LOG_EN */
+
+/* [] END OF FILE */
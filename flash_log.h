@@ -0,0 +1,149 @@
+/******************************************************************************
+* File Name: flash_log.h
+*
+* Description: This file contains the log-structured flash event log.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef FLASH_LOG_H_
+#define FLASH_LOG_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_pdl.h"
+#include "cycfg_capsense.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Enables the persistent event log */
+#define FLASH_LOG_EN                     (0u)
+
+/* Flash rows reserved for the log, used in rotation */
+#define FLASH_LOG_ROWS                   (16u)
+
+/* Minimum time between two row writes */
+#define FLASH_LOG_MIN_WRITE_MS           (1000u)
+
+/* A partly filled row is written after this time */
+#define FLASH_LOG_FLUSH_MS               (600000u)
+
+/* Period of the touch count records */
+#define FLASH_LOG_TOUCH_PERIOD_MS        (3600000u)
+
+/* Row header marker, "LG" */
+#define FLASH_LOG_MAGIC                  (0x474Cu)
+
+/* Record types */
+#define FLASH_LOG_BOOT                   (0x01u) /* value: rows found at boot */
+#define FLASH_LOG_TOUCH                  (0x02u) /* arg: sensor, value: touches in the period */
+#define FLASH_LOG_BIST                   (0x03u) /* arg: sensor, value: new BIST status */
+#define FLASH_LOG_PROFILE                (0x04u) /* arg: profile */
+#define FLASH_LOG_DROPPED                (0x05u) /* value: records lost while both buffers were full */
+
+#if FLASH_LOG_EN
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Log record. time_s counts from the last reset. */
+typedef struct
+{
+    uint8_t type;
+    uint8_t arg;
+    uint16_t value;
+    uint32_t time_s;
+} flash_log_record_t;
+
+/* Row header. seq increases with every row written and orders the rows. */
+typedef struct
+{
+    uint16_t magic;
+    uint8_t count;
+    uint8_t check;
+    uint32_t seq;
+} flash_log_header_t;
+
+#define FLASH_LOG_RECORDS_PER_ROW        ((CY_FLASH_SIZEOF_ROW - sizeof(flash_log_header_t)) / \
+                                          sizeof(flash_log_record_t))
+
+/* One flash row */
+typedef struct
+{
+    flash_log_header_t header;
+    flash_log_record_t record[FLASH_LOG_RECORDS_PER_ROW];
+} flash_log_row_t;
+
+/* Cy_Flash_WriteRow() reads a full row from the buffer */
+_Static_assert(sizeof(flash_log_row_t) == CY_FLASH_SIZEOF_ROW, "flash_log_row_t must fill one flash row");
+
+/* Log statistics. recover_cycles is the boot recovery time, write_max_cycles
+ * the longest loop stall of a row write.
+ */
+typedef struct
+{
+    uint32_t recover_cycles;
+    uint32_t write_max_cycles;
+    uint32_t rows_written;
+    uint32_t write_errors;
+    uint32_t dropped;
+    uint16_t valid_rows;
+    uint16_t next_row;
+} flash_log_stats_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern flash_log_stats_t flash_log_stats;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void flash_log_init(void);
+void flash_log_add(uint8_t type, uint8_t arg, uint16_t value);
+void flash_log_bist_status(uint8_t sensor, uint32_t status);
+void flash_log_update(void);
+void flash_log_service(void);
+bool flash_log_read(uint32_t index, flash_log_record_t *record);
+
+#endif /* FLASH_LOG_EN */
+
+#endif /* FLASH_LOG_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,150 @@
+/******************************************************************************
+* File Name: glitch_filter.c
+*
+* Description: This file contains the raw count glitch rejection stage.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "glitch_filter.h"
+
+#if GLITCH_FILTER_EN
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Per-sensor state. The mean is 32 bits wide, with 4 fractional bits it does
+ * not fit 16 bits at resolutions above 12 bits.
+ */
+typedef struct
+{
+    uint32_t mean_q4;
+    uint16_t prev;
+    uint8_t held;
+    uint8_t primed;
+} glitch_state_t;
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+glitch_filter_stats_t glitch_filter_stats;
+
+static glitch_state_t glitch_state[CY_CAPSENSE_SENSOR_COUNT];
+
+/*******************************************************************************
+* Function Name: glitch_filter_run
+********************************************************************************
+* Summary:
+*  Replaces isolated raw count outliers with the previous sample. A sample is
+*  an outlier when it differs from the previous accepted sample by more than
+*  GLITCH_BOUND_MULT times the rolling mean absolute change. An outlier is
+*  held back for one frame only: if the next sample is still far off, the
+*  change is real and passes. A touch builds up over many frames, so it is
+*  not delayed.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void glitch_filter_run(void)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    cy_stc_capsense_sensor_context_t *sns_ctx;
+    glitch_state_t *state;
+    uint32_t sns_index = 0u;
+    uint32_t bound;
+    uint32_t delta;
+    uint32_t raw;
+    uint32_t wd;
+    uint32_t sns;
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+
+        for (sns = 0u; sns < wd_cfg->numSns; sns++)
+        {
+            sns_ctx = &wd_cfg->ptrSnsContext[sns];
+            state = &glitch_state[sns_index];
+            raw = sns_ctx->raw;
+            sns_index++;
+
+            if (0u == state->primed)
+            {
+                state->prev = (uint16_t)raw;
+                state->primed = 1u;
+                continue;
+            }
+
+            delta = (raw > state->prev) ? (raw - state->prev) : (state->prev - raw);
+            bound = (state->mean_q4 * GLITCH_BOUND_MULT) >> 4u;
+            if (bound < GLITCH_MIN_BOUND)
+            {
+                bound = GLITCH_MIN_BOUND;
+            }
+
+            if (delta > bound)
+            {
+                if (0u == state->held)
+                {
+                    sns_ctx->raw = state->prev;
+                    state->held = 1u;
+                    glitch_filter_stats.rejected++;
+                    continue;
+                }
+
+                /* Confirmed by a second sample, the filter learns the step at its bound */
+                glitch_filter_stats.steps++;
+                delta = bound;
+            }
+
+            state->held = 0u;
+            state->prev = (uint16_t)raw;
+            state->mean_q4 = (uint32_t)((int32_t)state->mean_q4 +
+                                        (((int32_t)(delta << 4u) - (int32_t)state->mean_q4) >>
+                                         GLITCH_MEAN_SHIFT));
+        }
+    }
+}
+
+#endif /* GLITCH_FILTER_EN */
+
+/* [] END OF FILE */
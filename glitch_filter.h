@@ -0,0 +1,98 @@
+/******************************************************************************
+* File Name: glitch_filter.h
+*
+* Description: This file contains the raw count glitch rejection stage.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef GLITCH_FILTER_H_
+#define GLITCH_FILTER_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include "cy_pdl.h"
+#include "cycfg_capsense.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Enables the raw count glitch rejection stage */
+#define GLITCH_FILTER_EN                 (0u)
+
+/* A change from the previous sample above this many times the mean absolute
+ * change is an outlier
+ */
+#define GLITCH_BOUND_MULT                (8u)
+
+/* Lower limit of the bound in raw counts, so that a very quiet sensor does
+ * not reject normal noise
+ */
+#define GLITCH_MIN_BOUND                 (40u)
+
+/* Mean absolute change filter, 1 / 2^GLITCH_MEAN_SHIFT per frame */
+#define GLITCH_MEAN_SHIFT                (4u)
+
+#if GLITCH_FILTER_EN
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Rejection statistics. steps counts outliers confirmed by the next frame
+ * and passed on with one frame of delay.
+ */
+typedef struct
+{
+    uint32_t rejected;
+    uint32_t steps;
+} glitch_filter_stats_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern glitch_filter_stats_t glitch_filter_stats;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void glitch_filter_run(void);
+
+#endif /* GLITCH_FILTER_EN */
+
+#endif /* GLITCH_FILTER_H_ */
+
+/* [] END OF FILE */
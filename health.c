@@ -0,0 +1,316 @@
+/******************************************************************************
+* File Name: health.c
+*
+* Description: This file contains the run-time health checks of the sensing
+*              loop.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <string.h>
+#include "health.h"
+#include "timestamp.h"
+
+#if HEALTH_EN
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+/* Health summary, provided by the register map */
+static health_t *health;
+
+/* Start of the current touch of each sensor */
+static uint32_t touch_start_us[CY_CAPSENSE_SENSOR_COUNT];
+static uint8_t touch_active[CY_CAPSENSE_SENSOR_COUNT];
+
+/* Start of the first scan of the open frame and the last processed frame */
+static uint32_t frame_start_us;
+static bool frame_open = false;
+static uint32_t frame_last;
+
+/*******************************************************************************
+* Function Name: health_violation
+********************************************************************************
+* Summary:
+*  Counts a failed check.
+*
+* Parameters:
+*  check - failed check
+*  flag - HEALTH_FLAG_* of the check
+*  frame - frame sequence number
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void health_violation(health_check_t check, uint8_t flag, uint32_t frame)
+{
+    if (0u == health->flags)
+    {
+        health->first_frame = frame;
+    }
+    health->flags |= flag;
+    health->violations[check]++;
+}
+
+/*******************************************************************************
+* Function Name: health_init
+********************************************************************************
+* Summary:
+*  Clears the health summary and the check state.
+*
+* Parameters:
+*  storage - storage of the summary
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void health_init(health_t *storage)
+{
+    health = storage;
+    memset(touch_active, 0, sizeof(touch_active));
+    frame_open = false;
+    health_clear();
+}
+
+/*******************************************************************************
+* Function Name: health_clear
+********************************************************************************
+* Summary:
+*  Clears the flags, counters and extremes. A touch in progress keeps its
+*  start time.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void health_clear(void)
+{
+    uint32_t i;
+
+    memset(health, 0, sizeof(health_t));
+    health->sensors = CY_CAPSENSE_SENSOR_COUNT;
+
+    for (i = 0u; i < CY_CAPSENSE_SENSOR_COUNT; i++)
+    {
+        health->bsln_min[i] = UINT16_MAX;
+    }
+}
+
+/*******************************************************************************
+* Function Name: health_frame_close
+********************************************************************************
+* Summary:
+*  Closes the open frame and checks its time against the frame budget. The
+*  violation is counted for the last processed frame.
+*
+* Parameters:
+*  now_us - device time of the end of the frame
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void health_frame_close(uint32_t now_us)
+{
+    uint32_t elapsed = now_us - frame_start_us;
+
+    if (elapsed > health->max_frame_us)
+    {
+        health->max_frame_us = elapsed;
+    }
+    if ((0u != HEALTH_FRAME_BUDGET_US) && (elapsed > HEALTH_FRAME_BUDGET_US))
+    {
+        health_violation(HEALTH_CHECK_FRAME_BUDGET, HEALTH_FLAG_FRAME_BUDGET, frame_last);
+    }
+    frame_open = false;
+}
+
+/*******************************************************************************
+* Function Name: health_frame_start
+********************************************************************************
+* Summary:
+*  Closes the previous frame, if still open, and opens the next one. Called
+*  through HEALTH_FRAME_START() where the scan of a frame starts, so a frame
+*  without a deliberate sleep is measured from start to start and includes
+*  the Tuner, BIST and flash row writes that follow its processing.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void health_frame_start(void)
+{
+    uint32_t now_us = timestamp_get_us();
+
+    if (frame_open)
+    {
+        health_frame_close(now_us);
+    }
+    frame_start_us = now_us;
+    frame_open = true;
+}
+
+/*******************************************************************************
+* Function Name: health_frame_idle
+********************************************************************************
+* Summary:
+*  Closes the open frame before a deliberate sleep of the scan mode, so the
+*  sleep does not count against the frame budget. Called through
+*  HEALTH_FRAME_IDLE().
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void health_frame_idle(void)
+{
+    if (frame_open)
+    {
+        health_frame_close(timestamp_get_us());
+    }
+}
+
+/*******************************************************************************
+* Function Name: health_update
+********************************************************************************
+* Summary:
+*  Checks the processed frame: touch duration and baseline of every sensor.
+*  The frame time is checked when the frame closes.
+*
+* Parameters:
+*  frame - frame sequence number
+*  time_us - device time of the processing
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void health_update(uint32_t frame, uint32_t time_us)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    const cy_stc_capsense_sensor_context_t *sns_ctx;
+    uint32_t sns_index = 0u;
+    uint32_t bsln_min;
+    uint32_t bsln_max;
+    uint32_t elapsed;
+    uint32_t wd;
+    uint32_t sns;
+    bool stuck = false;
+    bool low = false;
+    bool high = false;
+
+    health->frames++;
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+        bsln_min = ((uint32_t)wd_cfg->ptrWdContext->maxRawCount * HEALTH_BSLN_MIN_PERCENT) / 100u;
+        bsln_max = ((uint32_t)wd_cfg->ptrWdContext->maxRawCount * HEALTH_BSLN_MAX_PERCENT) / 100u;
+
+        for (sns = 0u; sns < wd_cfg->numSns; sns++)
+        {
+            sns_ctx = &wd_cfg->ptrSnsContext[sns];
+
+            if (0u != (sns_ctx->status & CY_CAPSENSE_SNS_TOUCH_STATUS_MASK))
+            {
+                if (0u == touch_active[sns_index])
+                {
+                    touch_active[sns_index] = 1u;
+                    touch_start_us[sns_index] = time_us;
+                }
+
+                elapsed = (time_us - touch_start_us[sns_index]) / 1000u;
+                if (elapsed > health->max_touch_ms)
+                {
+                    health->max_touch_ms = elapsed;
+                }
+                if (elapsed > HEALTH_STUCK_TOUCH_MS)
+                {
+                    stuck = true;
+                }
+            }
+            else
+            {
+                touch_active[sns_index] = 0u;
+            }
+
+            if (sns_ctx->bsln < health->bsln_min[sns_index])
+            {
+                health->bsln_min[sns_index] = sns_ctx->bsln;
+            }
+            if (sns_ctx->bsln > health->bsln_max[sns_index])
+            {
+                health->bsln_max[sns_index] = sns_ctx->bsln;
+            }
+            low = low || (sns_ctx->bsln < bsln_min);
+            high = high || (sns_ctx->bsln > bsln_max);
+
+            sns_index++;
+        }
+    }
+
+    if (stuck)
+    {
+        health_violation(HEALTH_CHECK_STUCK_TOUCH, HEALTH_FLAG_STUCK_TOUCH, frame);
+    }
+    if (low)
+    {
+        health_violation(HEALTH_CHECK_BSLN_LOW, HEALTH_FLAG_BSLN_LOW, frame);
+    }
+    if (high)
+    {
+        health_violation(HEALTH_CHECK_BSLN_HIGH, HEALTH_FLAG_BSLN_HIGH, frame);
+    }
+
+    frame_last = frame;
+}
+
+#endif /* HEALTH_EN */
+
+/* [] END OF FILE */
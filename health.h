@@ -0,0 +1,135 @@
+/******************************************************************************
+* File Name: health.h
+*
+* Description: This file contains the run-time health checks of the sensing
+*              loop: stuck touch, baseline bounds and frame period budget.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef HEALTH_H_
+#define HEALTH_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_pdl.h"
+#include "cycfg_capsense.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Enables the run-time health checks */
+#ifndef HEALTH_EN
+#define HEALTH_EN                        (0u)
+#endif
+
+/* A sensor that reports touch for longer than this is counted as stuck */
+#define HEALTH_STUCK_TOUCH_MS            (30000u)
+
+/* Baseline bounds in percent of the maximum raw count of the widget */
+#define HEALTH_BSLN_MIN_PERCENT          (20u)
+#define HEALTH_BSLN_MAX_PERCENT          (98u)
+
+/* Longest allowed frame time, from the start of the first scan of a frame to
+ * the start of the next one, 0 disables the check. Only the deliberate sleep
+ * of the on-demand, burst and RTOS modes is left out.
+ */
+#define HEALTH_FRAME_BUDGET_US           (20000u)
+
+/* Violation flags, kept until cleared by the host */
+#define HEALTH_FLAG_STUCK_TOUCH          (0x01u)
+#define HEALTH_FLAG_BSLN_LOW             (0x02u)
+#define HEALTH_FLAG_BSLN_HIGH            (0x04u)
+#define HEALTH_FLAG_FRAME_BUDGET         (0x08u)
+
+#if HEALTH_EN
+
+/* Mark the start of the first scan of a frame and the start of a deliberate
+ * sleep between frames, compile to nothing when the health checks are disabled
+ */
+#define HEALTH_FRAME_START()             health_frame_start()
+#define HEALTH_FRAME_IDLE()              health_frame_idle()
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Checks, in the order of the violation counters */
+typedef enum
+{
+    HEALTH_CHECK_STUCK_TOUCH = 0u,
+    HEALTH_CHECK_BSLN_LOW,
+    HEALTH_CHECK_BSLN_HIGH,
+    HEALTH_CHECK_FRAME_BUDGET,
+    HEALTH_CHECK_COUNT
+} health_check_t;
+
+/* Health summary. violations counts the frames that failed each check,
+ * first_frame is the frame of the first violation since the last clear.
+ * The extremes cover the same interval.
+ */
+typedef struct
+{
+    uint8_t flags;
+    uint8_t sensors;
+    uint16_t reserved;
+    uint32_t frames;
+    uint32_t first_frame;
+    uint32_t violations[HEALTH_CHECK_COUNT];
+    uint32_t max_frame_us;
+    uint32_t max_touch_ms;
+    uint16_t bsln_min[CY_CAPSENSE_SENSOR_COUNT];
+    uint16_t bsln_max[CY_CAPSENSE_SENSOR_COUNT];
+} health_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void health_init(health_t *health);
+void health_clear(void);
+void health_frame_start(void);
+void health_frame_idle(void);
+void health_update(uint32_t frame, uint32_t time_us);
+
+#else
+#define HEALTH_FRAME_START()             ((void)0)
+#define HEALTH_FRAME_IDLE()              ((void)0)
+#endif /* HEALTH_EN */
+
+#endif /* HEALTH_H_ */
+
+/* [] END OF FILE */
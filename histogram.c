@@ -0,0 +1,211 @@
+/******************************************************************************
+* File Name: histogram.c
+*
+* Description: This file contains the per-sensor histograms of the difference
+*              count and of the raw count deviation from the baseline.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdbool.h>
+#include <string.h>
+#include "histogram.h"
+
+#if HISTOGRAM_EN
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Offset that maps a deviation of 0 to the center bin */
+#define HISTOGRAM_DEV_OFFSET             ((int32_t)(HISTOGRAM_BINS / 2u) << HISTOGRAM_BIN_SHIFT)
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+/* Histogram storage, provided by the register map */
+static histogram_t *histogram;
+
+/* A clear requested by the host, done with the next frame */
+static bool clear_pending = false;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void histogram_count(uint16_t *bins, uint32_t bin);
+
+/*******************************************************************************
+* Function Name: histogram_init
+********************************************************************************
+* Summary:
+*  Sets the storage of the histograms and clears them.
+*
+* Parameters:
+*  storage - storage of the histograms
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void histogram_init(histogram_t *storage)
+{
+    histogram = storage;
+    memset(histogram, 0, sizeof(histogram_t));
+    histogram->bins = HISTOGRAM_BINS;
+    histogram->bin_shift = HISTOGRAM_BIN_SHIFT;
+    histogram->sensors = CY_CAPSENSE_SENSOR_COUNT;
+}
+
+/*******************************************************************************
+* Function Name: histogram_clear
+********************************************************************************
+* Summary:
+*  Clears all bins. The host clears after each download so that the bins do
+*  not saturate. The bins are cleared in the update of the next frame, which
+*  changes the sequence numbers, so a host read never passes the check on a
+*  partly cleared block.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void histogram_clear(void)
+{
+    clear_pending = true;
+}
+
+/*******************************************************************************
+* Function Name: histogram_update
+********************************************************************************
+* Summary:
+*  Adds the processed frame: one increment in the diff histogram of every
+*  sensor and, for untouched sensors, one in the deviation histogram.
+*
+* Parameters:
+*  frame - frame sequence number
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void histogram_update(uint32_t frame)
+{
+    const cy_stc_capsense_sensor_context_t *sns_ctx;
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    uint32_t sns_index = 0u;
+    uint32_t bin;
+    int32_t dev;
+    uint32_t wd;
+    uint32_t sns;
+
+    /* seq_end first and seq last, see host_regs_publish_frame() */
+    histogram->seq_end = frame;
+    __DMB();
+
+    if (clear_pending)
+    {
+        clear_pending = false;
+        histogram->frames = 0u;
+        memset(histogram->diff, 0, sizeof(histogram->diff));
+        memset(histogram->dev, 0, sizeof(histogram->dev));
+    }
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+
+        for (sns = 0u; sns < wd_cfg->numSns; sns++)
+        {
+            sns_ctx = &wd_cfg->ptrSnsContext[sns];
+
+            bin = (uint32_t)sns_ctx->diff >> HISTOGRAM_BIN_SHIFT;
+            histogram_count(histogram->diff[sns_index], bin);
+
+            if (0u == (sns_ctx->status & CY_CAPSENSE_SNS_TOUCH_STATUS_MASK))
+            {
+                dev = ((int32_t)sns_ctx->raw - (int32_t)sns_ctx->bsln) + HISTOGRAM_DEV_OFFSET;
+                if (dev < 0)
+                {
+                    dev = 0;
+                }
+                bin = (uint32_t)dev >> HISTOGRAM_BIN_SHIFT;
+                histogram_count(histogram->dev[sns_index], bin);
+            }
+
+            sns_index++;
+        }
+    }
+
+    histogram->frames++;
+    __DMB();
+    histogram->seq = frame;
+}
+
+/*******************************************************************************
+* Function Name: histogram_count
+********************************************************************************
+* Summary:
+*  Increments a bin, or the last bin for values beyond the range. The bin
+*  stops at HISTOGRAM_BIN_MAX.
+*
+* Parameters:
+*  bins - bins of one histogram
+*  bin - bin index
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void histogram_count(uint16_t *bins, uint32_t bin)
+{
+    if (bin >= HISTOGRAM_BINS)
+    {
+        bin = HISTOGRAM_BINS - 1u;
+    }
+
+    if (bins[bin] < HISTOGRAM_BIN_MAX)
+    {
+        bins[bin]++;
+    }
+}
+
+#endif /* HISTOGRAM_EN */
+
+/* [] END OF FILE */
@@ -0,0 +1,108 @@
+/******************************************************************************
+* File Name: histogram.h
+*
+* Description: This file contains the per-sensor histograms of the difference
+*              count and of the raw count deviation from the baseline.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef HISTOGRAM_H_
+#define HISTOGRAM_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include "cy_pdl.h"
+#include "cycfg_capsense.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Enables the on-device histograms */
+#define HISTOGRAM_EN                     (0u)
+
+/* Bins per histogram. The last diff bin and both end bins of the deviation
+ * histogram also count every sample beyond them.
+ */
+#define HISTOGRAM_BINS                   (32u)
+
+/* Bin width is 2^HISTOGRAM_BIN_SHIFT counts */
+#define HISTOGRAM_BIN_SHIFT              (2u)
+
+/* Bins are 16 bits wide and stop at this count */
+#define HISTOGRAM_BIN_MAX                (0xFFFFu)
+
+#if HISTOGRAM_EN
+
+#if (HISTOGRAM_BINS & 1u) != 0u
+#error "HISTOGRAM_BINS must be even"
+#endif
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Histograms of all sensors since the last clear. diff counts every frame,
+ * dev counts raw - baseline in frames where the sensor is not touched, with
+ * bin HISTOGRAM_BINS / 2 starting at 0. A bin that reaches HISTOGRAM_BIN_MAX
+ * stays there until the next clear. seq and seq_end match when the block was
+ * read consistently.
+ */
+typedef struct
+{
+    uint32_t seq;
+    uint8_t bins;
+    uint8_t bin_shift;
+    uint8_t sensors;
+    uint8_t reserved;
+    uint32_t frames;
+    uint16_t diff[CY_CAPSENSE_SENSOR_COUNT][HISTOGRAM_BINS];
+    uint16_t dev[CY_CAPSENSE_SENSOR_COUNT][HISTOGRAM_BINS];
+    uint32_t seq_end;
+} histogram_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void histogram_init(histogram_t *storage);
+void histogram_clear(void);
+void histogram_update(uint32_t frame);
+
+#endif /* HISTOGRAM_EN */
+
+#endif /* HISTOGRAM_H_ */
+
+/* [] END OF FILE */
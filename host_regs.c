@@ -0,0 +1,429 @@
+/******************************************************************************
+* File Name: host_regs.c
+*
+* Description: This file contains the application register map that is exposed
+*              to an I2C host over EZI2C.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include "host_regs.h"
+#include "timestamp.h"
+
+#if HOST_REGS_EN
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+/* Register map exposed over EZI2C */
+host_regs_t host_regs;
+
+/* EZI2C activity accumulated by the ISR and consumed by the main loop */
+static volatile uint32_t host_events = 0u;
+
+#if FRAME_ETA_EN
+/* Filtered frame period in 1/16 us, 0 until two frames were seen */
+static uint32_t frame_period_q4 = 0u;
+
+/* Frames published so far */
+static uint32_t frames_seen = 0u;
+#endif
+
+#if HOST_REGS_SECOND_ADDR_EN
+/* Interrupts of the running EZI2C transaction */
+static uint32_t isr_pending_count = 0u;
+static uint32_t isr_pending_cycles = 0u;
+static uint32_t isr_pending_max = 0u;
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#if FRAME_ETA_EN
+static void host_regs_update_eta(uint32_t frame, uint32_t time_us);
+#endif
+
+/*******************************************************************************
+* Function Name: host_regs_init
+********************************************************************************
+* Summary:
+*  Clears the register map and fills in the block directory.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void host_regs_init(void)
+{
+    memset(&host_regs, 0, sizeof(host_regs));
+
+    host_regs.info.magic = HOST_REGS_MAGIC;
+    host_regs.info.version = HOST_REGS_VERSION;
+    host_regs.info.size = (uint16_t)sizeof(host_regs);
+    host_regs.info.block_offset[HOST_BLOCK_STATUS] = (uint16_t)offsetof(host_regs_t, status);
+    host_regs.info.block_offset[HOST_BLOCK_FRAME] = (uint16_t)offsetof(host_regs_t, frame);
+    host_regs.info.block_offset[HOST_BLOCK_SYNC] = (uint16_t)offsetof(host_regs_t, sync);
+#if ON_DEMAND_SCAN_EN
+    host_regs.info.block_offset[HOST_BLOCK_SCAN_STATS] = (uint16_t)offsetof(host_regs_t, scan_stats);
+#endif
+#if TOUCH_HISTORY_EN
+    host_regs.info.block_offset[HOST_BLOCK_TOUCH_HISTORY] = (uint16_t)offsetof(host_regs_t, history);
+#endif
+#if TRACE_EN
+    host_regs.info.block_offset[HOST_BLOCK_TRACE] = (uint16_t)offsetof(host_regs_t, trace);
+#endif
+#if HEALTH_EN
+    host_regs.info.block_offset[HOST_BLOCK_HEALTH] = (uint16_t)offsetof(host_regs_t, health);
+#endif
+#if HISTOGRAM_EN
+    host_regs.info.block_offset[HOST_BLOCK_HISTOGRAM] = (uint16_t)offsetof(host_regs_t, histogram);
+#endif
+#if BENCH_EN
+    host_regs.info.block_offset[HOST_BLOCK_BENCH] = (uint16_t)offsetof(host_regs_t, bench);
+#endif
+#if AUTOTUNE_EN
+    host_regs.info.block_offset[HOST_BLOCK_AUTOTUNE] = (uint16_t)offsetof(host_regs_t, autotune);
+#endif
+#if FRAME_ETA_EN
+    host_regs.info.block_offset[HOST_BLOCK_FRAME_ETA] = (uint16_t)offsetof(host_regs_t, frame_eta);
+#endif
+#if HOST_REGS_SECOND_ADDR_EN
+    host_regs.info.block_offset[HOST_BLOCK_EZI2C] = (uint16_t)offsetof(host_regs_t, ezi2c);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: host_regs_isr_update
+********************************************************************************
+* Summary:
+*  Records EZI2C activity. Called from the EZI2C ISR with the value returned by
+*  Cy_SCB_EZI2C_GetActivity(). A time sync command is answered here, so that
+*  the latched device time is not delayed by the main loop.
+*
+* Parameters:
+*  activity - EZI2C activity status
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void host_regs_isr_update(uint32_t activity)
+{
+    if ((0u != (activity & HOST_REGS_STATUS_WRITE)) &&
+        (HOST_CMD_TIME_SYNC == host_regs.mailbox.cmd))
+    {
+        host_regs.sync.device_us = timestamp_get_us();
+        host_regs.sync.tag = host_regs.mailbox.tag;
+        host_regs.sync.count++;
+        host_regs_set_status(&host_regs.mailbox, HOST_CMD_STATUS_DONE);
+        host_regs.mailbox.cmd = HOST_CMD_NONE;
+    }
+
+    host_events |= activity;
+}
+
+#if HOST_REGS_SECOND_ADDR_EN
+/*******************************************************************************
+* Function Name: host_regs_isr_cost
+********************************************************************************
+* Summary:
+*  Adds the cost of one EZI2C interrupt to the running transaction, and the
+*  transaction to its slave address when it completes. Called at the end of
+*  the EZI2C ISR. The two masters share one bus, so transactions do not
+*  overlap.
+*
+* Parameters:
+*  activity - EZI2C activity status of this interrupt
+*  cycles - CPU cycles of this interrupt
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void host_regs_isr_cost(uint32_t activity, uint32_t cycles)
+{
+    uint32_t addr;
+
+    isr_pending_count++;
+    isr_pending_cycles += cycles;
+    if (cycles > isr_pending_max)
+    {
+        isr_pending_max = cycles;
+    }
+
+    if (0u != (activity & (CY_SCB_EZI2C_STATUS_READ1 | CY_SCB_EZI2C_STATUS_WRITE1)))
+    {
+        addr = 0u;
+    }
+    else if (0u != (activity & (CY_SCB_EZI2C_STATUS_READ2 | CY_SCB_EZI2C_STATUS_WRITE2)))
+    {
+        addr = 1u;
+    }
+    else
+    {
+        if (0u != (activity & CY_SCB_EZI2C_STATUS_ERR))
+        {
+            isr_pending_count = 0u;
+            isr_pending_cycles = 0u;
+            isr_pending_max = 0u;
+        }
+        return;
+    }
+
+    host_regs.ezi2c.transactions[addr]++;
+    host_regs.ezi2c.isr_count[addr] += isr_pending_count;
+    host_regs.ezi2c.isr_cycles[addr] += isr_pending_cycles;
+    if (isr_pending_max > host_regs.ezi2c.isr_max[addr])
+    {
+        host_regs.ezi2c.isr_max[addr] = isr_pending_max;
+    }
+    isr_pending_count = 0u;
+    isr_pending_cycles = 0u;
+    isr_pending_max = 0u;
+}
+#endif /* HOST_REGS_SECOND_ADDR_EN */
+
+/*******************************************************************************
+* Function Name: host_regs_take_events
+********************************************************************************
+* Summary:
+*  Returns and clears the EZI2C activity recorded since the last call.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - CY_SCB_EZI2C_STATUS_* flags
+*
+*******************************************************************************/
+uint32_t host_regs_take_events(void)
+{
+    uint32_t events;
+    uint32_t intr_state = Cy_SysLib_EnterCriticalSection();
+
+    events = host_events;
+    host_events = 0u;
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    return events;
+}
+
+/*******************************************************************************
+* Function Name: host_regs_fetch_command
+********************************************************************************
+* Summary:
+*  Takes a pending command out of the mailbox and marks it busy.
+*
+* Parameters:
+*  cmd - receives a copy of the mailbox
+*
+* Return:
+*  bool - true if a command was pending
+*
+*******************************************************************************/
+bool host_regs_fetch_command(host_mailbox_t *cmd)
+{
+    bool pending = false;
+    uint32_t intr_state = Cy_SysLib_EnterCriticalSection();
+
+    if (HOST_CMD_NONE != host_regs.mailbox.cmd)
+    {
+        *cmd = host_regs.mailbox;
+        host_regs.mailbox.cmd = HOST_CMD_NONE;
+        pending = true;
+    }
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    if (pending)
+    {
+        TRACE_EVENT(TRACE_EVT_HOST_CMD);
+        host_regs_set_status(cmd, HOST_CMD_STATUS_BUSY);
+    }
+
+    return pending;
+}
+
+/*******************************************************************************
+* Function Name: host_regs_set_status
+********************************************************************************
+* Summary:
+*  Publishes the status of a command.
+*
+* Parameters:
+*  cmd - command the status belongs to
+*  status - HOST_CMD_STATUS_* value
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void host_regs_set_status(const host_mailbox_t *cmd, uint8_t status)
+{
+    host_regs.status.cmd = cmd->cmd;
+    host_regs.status.tag = cmd->tag;
+    host_regs.status.status = status;
+    host_regs.status.detail = 0u;
+}
+
+/*******************************************************************************
+* Function Name: host_regs_publish_frame
+********************************************************************************
+* Summary:
+*  Copies the touch status and difference counts of the processed frame into
+*  the register map.
+*
+* Parameters:
+*  frame - frame sequence number
+*  time_us - device time at the end of the scan
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void host_regs_publish_frame(uint32_t frame, uint32_t time_us)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    uint32_t touch_mask = 0u;
+    uint32_t sns_index = 0u;
+    uint32_t wd;
+    uint32_t sns;
+
+    /* The host reads the block in address order while the EZI2C interrupt
+     * preempts this update. seq_end is written first and seq last, so a read
+     * that overlaps the update sees them differ.
+     */
+    host_regs.frame.seq_end = frame;
+    __DMB();
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+
+        for (sns = 0u; sns < wd_cfg->numSns; sns++)
+        {
+            /* The touch mask covers the first 32 sensors */
+            if ((sns_index < 32u) &&
+                (0u != (wd_cfg->ptrSnsContext[sns].status & CY_CAPSENSE_SNS_TOUCH_STATUS_MASK)))
+            {
+                touch_mask |= (1uL << sns_index);
+            }
+            host_regs.frame.diff[sns_index] = wd_cfg->ptrSnsContext[sns].diff;
+            sns_index++;
+        }
+    }
+
+    host_regs.frame.touch_mask = touch_mask;
+    host_regs.frame.time_us = time_us;
+    __DMB();
+    host_regs.frame.seq = frame;
+
+#if FRAME_ETA_EN
+    host_regs_update_eta(frame, time_us);
+#endif
+}
+
+#if FRAME_ETA_EN
+/*******************************************************************************
+* Function Name: host_regs_update_eta
+********************************************************************************
+* Summary:
+*  Updates the frame period filter with the time since the previous frame and
+*  publishes the predicted time stamp of the next frame. A frame that took
+*  more than FRAME_ETA_PAUSE_MULT mean periods is not averaged in.
+*
+* Parameters:
+*  frame - frame sequence number
+*  time_us - device time at the end of the scan
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void host_regs_update_eta(uint32_t frame, uint32_t time_us)
+{
+    host_frame_eta_t *eta = &host_regs.frame_eta;
+    uint32_t frames = frame - eta->seq;
+    uint32_t period_q4;
+    int32_t remaining;
+
+    if ((frames_seen > 0u) && (frames > 0u))
+    {
+        period_q4 = ((time_us - eta->time_us) / frames) << 4u;
+
+        if (0u == frame_period_q4)
+        {
+            frame_period_q4 = period_q4;
+        }
+        else if (period_q4 <= (frame_period_q4 * FRAME_ETA_PAUSE_MULT))
+        {
+            frame_period_q4 = frame_period_q4 - (frame_period_q4 >> FRAME_ETA_SHIFT) +
+                              (period_q4 >> FRAME_ETA_SHIFT);
+        }
+        else
+        {
+            /* A pause, keep the mean */
+        }
+    }
+    frames_seen++;
+
+    /* seq_end first and seq last, as in the frame block */
+    eta->seq_end = frame;
+    __DMB();
+    eta->time_us = time_us;
+    eta->period_us = (frame_period_q4 + 8u) >> 4u;
+    if (0u != eta->period_us)
+    {
+        eta->next_us = time_us + eta->period_us;
+        remaining = (int32_t)(eta->next_us - timestamp_get_us());
+        eta->eta_us = (remaining > 0) ? (uint32_t)remaining : 0u;
+    }
+    __DMB();
+    eta->seq = frame;
+}
+#endif /* FRAME_ETA_EN */
+
+#endif /* HOST_REGS_EN */
+
+/* [] END OF FILE */
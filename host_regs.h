@@ -0,0 +1,323 @@
+/******************************************************************************
+* File Name: host_regs.h
+*
+* Description: This file contains the application register map that is exposed
+*              to an I2C host over EZI2C.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef HOST_REGS_H_
+#define HOST_REGS_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_pdl.h"
+#include "cycfg_capsense.h"
+#include "touch_history.h"
+#include "scan_slot.h"
+#include "trace.h"
+#include "health.h"
+#include "param_batch.h"
+#include "histogram.h"
+#include "bench.h"
+#include "autotune.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Enables scanning on host request instead of the free-running scan loop */
+#define ON_DEMAND_SCAN_EN                (0u)
+
+/* Enables the frame ETA block, which predicts when the next frame completes */
+#define FRAME_ETA_EN                     (0u)
+
+/* Frame period filter, 1 / 2^FRAME_ETA_SHIFT per frame */
+#define FRAME_ETA_SHIFT                  (4u)
+
+/* A frame longer than this many mean frame periods is a pause, such as a
+ * flash write, and is not averaged in
+ */
+#define FRAME_ETA_PAUSE_MULT             (4u)
+
+/* Serves the register map on the secondary EZI2C address (SlaveAddress2 in
+ * design.modus) and keeps the CAPSENSE Tuner buffer on the primary address.
+ * Set the number of EZI2C addresses to two in design.modus to use it.
+ */
+#define HOST_REGS_SECOND_ADDR_EN         (0u)
+
+/* The register map is built when any feature needs it */
+#define HOST_REGS_EN                     (ON_DEMAND_SCAN_EN || TOUCH_HISTORY_EN || SCAN_SLOT_EN || \
+                                          TRACE_EN || HEALTH_EN || PARAM_BATCH_EN || \
+                                          HISTOGRAM_EN || BENCH_EN || AUTOTUNE_EN || \
+                                          FRAME_ETA_EN || HOST_REGS_SECOND_ADDR_EN)
+
+/* Register map marker, "HREG" */
+#define HOST_REGS_MAGIC                  (0x47455248u)
+
+/* Register map layout version */
+#define HOST_REGS_VERSION                (2u)
+
+/* Size of the command payload in the host-writable mailbox */
+#if PARAM_BATCH_EN
+#define HOST_REGS_PAYLOAD_SIZE           (PARAM_BATCH_MAX * PARAM_BATCH_ENTRY_SIZE)
+#else
+#define HOST_REGS_PAYLOAD_SIZE           (8u)
+#endif
+
+/* Mailbox commands */
+#define HOST_CMD_NONE                    (0x00u)
+#define HOST_CMD_SCAN                    (0x01u) /* payload[0]: frames, 0 for default */
+#define HOST_CMD_SET_SCAN_COUNT          (0x02u) /* payload[0]: default frames per scan */
+#define HOST_CMD_SELECT_PROFILE          (0x03u) /* payload[0]: profile_id_t */
+#define HOST_CMD_TIME_SYNC               (0x04u) /* no payload, handled in the EZI2C ISR */
+#define HOST_CMD_SET_SLOT                (0x05u) /* payload[0]: slot, payload[1]: slot count */
+#define HOST_CMD_SLOT_SYNC               (0x06u) /* payload[0..3]: period start in device time,
+                                                   payload[4..5]: period number */
+#define HOST_CMD_TRACE_FREEZE            (0x07u) /* payload[0]: 1 to stop recording, 0 to resume */
+#define HOST_CMD_HEALTH_CLEAR            (0x08u) /* no payload */
+#define HOST_CMD_SET_PARAMS              (0x09u) /* payload: len / 4 entries of widget, parameter,
+                                                   value (16-bit LE), see param_batch.h */
+#define HOST_CMD_HISTOGRAM_CLEAR         (0x0Au) /* no payload */
+#define HOST_CMD_BENCH_SENSORS           (0x0Bu) /* payload[0..1]: virtual sensors, 0 for default */
+#define HOST_CMD_TUNE_WINDOW             (0x0Cu) /* payload[0]: 0 no-touch, 1 touch window */
+#define HOST_CMD_TUNE_APPLY              (0x0Du) /* no payload */
+
+/* Command status */
+#define HOST_CMD_STATUS_IDLE             (0x00u)
+#define HOST_CMD_STATUS_BUSY             (0x01u)
+#define HOST_CMD_STATUS_DONE             (0x02u)
+#define HOST_CMD_STATUS_ERROR            (0x03u)
+
+#if HOST_REGS_EN
+
+#if FRAME_ETA_EN && ON_DEMAND_SCAN_EN
+#error "FRAME_ETA_EN predicts periodic frames, with ON_DEMAND_SCAN_EN the host starts each frame"
+#endif
+
+/* EZI2C activity flags of the register map address */
+#if HOST_REGS_SECOND_ADDR_EN
+#define HOST_REGS_STATUS_READ            (CY_SCB_EZI2C_STATUS_READ2)
+#define HOST_REGS_STATUS_WRITE           (CY_SCB_EZI2C_STATUS_WRITE2)
+#else
+#define HOST_REGS_STATUS_READ            (CY_SCB_EZI2C_STATUS_READ1)
+#define HOST_REGS_STATUS_WRITE           (CY_SCB_EZI2C_STATUS_WRITE1)
+#endif
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Blocks listed in the register map directory */
+typedef enum
+{
+    HOST_BLOCK_STATUS = 0u,
+    HOST_BLOCK_FRAME,
+    HOST_BLOCK_SCAN_STATS,
+    HOST_BLOCK_TOUCH_HISTORY,
+    HOST_BLOCK_SYNC,
+    HOST_BLOCK_TRACE,
+    HOST_BLOCK_HEALTH,
+    HOST_BLOCK_HISTOGRAM,
+    HOST_BLOCK_BENCH,
+    HOST_BLOCK_AUTOTUNE,
+    HOST_BLOCK_FRAME_ETA,
+    HOST_BLOCK_EZI2C,
+    HOST_BLOCK_COUNT
+} host_block_t;
+
+/* Host-writable mailbox, always at offset 0 of the register map. The host
+ * fills tag, len and payload, then cmd. The firmware clears cmd when it takes
+ * the command.
+ */
+typedef struct
+{
+    uint8_t cmd;
+    uint8_t tag;
+    uint8_t len;
+    uint8_t reserved;
+    uint8_t payload[HOST_REGS_PAYLOAD_SIZE];
+} host_mailbox_t;
+
+/* Register map directory. A block offset of 0 means the block is absent. */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    uint16_t block_offset[HOST_BLOCK_COUNT];
+} host_info_t;
+
+/* Status of the last command. detail is command specific, for
+ * HOST_CMD_SET_PARAMS it is 1 + the index of the rejected entry, for
+ * HOST_CMD_TUNE_APPLY 1 + the index of the failing widget.
+ */
+typedef struct
+{
+    uint8_t cmd;
+    uint8_t tag;
+    uint8_t status;
+    uint8_t detail;
+} host_status_t;
+
+/* Latest processed frame. seq and seq_end match when the block was read
+ * consistently: the firmware writes seq_end first and seq last, so a read in
+ * address order that overlaps an update sees them differ. time_us is the
+ * device time at the end of the last scan of the frame.
+ */
+typedef struct
+{
+    uint32_t seq;
+    uint32_t touch_mask;
+    uint32_t time_us;
+    uint16_t diff[CY_CAPSENSE_SENSOR_COUNT];
+    uint32_t seq_end;
+} host_frame_t;
+
+/* Frame timing for host read scheduling, updated with the frame block. seq
+ * and seq_end match when the block was read consistently. time_us is the
+ * time stamp of frame seq, period_us the filtered frame period and next_us
+ * the predicted time stamp of the next frame, all in device time. eta_us is
+ * the time from the update of the block to next_us. period_us and next_us
+ * are 0 until two frames were seen.
+ */
+typedef struct
+{
+    uint32_t seq;
+    uint32_t time_us;
+    uint32_t period_us;
+    uint32_t next_us;
+    uint32_t eta_us;
+    uint32_t seq_end;
+} host_frame_eta_t;
+
+/* EZI2C interrupt cost per slave address, index 0 for the primary address
+ * (Tuner) and 1 for the secondary one (register map). The interrupts of a
+ * transaction are added to its address when the transaction completes; those
+ * of failed transactions are dropped. isr_max is the longest single
+ * interrupt in CPU cycles.
+ */
+typedef struct
+{
+    uint32_t transactions[2];
+    uint32_t isr_count[2];
+    uint32_t isr_cycles[2];
+    uint32_t isr_max[2];
+} host_ezi2c_stats_t;
+
+/* Time synchronization. device_us is latched in the EZI2C ISR when the write
+ * of HOST_CMD_TIME_SYNC completes, tag is copied from that command.
+ */
+typedef struct
+{
+    uint8_t tag;
+    uint8_t reserved[3];
+    uint32_t count;
+    uint32_t device_us;
+} host_sync_t;
+
+/* Activity accounting for energy estimation. Time spent in Deep Sleep is not
+ * counted, the host derives it from the wall clock.
+ */
+typedef struct
+{
+    uint32_t queries;
+    uint32_t frames;
+    uint32_t active_us;
+    uint32_t sleep_us;
+} host_scan_stats_t;
+
+/* Application register map */
+typedef struct
+{
+    host_mailbox_t mailbox;
+    host_info_t info;
+    host_status_t status;
+    host_frame_t frame;
+    host_sync_t sync;
+#if ON_DEMAND_SCAN_EN
+    host_scan_stats_t scan_stats;
+#endif
+#if TOUCH_HISTORY_EN
+    touch_history_t history;
+#endif
+#if TRACE_EN
+    trace_t trace;
+#endif
+#if HEALTH_EN
+    health_t health;
+#endif
+#if HISTOGRAM_EN
+    histogram_t histogram;
+#endif
+#if BENCH_EN
+    bench_t bench;
+#endif
+#if AUTOTUNE_EN
+    autotune_t autotune;
+#endif
+#if FRAME_ETA_EN
+    host_frame_eta_t frame_eta;
+#endif
+#if HOST_REGS_SECOND_ADDR_EN
+    host_ezi2c_stats_t ezi2c;
+#endif
+} host_regs_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern host_regs_t host_regs;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void host_regs_init(void);
+void host_regs_isr_update(uint32_t activity);
+#if HOST_REGS_SECOND_ADDR_EN
+void host_regs_isr_cost(uint32_t activity, uint32_t cycles);
+#endif
+uint32_t host_regs_take_events(void);
+bool host_regs_fetch_command(host_mailbox_t *cmd);
+void host_regs_set_status(const host_mailbox_t *cmd, uint8_t status);
+void host_regs_publish_frame(uint32_t frame, uint32_t time_us);
+
+#endif /* HOST_REGS_EN */
+
+#endif /* HOST_REGS_H_ */
+
+/* [] END OF FILE */
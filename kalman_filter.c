@@ -0,0 +1,212 @@
+/******************************************************************************
+* File Name: kalman_filter.c
+*
+* Description: This file contains the per-sensor scalar Kalman estimator
+*              of the raw counts, in fixed point, with touch-aware process
+*              noise.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "kalman_filter.h"
+#include "timestamp.h"
+
+#if KALMAN_FILTER_EN
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Fraction bits of the gain */
+#define KALMAN_GAIN_SHIFT        (12u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Per-sensor state. The estimate is in 1/256 counts and its variance in
+ * 1/256 counts squared.
+ */
+typedef struct
+{
+    int32_t x_q8;
+    uint32_t p_q8;
+    int8_t outside;
+    uint8_t touched;
+    uint8_t primed;
+} kalman_state_t;
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+kalman_filter_stats_t kalman_filter_stats;
+
+static kalman_state_t kalman_state[CY_CAPSENSE_SENSOR_COUNT];
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static uint32_t kalman_filter_sample(kalman_state_t *state, uint32_t raw, uint32_t touched);
+
+/*******************************************************************************
+* Function Name: kalman_filter_run
+********************************************************************************
+* Summary:
+*  Replaces the raw count of every sensor with its Kalman estimate. Must be
+*  called before Cy_CapSense_ProcessAllWidgets(); the touch status it reads
+*  is that of the previous frame.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void kalman_filter_run(void)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    cy_stc_capsense_sensor_context_t *sns_ctx;
+    uint32_t start = timestamp_get_cycles();
+    uint32_t cycles;
+    uint32_t sns_index = 0u;
+    uint32_t wd;
+    uint32_t sns;
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+
+        for (sns = 0u; sns < wd_cfg->numSns; sns++)
+        {
+            sns_ctx = &wd_cfg->ptrSnsContext[sns];
+            sns_ctx->raw = (uint16_t)kalman_filter_sample(&kalman_state[sns_index], sns_ctx->raw,
+                                        sns_ctx->status & CY_CAPSENSE_SNS_TOUCH_STATUS_MASK);
+            sns_index++;
+        }
+    }
+
+    cycles = timestamp_get_cycles() - start;
+    kalman_filter_stats.frames++;
+    kalman_filter_stats.cycles_total += cycles;
+    if (cycles > kalman_filter_stats.cycles_max)
+    {
+        kalman_filter_stats.cycles_max = cycles;
+    }
+}
+
+/*******************************************************************************
+* Function Name: kalman_filter_sample
+********************************************************************************
+* Summary:
+*  Runs one step of the scalar Kalman filter for a constant raw count with
+*  process noise:
+*  - predict: P = P + Q, with the touch process noise while touched
+*  - step: when two samples in a row are outside KALMAN_GATE standard
+*    deviations of the prediction on the same side, or the touch status
+*    changed, P = KALMAN_STEP_VAR. A single sample outside is noise.
+*  - update: K = P / (P + R), x = x + K * (raw - x), P = (1 - K) * P
+*  Without touch the gain settles at a small value and the output is a long
+*  average; a touch onset or release opens the gain for a few frames, so the
+*  estimate does not lag the finger like a long IIR would.
+*
+* Parameters:
+*  state - sensor state
+*  raw - raw count
+*  touched - nonzero while the sensor reported a touch in the previous frame
+*
+* Return:
+*  uint32_t - estimated raw count
+*
+*******************************************************************************/
+static uint32_t kalman_filter_sample(kalman_state_t *state, uint32_t raw, uint32_t touched)
+{
+    int32_t innov_q8;
+    uint32_t abs_q4;
+    uint32_t gain;
+    uint32_t p_q8;
+    int8_t sign = 0;
+    uint8_t touch = (0u != touched) ? 1u : 0u;
+
+    if (0u == state->primed)
+    {
+        state->x_q8 = (int32_t)(raw << 8u);
+        state->p_q8 = KALMAN_MEAS_VAR << 8u;
+        state->touched = touch;
+        state->primed = 1u;
+        return raw;
+    }
+
+    p_q8 = state->p_q8 + ((0u != touch) ? KALMAN_TOUCH_PROC_VAR_Q8 : KALMAN_PROC_VAR_Q8);
+
+    /* innov^2 > GATE^2 * (P + R), both sides in 1/256 counts squared. The
+     * square of a 16-bit innovation needs 64 bits.
+     */
+    innov_q8 = (int32_t)(raw << 8u) - state->x_q8;
+    abs_q4 = (uint32_t)((innov_q8 < 0) ? -innov_q8 : innov_q8) >> 4u;
+    if (((uint64_t)abs_q4 * abs_q4) > (KALMAN_GATE * KALMAN_GATE * (p_q8 + (KALMAN_MEAS_VAR << 8u))))
+    {
+        sign = (innov_q8 > 0) ? 1 : -1;
+    }
+
+    if (((0 != sign) && (sign == state->outside)) || (touch != state->touched))
+    {
+        if (p_q8 < (KALMAN_STEP_VAR << 8u))
+        {
+            p_q8 = KALMAN_STEP_VAR << 8u;
+        }
+        state->touched = touch;
+        sign = 0;
+        kalman_filter_stats.steps++;
+    }
+    state->outside = sign;
+
+    /* Bound P so the gain and variance arithmetic stays in 32 bits */
+    if (p_q8 > (KALMAN_STEP_VAR << 8u))
+    {
+        p_q8 = KALMAN_STEP_VAR << 8u;
+    }
+
+    gain = (p_q8 << KALMAN_GAIN_SHIFT) / (p_q8 + (KALMAN_MEAS_VAR << 8u));
+    state->x_q8 += (int32_t)(((int64_t)innov_q8 * (int32_t)gain) / (int32_t)(1u << KALMAN_GAIN_SHIFT));
+    state->p_q8 = (((1u << KALMAN_GAIN_SHIFT) - gain) * p_q8) >> KALMAN_GAIN_SHIFT;
+
+    return (uint32_t)((state->x_q8 + 128) >> 8u);
+}
+
+#endif /* KALMAN_FILTER_EN */
+
+/* [] END OF FILE */
@@ -0,0 +1,115 @@
+/******************************************************************************
+* File Name: kalman_filter.h
+*
+* Description: This file contains the macros, data types and function
+*              prototypes of the per-sensor Kalman raw count estimator.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef KALMAN_FILTER_H_
+#define KALMAN_FILTER_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include "cy_pdl.h"
+#include "cycfg_capsense.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Enables the scalar Kalman estimator on the raw counts */
+#define KALMAN_FILTER_EN                 (0u)
+
+/* Variance of the raw count noise without touch, in counts squared. Measure
+ * it at the scan resolution in use; the default is 3 counts RMS.
+ */
+#define KALMAN_MEAS_VAR                  (9u)
+
+/* Process noise variance per frame, in 1/256 counts squared. Sets how fast
+ * the estimate follows slow changes without touch, and with it the noise
+ * reduction and the lag: 16 gives a gain of about 0.08.
+ */
+#define KALMAN_PROC_VAR_Q8               (16u)
+
+/* Process noise variance per frame while the sensor is touched, in 1/256
+ * counts squared, so the estimate follows the finger and its release
+ */
+#define KALMAN_TOUCH_PROC_VAR_Q8         (256u)
+
+/* Two samples in a row further than this many standard deviations of the
+ * prediction from the estimate, on the same side, are a step such as a
+ * touch onset
+ */
+#define KALMAN_GATE                      (3u)
+
+/* Variance of the estimate after a step or a touch status change, in counts
+ * squared. The next samples then pass almost unfiltered.
+ */
+#define KALMAN_STEP_VAR                  (255u)
+
+#if KALMAN_FILTER_EN
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Processing time in CPU cycles, and the number of steps detected by the
+ * gate or by a touch status change
+ */
+typedef struct
+{
+    uint32_t frames;
+    uint32_t cycles_total;
+    uint32_t cycles_max;
+    uint32_t steps;
+} kalman_filter_stats_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern kalman_filter_stats_t kalman_filter_stats;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void kalman_filter_run(void);
+
+#endif /* KALMAN_FILTER_EN */
+
+#endif /* KALMAN_FILTER_H_ */
+
+/* [] END OF FILE */
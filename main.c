@@ -49,6 +49,32 @@
 #include "cybsp.h"
 #include "cycfg.h"
 #include "cycfg_capsense.h"
+#include "timestamp.h"
+#include "profiles.h"
+#include "host_regs.h"
+#include "burst.h"
+#include "noise_filter.h"
+#include "common_mode.h"
+#include "touch_history.h"
+#include "scan_slot.h"
+#include "rtos_tasks.h"
+#include "trace.h"
+#include "health.h"
+#include "startup.h"
+#include "flash_log.h"
+#include "param_batch.h"
+#include "histogram.h"
+#include "glitch_filter.h"
+#include "bench.h"
+#include "autotune.h"
+#include "cp_estimate.h"
+#include "kalman_filter.h"
+
+#if RTOS_EN
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#endif
 
 /*******************************************************************************
 * Macros
@@ -68,6 +94,25 @@
 /* No touch */
 #define NO_BUTTON_TOUCH           (0u)
 
+/* Frames scanned per host query unless the host configures another count */
+#define ON_DEMAND_DEFAULT_FRAMES  (1u)
+
+#if ON_DEMAND_SCAN_EN && BURST_SCAN_EN
+#error "ON_DEMAND_SCAN_EN and BURST_SCAN_EN are mutually exclusive"
+#endif
+
+#if SCAN_SLOT_EN && (ON_DEMAND_SCAN_EN || BURST_SCAN_EN)
+#error "SCAN_SLOT_EN requires the free-running scan loop"
+#endif
+
+#if RTOS_EN && (ON_DEMAND_SCAN_EN || BURST_SCAN_EN || SCAN_SLOT_EN)
+#error "RTOS_EN replaces the free-running scan loop and cannot be combined with other scan modes"
+#endif
+
+#if BENCH_EN && (ON_DEMAND_SCAN_EN || BURST_SCAN_EN || SCAN_SLOT_EN || RTOS_EN)
+#error "BENCH_EN replaces scanning and cannot be combined with other scan modes"
+#endif
+
 /*******************************************************************************
 * Global Definitions
 *******************************************************************************/
@@ -96,6 +141,85 @@ uint32_t button_0_sensor_cp = 0, button_1_sensor_cp = 0;
 cy_en_capsense_bist_status_t cp_0_status, cp_1_status;
 #endif /* CY_CAPSENSE_BIST_EN */
 
+/* Number of frames processed since start-up */
+static uint32_t frame_count = 0u;
+
+#if HOST_REGS_EN
+/* Device time at the end of the last scan, latched by the CapSense ISR */
+static volatile uint32_t scan_end_us = 0u;
+#endif
+
+#if AUTOTUNE_EN
+/* Window command, completed when the window ends */
+static host_mailbox_t tune_cmd;
+#endif
+
+#if LOOP_STATS_EN
+loop_stats_t loop_stats;
+
+/* CPU cycle count at the end of the last scan, latched by the CapSense ISR */
+static volatile uint32_t scan_end_cycles = 0u;
+#endif
+
+#if RTOS_EN
+/* Counted by the kernel trace hook in FreeRTOSConfig.h */
+volatile uint32_t rtos_switch_count = 0u;
+
+/* Statically allocated tasks */
+static TaskHandle_t sensing_task_handle = NULL;
+static TaskHandle_t tuner_task_handle = NULL;
+static StaticTask_t sensing_task_tcb;
+static StaticTask_t tuner_task_tcb;
+static StaticTask_t idle_task_tcb;
+static StackType_t sensing_task_stack[RTOS_SENSING_STACK_SIZE];
+static StackType_t tuner_task_stack[RTOS_TUNER_STACK_SIZE];
+static StackType_t idle_task_stack[configMINIMAL_STACK_SIZE];
+
+#if CY_CAPSENSE_BIST_EN
+static StaticTask_t diag_task_tcb;
+static StackType_t diag_task_stack[RTOS_DIAG_STACK_SIZE];
+#endif
+
+/* Held while the CSD block or the CapSense context is in use */
+static SemaphoreHandle_t capsense_mutex;
+static StaticSemaphore_t capsense_mutex_buffer;
+#endif /* RTOS_EN */
+
+#if ON_DEMAND_SCAN_EN
+/* Deep Sleep callback parameters and structures for EZI2C and CapSense */
+static cy_stc_syspm_callback_params_t ezi2c_ds_params =
+{
+    .base = CYBSP_EZI2C_HW,
+    .context = &ezi2c_context,
+};
+
+static cy_stc_syspm_callback_t ezi2c_ds_callback =
+{
+    .callback = &Cy_SCB_EZI2C_DeepSleepCallback,
+    .type = CY_SYSPM_DEEPSLEEP,
+    .skipMode = 0u,
+    .callbackParams = &ezi2c_ds_params,
+    .prevItm = NULL,
+    .nextItm = NULL,
+};
+
+static cy_stc_syspm_callback_params_t capsense_ds_params =
+{
+    .base = CYBSP_CSD_HW,
+    .context = &cy_capsense_context,
+};
+
+static cy_stc_syspm_callback_t capsense_ds_callback =
+{
+    .callback = &Cy_CapSense_DeepSleepCallback,
+    .type = CY_SYSPM_DEEPSLEEP,
+    .skipMode = 0u,
+    .callbackParams = &capsense_ds_params,
+    .prevItm = NULL,
+    .nextItm = NULL,
+};
+#endif /* ON_DEMAND_SCAN_EN */
+
 /*******************************************************************************
 * Function Prototypes
 *******************************************************************************/
@@ -105,10 +229,48 @@ static void capsense_isr(void);
 /* EZI2C ISR function */
 static void ezi2c_isr(void);
 
+/* Processes the scanned frame and drives the LEDs */
+static void process_touch(void);
+
+/* Services the tuner, BIST and profiles between frames */
+static void finish_frame(void);
+
+/* Takes host commands and applies a pending profile switch */
+static void apply_host_requests(void);
+
+#if HOST_REGS_EN
+static void handle_command(const host_mailbox_t *cmd);
+#endif /* HOST_REGS_EN */
+
+#if LOOP_STATS_EN
+static void loop_stats_add(uint32_t frame_start);
+#endif /* LOOP_STATS_EN */
+
 #if CY_CAPSENSE_BIST_EN
 static void measure_sensor_cp(void);
 #endif /* CY_CAPSENSE_BIST_EN */
 
+#if ON_DEMAND_SCAN_EN
+static void run_on_demand_scan(void);
+#endif /* ON_DEMAND_SCAN_EN */
+
+#if BURST_SCAN_EN
+static void run_burst_scan(void);
+#endif /* BURST_SCAN_EN */
+
+#if BENCH_EN
+static void run_bench(void);
+#endif /* BENCH_EN */
+
+#if RTOS_EN
+static void run_rtos(void);
+static void sensing_task(void *arg);
+static void tuner_task(void *arg);
+#if CY_CAPSENSE_BIST_EN
+static void diag_task(void *arg);
+#endif /* CY_CAPSENSE_BIST_EN */
+#endif /* RTOS_EN */
+
 #if DEBUG_PRINT
 /* Structure for UART context */
 cy_stc_scb_uart_context_t CYBSP_UART_context;
@@ -178,6 +340,11 @@ int main(void)
     /* SysInt status variable */
     cy_en_sysint_status_t intr_result;
 
+#if LOOP_STATS_EN
+    /* Start of the frame work, for the loop statistics */
+    uint32_t frame_start;
+#endif
+
     /* Initialize the device and board peripherals */
     result = cybsp_init();
 
@@ -187,6 +354,14 @@ int main(void)
         CY_ASSERT(CY_ASSERT_FAILED);
     }
 
+#if PROFILES_EN || HOST_REGS_EN || BURST_SCAN_EN || NOISE_FILTER_EN || RTOS_EN || LOOP_STATS_EN || HEALTH_EN || \
+    STARTUP_EN || FLASH_LOG_EN || BENCH_EN || KALMAN_FILTER_EN
+    /* Start the free-running timestamp used for latency measurement and frame
+     * time stamps
+     */
+    timestamp_init();
+#endif
+
 #if DEBUG_PRINT
     /* Configure and enable the UART peripheral */
     Cy_SCB_UART_Init(CYBSP_UART_HW, &CYBSP_UART_config, &CYBSP_UART_context);
@@ -228,6 +403,50 @@ int main(void)
     /* Enable EZI2C interrupt */
     NVIC_EnableIRQ(ezi2c_intr_config.intrSrc);
 
+#if HOST_REGS_EN
+    /* Expose the application register map instead of the CapSense data
+     * structure. Only the mailbox at the start of the map is writable.
+     */
+    host_regs_init();
+#if TOUCH_HISTORY_EN
+    touch_history_init(&host_regs.history);
+#endif
+#if TRACE_EN
+    trace_init(&host_regs.trace);
+#endif
+#if HEALTH_EN
+    health_init(&host_regs.health);
+#endif
+#if HISTOGRAM_EN
+    histogram_init(&host_regs.histogram);
+#endif
+#if BENCH_EN
+    bench_init(&host_regs.bench);
+#endif
+#if AUTOTUNE_EN
+    autotune_init(&host_regs.autotune);
+#endif
+#if HOST_REGS_SECOND_ADDR_EN
+    /* The register map goes on the secondary address and the Tuner keeps the
+     * CapSense data structure on the primary one, so both can be connected
+     */
+    if (CY_SCB_EZI2C_TWO_ADDRESSES != CYBSP_EZI2C_config.numberOfAddresses)
+    {
+        /* Set Number of addresses to two in design.modus */
+        CY_ASSERT(CY_ASSERT_FAILED);
+    }
+    Cy_SCB_EZI2C_SetBuffer2(CYBSP_EZI2C_HW, (uint8_t *)&host_regs,
+                            sizeof(host_regs), sizeof(host_mailbox_t),
+                            &ezi2c_context);
+    Cy_SCB_EZI2C_SetBuffer1(CYBSP_EZI2C_HW, (uint8_t *)&cy_capsense_tuner,
+                            sizeof(cy_capsense_tuner), sizeof(cy_capsense_tuner),
+                            &ezi2c_context);
+#else
+    Cy_SCB_EZI2C_SetBuffer1(CYBSP_EZI2C_HW, (uint8_t *)&host_regs,
+                            sizeof(host_regs), sizeof(host_mailbox_t),
+                            &ezi2c_context);
+#endif /* HOST_REGS_SECOND_ADDR_EN */
+#else
     /* Set the CapSense data structure as the I2C buffer to be exposed to the
      * master on primary slave address interface. Any I2C host tools such as
      * the Tuner or the Bridge Control Panel can read this buffer but you can
@@ -236,6 +455,7 @@ int main(void)
     Cy_SCB_EZI2C_SetBuffer1(CYBSP_EZI2C_HW, (uint8_t *)&cy_capsense_tuner,
                             sizeof(cy_capsense_tuner), sizeof(cy_capsense_tuner),
                             &ezi2c_context);
+#endif /* HOST_REGS_EN */
 
     /* Enables the SCB block for the EZI2C operation. */
     Cy_SCB_EZI2C_Enable(CYBSP_EZI2C_HW);
@@ -279,7 +499,70 @@ int main(void)
         CY_ASSERT(CY_ASSERT_FAILED);
     }
 
+#if PROFILES_EN
+    /* Load the precomputed profiles, calibrating them at first boot */
+    cap_result = profiles_init();
+
+    if (cap_result != CY_CAPSENSE_STATUS_SUCCESS)
+    {
+#if DEBUG_PRINT
+        check_status("API profiles_init failed with error code", cap_result);
+#endif
+        CY_ASSERT(CY_ASSERT_FAILED);
+    }
+#endif /* PROFILES_EN */
+
+#if STARTUP_EN
+    /* Seed the baselines from a burst of scans instead of a single one */
+    cap_result = startup_run();
+
+    if (cap_result != CY_CAPSENSE_STATUS_SUCCESS)
+    {
+#if DEBUG_PRINT
+        check_status("API startup_run failed with error code", cap_result);
+#endif
+        CY_ASSERT(CY_ASSERT_FAILED);
+    }
+#endif /* STARTUP_EN */
+
+#if FLASH_LOG_EN
+    /* Find the write position of the event log */
+    flash_log_init();
+#endif
+
+#if BENCH_EN
+    /* Synthetic frames instead of scans, this function does not return */
+    run_bench();
+#endif /* BENCH_EN */
+
+#if ON_DEMAND_SCAN_EN
+    /* EZI2C wakes the device from Deep Sleep on address match */
+    Cy_SysPm_RegisterCallback(&ezi2c_ds_callback);
+    Cy_SysPm_RegisterCallback(&capsense_ds_callback);
+
+    /* Scans are started by the host, this function does not return */
+    run_on_demand_scan();
+#endif /* ON_DEMAND_SCAN_EN */
+
+#if BURST_SCAN_EN
+    /* Periodic bursts of averaged scans, this function does not return */
+    run_burst_scan();
+#endif /* BURST_SCAN_EN */
+
+#if RTOS_EN
+    /* Sensing, tuner and diagnostics tasks, this function does not return */
+    run_rtos();
+#endif /* RTOS_EN */
+
+#if SCAN_SLOT_EN
+    /* Scans start only in the slot of this board */
+    scan_slot_init();
+    scan_slot_wait();
+#endif /* SCAN_SLOT_EN */
+
     /* Start the first scan */
+    TRACE_EVENT(TRACE_EVT_SCAN_START);
+    HEALTH_FRAME_START();
     cap_result = Cy_CapSense_ScanAllWidgets(&cy_capsense_context);
 
     if (cap_result != CY_CAPSENSE_STATUS_SUCCESS)
@@ -294,38 +577,27 @@ int main(void)
     {
         if(CY_CAPSENSE_BUSY != Cy_CapSense_IsBusy(&cy_capsense_context))
         {
-            /* Process all widgets */
-            Cy_CapSense_ProcessAllWidgets(&cy_capsense_context);
+#if LOOP_STATS_EN
+            frame_start = timestamp_get_cycles();
+#endif
 
-            /* Turning Button0 ON/OFF based on button press */
-            if(NO_BUTTON_TOUCH != Cy_CapSense_IsWidgetActive(CY_CAPSENSE_BUTTON0_WDGT_ID, &cy_capsense_context))
-            {
-                Cy_GPIO_Write(CYBSP_LED_BTN0_PORT, CYBSP_LED_BTN0_NUM, CYBSP_LED_STATE_ON);
-            }
-            else
-            {
-                Cy_GPIO_Write(CYBSP_LED_BTN0_PORT, CYBSP_LED_BTN0_NUM, CYBSP_LED_STATE_OFF);
-            }
+            /* Process all widgets and update the LEDs */
+            process_touch();
 
-            /* Turning Button1 ON/OFF based on button press */
-            if(NO_BUTTON_TOUCH != Cy_CapSense_IsWidgetActive(CY_CAPSENSE_BUTTON1_WDGT_ID, &cy_capsense_context))
-            {
-                Cy_GPIO_Write(CYBSP_LED_BTN1_PORT, CYBSP_LED_BTN1_NUM, CYBSP_LED_STATE_ON);
-            }
-            else
-            {
-                Cy_GPIO_Write(CYBSP_LED_BTN1_PORT, CYBSP_LED_BTN1_NUM, CYBSP_LED_STATE_OFF);
-            }
+            /* Tuner, BIST and profile switch before the next scan */
+            finish_frame();
 
-            /* Establishes synchronized communication with the CapSense Tuner tool */
-            Cy_CapSense_RunTuner(&cy_capsense_context);
+#if LOOP_STATS_EN
+            loop_stats_add(frame_start);
+#endif
 
-#if CY_CAPSENSE_BIST_EN
-            /* Measure the self capacitance of sensor electrode using BIST */
-            measure_sensor_cp();
-#endif /* CY_CAPSENSE_BIST_EN */
+#if SCAN_SLOT_EN
+            scan_slot_wait();
+#endif
 
             /* Start the next scan */
+            TRACE_EVENT(TRACE_EVT_SCAN_START);
+            HEALTH_FRAME_START();
             Cy_CapSense_ScanAllWidgets(&cy_capsense_context);
         }
 
@@ -340,28 +612,111 @@ int main(void)
 }
 
 /*******************************************************************************
-* Function Name: capsense_isr
+* Function Name: process_touch
 ********************************************************************************
 * Summary:
-*  Wrapper function for handling interrupts from CapSense block.
+*  Filters the raw counts of the scanned frame, processes all widgets and
+*  turns the LEDs ON/OFF based on the button status.
 *
 * Parameters:
-*   void
+*  void
 *
 * Return:
 *  void
 *
 *******************************************************************************/
-static void capsense_isr(void)
+static void process_touch(void)
 {
-    Cy_CapSense_InterruptHandler(CYBSP_CSD_HW, &cy_capsense_context);
+    TRACE_EVENT(TRACE_EVT_PROCESS_BEGIN);
+
+#if GLITCH_FILTER_EN
+    /* Replace single-frame outliers before any other stage sees them */
+    glitch_filter_run();
+#endif
+
+#if COMMON_MODE_EN
+    /* Remove the noise shared by all sensors that are not touched */
+    common_mode_run();
+#endif
+
+#if NOISE_FILTER_EN
+    /* Classify the noise and filter the raw counts where needed */
+    noise_filter_run();
+#endif
+
+#if KALMAN_FILTER_EN
+    /* Estimate the raw counts, long averaging without touch */
+    kalman_filter_run();
+#endif
+
+    BENCH_MARK(BENCH_STAGE_FILTER);
+
+#if STARTUP_EN
+    /* Ramp the raised startup thresholds down to the normal ones */
+    startup_update();
+#endif
+
+    /* Process all widgets */
+    Cy_CapSense_ProcessAllWidgets(&cy_capsense_context);
+    frame_count++;
+
+    BENCH_MARK(BENCH_STAGE_PROCESS);
+
+#if TOUCH_HISTORY_EN
+    touch_history_update(frame_count);
+#endif
+
+#if HEALTH_EN
+    health_update(frame_count, timestamp_get_us());
+#endif
+
+#if FLASH_LOG_EN
+    flash_log_update();
+#endif
+
+#if HISTOGRAM_EN
+    histogram_update(frame_count);
+#endif
+
+#if AUTOTUNE_EN
+    if (autotune_update())
+    {
+        host_regs_set_status(&tune_cmd, HOST_CMD_STATUS_DONE);
+    }
+#endif
+
+    /* Turning Button0 ON/OFF based on button press */
+    if(NO_BUTTON_TOUCH != Cy_CapSense_IsWidgetActive(CY_CAPSENSE_BUTTON0_WDGT_ID, &cy_capsense_context))
+    {
+        Cy_GPIO_Write(CYBSP_LED_BTN0_PORT, CYBSP_LED_BTN0_NUM, CYBSP_LED_STATE_ON);
+    }
+    else
+    {
+        Cy_GPIO_Write(CYBSP_LED_BTN0_PORT, CYBSP_LED_BTN0_NUM, CYBSP_LED_STATE_OFF);
+    }
+
+    /* Turning Button1 ON/OFF based on button press */
+    if(NO_BUTTON_TOUCH != Cy_CapSense_IsWidgetActive(CY_CAPSENSE_BUTTON1_WDGT_ID, &cy_capsense_context))
+    {
+        Cy_GPIO_Write(CYBSP_LED_BTN1_PORT, CYBSP_LED_BTN1_NUM, CYBSP_LED_STATE_ON);
+    }
+    else
+    {
+        Cy_GPIO_Write(CYBSP_LED_BTN1_PORT, CYBSP_LED_BTN1_NUM, CYBSP_LED_STATE_OFF);
+    }
+
+    BENCH_MARK(BENCH_STAGE_TELEMETRY);
+
+    TRACE_EVENT(TRACE_EVT_PROCESS_END);
 }
 
 /*******************************************************************************
-* Function Name: ezi2c_isr
+* Function Name: finish_frame
 ********************************************************************************
 * Summary:
-*  Wrapper function for handling interrupts from EZI2C block.
+*  Publishes the processed frame, services the CapSense Tuner, measures the
+*  sensor Cp, takes host commands and applies a pending profile switch. Runs
+*  between the end of processing and the start of the next scan.
 *
 * Parameters:
 *  void
@@ -370,20 +725,36 @@ static void capsense_isr(void)
 *  void
 *
 *******************************************************************************/
-static void ezi2c_isr(void)
+static void finish_frame(void)
 {
-    Cy_SCB_EZI2C_Interrupt(CYBSP_EZI2C_HW, &ezi2c_context);
-}
+#if HOST_REGS_EN
+    host_regs_publish_frame(frame_count, scan_end_us);
+#endif
+
+    /* Establishes synchronized communication with the CapSense Tuner tool */
+    TRACE_EVENT(TRACE_EVT_TUNER_BEGIN);
+    Cy_CapSense_RunTuner(&cy_capsense_context);
+    TRACE_EVENT(TRACE_EVT_TUNER_END);
 
 #if CY_CAPSENSE_BIST_EN
+    /* Measure the self capacitance of sensor electrode using BIST */
+    measure_sensor_cp();
+#endif /* CY_CAPSENSE_BIST_EN */
+
+    apply_host_requests();
+
+#if FLASH_LOG_EN
+    /* Write a batch of log records if the loop has slack */
+    flash_log_service();
+#endif
+}
 
 /*******************************************************************************
-* Function Name: measure_sensor_cp
+* Function Name: apply_host_requests
 ********************************************************************************
 * Summary:
-*  Measures the self capacitance of the sensor electrode (Cp) in Femto Farad and
-*  stores its value in the variable button_0_sensor_cp for Button 0 and button_1_sensor_cp for
-*  Button 1.
+*  Takes host commands and applies a pending profile switch at the frame
+*  boundary, before the next scan.
 *
 * Parameters:
 *  void
@@ -392,18 +763,819 @@ static void ezi2c_isr(void)
 *  void
 *
 *******************************************************************************/
-static void measure_sensor_cp(void)
+static void apply_host_requests(void)
 {
-    /* Measure the self capacitance of sensor electrode for Button 0 Widget */
-    cp_0_status = Cy_CapSense_MeasureCapacitanceSensor(CY_CAPSENSE_BUTTON0_WDGT_ID,
-                                                  CY_CAPSENSE_BUTTON0_SNS0_ID,
-                                             &button_0_sensor_cp, &cy_capsense_context);
+#if HOST_REGS_EN
+    host_mailbox_t cmd;
 
+    if (host_regs_fetch_command(&cmd))
+    {
+        handle_command(&cmd);
+    }
+#endif
 
-    /* Measure the self capacitance of sensor electrode for Button 1 Widget */
-    cp_1_status = Cy_CapSense_MeasureCapacitanceSensor(CY_CAPSENSE_BUTTON1_WDGT_ID,
-                                                  CY_CAPSENSE_BUTTON1_SNS0_ID,
-                                             &button_1_sensor_cp, &cy_capsense_context);
+#if PROFILES_EN
+    /* Switch profile at the frame boundary, before the next scan */
+    profiles_apply_pending(frame_count);
+#endif
+}
+
+#if HOST_REGS_EN
+/*******************************************************************************
+* Function Name: handle_command
+********************************************************************************
+* Summary:
+*  Executes a mailbox command that does not depend on the scan loop and
+*  reports its status.
+*
+* Parameters:
+*  cmd - command taken from the mailbox
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void handle_command(const host_mailbox_t *cmd)
+{
+    uint8_t status = HOST_CMD_STATUS_ERROR;
+    uint8_t detail = 0u;
+
+    switch (cmd->cmd)
+    {
+#if PROFILES_EN
+        case HOST_CMD_SELECT_PROFILE:
+            if (cmd->payload[0] < (uint8_t)PROFILE_COUNT)
+            {
+                profiles_request((profile_id_t)cmd->payload[0], frame_count);
+#if FLASH_LOG_EN
+                flash_log_add(FLASH_LOG_PROFILE, cmd->payload[0], 0u);
+#endif
+                status = HOST_CMD_STATUS_DONE;
+            }
+            break;
+#endif /* PROFILES_EN */
+
+#if TRACE_EN
+        case HOST_CMD_TRACE_FREEZE:
+            trace_freeze(0u != cmd->payload[0]);
+            status = HOST_CMD_STATUS_DONE;
+            break;
+#endif /* TRACE_EN */
+
+#if HEALTH_EN
+        case HOST_CMD_HEALTH_CLEAR:
+            health_clear();
+            status = HOST_CMD_STATUS_DONE;
+            break;
+#endif /* HEALTH_EN */
+
+#if PARAM_BATCH_EN
+        case HOST_CMD_SET_PARAMS:
+            if (param_batch_apply(cmd->payload, cmd->len, &detail))
+            {
+                status = HOST_CMD_STATUS_DONE;
+            }
+            break;
+#endif /* PARAM_BATCH_EN */
+
+#if HISTOGRAM_EN
+        case HOST_CMD_HISTOGRAM_CLEAR:
+            histogram_clear();
+            status = HOST_CMD_STATUS_DONE;
+            break;
+#endif /* HISTOGRAM_EN */
+
+#if BENCH_EN
+        case HOST_CMD_BENCH_SENSORS:
+            if (bench_set_sensors((uint32_t)cmd->payload[0] | ((uint32_t)cmd->payload[1] << 8u)))
+            {
+                status = HOST_CMD_STATUS_DONE;
+            }
+            break;
+#endif /* BENCH_EN */
+
+#if AUTOTUNE_EN
+        case HOST_CMD_TUNE_WINDOW:
+            if (autotune_start(cmd->payload[0]))
+            {
+                /* Completed by process_touch() at the end of the window */
+                tune_cmd = *cmd;
+                status = HOST_CMD_STATUS_BUSY;
+            }
+            break;
+
+        case HOST_CMD_TUNE_APPLY:
+            if (autotune_apply(&detail))
+            {
+                status = HOST_CMD_STATUS_DONE;
+            }
+            break;
+#endif /* AUTOTUNE_EN */
+
+#if SCAN_SLOT_EN
+        case HOST_CMD_SET_SLOT:
+            if (scan_slot_configure(cmd->payload[0], cmd->payload[1]))
+            {
+                status = HOST_CMD_STATUS_DONE;
+            }
+            break;
+
+        case HOST_CMD_SLOT_SYNC:
+            scan_slot_sync((uint32_t)cmd->payload[0] | ((uint32_t)cmd->payload[1] << 8u) |
+                           ((uint32_t)cmd->payload[2] << 16u) | ((uint32_t)cmd->payload[3] << 24u),
+                           (uint16_t)((uint32_t)cmd->payload[4] | ((uint32_t)cmd->payload[5] << 8u)));
+            status = HOST_CMD_STATUS_DONE;
+            break;
+#endif /* SCAN_SLOT_EN */
+
+        default:
+            break;
+    }
+
+    host_regs_set_status(cmd, status);
+    host_regs.status.detail = detail;
+}
+#endif /* HOST_REGS_EN */
+
+#if LOOP_STATS_EN
+/*******************************************************************************
+* Function Name: loop_stats_add
+********************************************************************************
+* Summary:
+*  Adds the timing of the finished frame to the loop statistics.
+*
+* Parameters:
+*  frame_start - CPU cycle count when the processing of the frame started
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void loop_stats_add(uint32_t frame_start)
+{
+    uint32_t wake = frame_start - scan_end_cycles;
+    uint32_t busy = timestamp_get_cycles() - frame_start;
+
+    loop_stats.frames++;
+    loop_stats.wake_cycles_sum += wake;
+    loop_stats.busy_cycles_sum += busy;
+
+    if (wake > loop_stats.wake_cycles_max)
+    {
+        loop_stats.wake_cycles_max = wake;
+    }
+    if (busy > loop_stats.busy_cycles_max)
+    {
+        loop_stats.busy_cycles_max = busy;
+    }
+
+#if RTOS_EN
+    loop_stats.switches = rtos_switch_count;
+#endif
+}
+#endif /* LOOP_STATS_EN */
+
+#if ON_DEMAND_SCAN_EN
+/*******************************************************************************
+* Function Name: run_on_demand_scan
+********************************************************************************
+* Summary:
+*  Scan loop of the on-demand mode. The device stays in Deep Sleep until the
+*  host writes a command into the mailbox, or in Sleep if the EZI2C wakeup is
+*  not enabled in the design. A scan command scans the requested
+*  number of frames with the CPU in Sleep, publishes the last frame and reports
+*  the command as done. The device stays in Sleep until the host has read the
+*  results and then returns to Deep Sleep.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void run_on_demand_scan(void)
+{
+    host_mailbox_t cmd;
+    host_mailbox_t scan_cmd = {0u};
+    uint32_t frames_per_query = ON_DEMAND_DEFAULT_FRAMES;
+    uint32_t frames_left = 0u;
+    uint32_t active_start = timestamp_get_us();
+    uint32_t sleep_start;
+    uint32_t intr_state;
+    bool scanning = false;
+    bool result_unread = false;
+
+    for (;;)
+    {
+        /* A read after publishing means the host has the results */
+        if ((0u != (host_regs_take_events() & HOST_REGS_STATUS_READ)) && !scanning)
+        {
+            result_unread = false;
+        }
+
+        if (host_regs_fetch_command(&cmd))
+        {
+            switch (cmd.cmd)
+            {
+                case HOST_CMD_SCAN:
+                    frames_left += (0u != cmd.payload[0]) ? cmd.payload[0] : frames_per_query;
+                    host_regs.scan_stats.queries++;
+                    scan_cmd = cmd;
+                    break;
+
+                case HOST_CMD_SET_SCAN_COUNT:
+                    if (0u != cmd.payload[0])
+                    {
+                        frames_per_query = cmd.payload[0];
+                        host_regs_set_status(&cmd, HOST_CMD_STATUS_DONE);
+                    }
+                    else
+                    {
+                        host_regs_set_status(&cmd, HOST_CMD_STATUS_ERROR);
+                    }
+                    break;
+
+                default:
+                    handle_command(&cmd);
+                    break;
+            }
+        }
+
+        if (scanning)
+        {
+            if (CY_CAPSENSE_BUSY != Cy_CapSense_IsBusy(&cy_capsense_context))
+            {
+                process_touch();
+                host_regs.scan_stats.frames++;
+                frames_left--;
+                scanning = false;
+
+                if (0u == frames_left)
+                {
+                    host_regs_publish_frame(frame_count, scan_end_us);
+                    host_regs_set_status(&scan_cmd, HOST_CMD_STATUS_DONE);
+
+                    /* Reads that started before publishing do not count */
+                    (void)host_regs_take_events();
+                    result_unread = true;
+                }
+            }
+        }
+
+        if ((!scanning) && (0u != frames_left))
+        {
+#if PROFILES_EN
+            profiles_apply_pending(frame_count);
+#endif
+            TRACE_EVENT(TRACE_EVT_SCAN_START);
+            HEALTH_FRAME_START();
+            Cy_CapSense_ScanAllWidgets(&cy_capsense_context);
+            scanning = true;
+        }
+
+#if FLASH_LOG_EN
+        if (!scanning)
+        {
+            flash_log_service();
+        }
+#endif
+
+        /* Waiting for the host does not count against the frame budget */
+        if (!scanning)
+        {
+            HEALTH_FRAME_IDLE();
+        }
+
+        sleep_start = timestamp_get_us();
+        host_regs.scan_stats.active_us += sleep_start - active_start;
+
+        /* Sleep unless an interrupt already brought new work */
+        intr_state = Cy_SysLib_EnterCriticalSection();
+        if (HOST_CMD_NONE == host_regs.mailbox.cmd)
+        {
+            if (scanning)
+            {
+                if (CY_CAPSENSE_BUSY == Cy_CapSense_IsBusy(&cy_capsense_context))
+                {
+                    Cy_SysPm_CpuEnterSleep();
+                }
+            }
+            else if (result_unread || (!CYBSP_EZI2C_config.enableWakeFromSleep))
+            {
+                Cy_SysPm_CpuEnterSleep();
+            }
+            else
+            {
+                /* Requires the EZI2C wakeup to be enabled in design.modus */
+                (void)Cy_SysPm_CpuEnterDeepSleep();
+            }
+        }
+        Cy_SysLib_ExitCriticalSection(intr_state);
+
+        /* SysTick does not run in Deep Sleep, so only Sleep time is counted */
+        active_start = timestamp_get_us();
+        host_regs.scan_stats.sleep_us += active_start - sleep_start;
+    }
+}
+#endif /* ON_DEMAND_SCAN_EN */
+
+#if BURST_SCAN_EN
+/*******************************************************************************
+* Function Name: run_burst_scan
+********************************************************************************
+* Summary:
+*  Scan loop of the burst mode. Every BURST_PERIOD_MS the firmware performs
+*  BURST_SIZE back-to-back scans with the CPU in Sleep, averages the raw counts
+*  on the device, processes the frame once, and sleeps for the rest of the
+*  period.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void run_burst_scan(void)
+{
+    uint32_t period_start = timestamp_ms;
+    uint32_t scan_start;
+    uint32_t process_start;
+    uint32_t idle_start;
+    uint32_t intr_state;
+    uint32_t i;
+
+    for (;;)
+    {
+        scan_start = timestamp_get_us();
+        HEALTH_FRAME_START();
+
+        burst_begin();
+
+        for (i = 0u; i < BURST_SIZE; i++)
+        {
+            TRACE_EVENT(TRACE_EVT_SCAN_START);
+            Cy_CapSense_ScanAllWidgets(&cy_capsense_context);
+
+            intr_state = Cy_SysLib_EnterCriticalSection();
+            while (CY_CAPSENSE_BUSY == Cy_CapSense_IsBusy(&cy_capsense_context))
+            {
+                /* The CapSense interrupt wakes the CPU at the end of the scan */
+                Cy_SysPm_CpuEnterSleep();
+                Cy_SysLib_ExitCriticalSection(intr_state);
+                intr_state = Cy_SysLib_EnterCriticalSection();
+            }
+            Cy_SysLib_ExitCriticalSection(intr_state);
+
+            burst_accumulate();
+        }
+
+        process_start = timestamp_get_us();
+        burst_stats.scan_us += process_start - scan_start;
+
+        /* Process the averaged frame once */
+        burst_decimate();
+        process_touch();
+        finish_frame();
+
+        idle_start = timestamp_get_us();
+        burst_stats.process_us += idle_start - process_start;
+
+        if ((timestamp_ms - period_start) >= BURST_PERIOD_MS)
+        {
+            /* The burst did not fit into the period, restart the schedule */
+            burst_stats.overruns++;
+            period_start = timestamp_ms;
+        }
+        else
+        {
+            HEALTH_FRAME_IDLE();
+
+            /* SysTick wakes the CPU every millisecond */
+            while ((timestamp_ms - period_start) < BURST_PERIOD_MS)
+            {
+                Cy_SysPm_CpuEnterSleep();
+            }
+            period_start += BURST_PERIOD_MS;
+        }
+
+        burst_stats.idle_us += timestamp_get_us() - idle_start;
+        burst_stats.periods++;
+    }
+}
+#endif /* BURST_SCAN_EN */
+
+#if BENCH_EN
+/*******************************************************************************
+* Function Name: run_bench
+********************************************************************************
+* Summary:
+*  Loop of the benchmark mode. Each frame writes synthetic raw counts for the
+*  virtual sensors and runs them through filtering, processing and telemetry in
+*  passes over the configured sensors, then services the host once. No scans
+*  are started. The results are published in the register map.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void run_bench(void)
+{
+    uint32_t passes;
+    uint32_t pass;
+
+    for (;;)
+    {
+        passes = bench_begin_frame();
+
+        for (pass = 0u; pass < passes; pass++)
+        {
+            bench_load(pass);
+            process_touch();
+            bench_store(pass);
+        }
+
+        finish_frame();
+        bench_end_frame();
+    }
+}
+#endif /* BENCH_EN */
+
+#if RTOS_EN
+/*******************************************************************************
+* Function Name: run_rtos
+********************************************************************************
+* Summary:
+*  Creates the sensing, tuner and diagnostics tasks and starts the scheduler.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void run_rtos(void)
+{
+    capsense_mutex = xSemaphoreCreateMutexStatic(&capsense_mutex_buffer);
+
+    sensing_task_handle = xTaskCreateStatic(sensing_task, "sensing", RTOS_SENSING_STACK_SIZE,
+                                            NULL, RTOS_SENSING_PRIORITY,
+                                            sensing_task_stack, &sensing_task_tcb);
+    tuner_task_handle = xTaskCreateStatic(tuner_task, "tuner", RTOS_TUNER_STACK_SIZE,
+                                          NULL, RTOS_TUNER_PRIORITY,
+                                          tuner_task_stack, &tuner_task_tcb);
+#if CY_CAPSENSE_BIST_EN
+    (void)xTaskCreateStatic(diag_task, "diag", RTOS_DIAG_STACK_SIZE,
+                            NULL, RTOS_DIAG_PRIORITY,
+                            diag_task_stack, &diag_task_tcb);
+#endif /* CY_CAPSENSE_BIST_EN */
+
+    /* The kernel takes SysTick over from the time stamp counter */
+    timestamp_start_kernel_tick();
+    vTaskStartScheduler();
+
+    /* The scheduler returns only if it could not start */
+    CY_ASSERT(CY_ASSERT_FAILED);
+}
+
+/*******************************************************************************
+* Function Name: sensing_task
+********************************************************************************
+* Summary:
+*  Scans and processes one frame every RTOS_SCAN_PERIOD_MS. The task sleeps
+*  while the scan runs and is woken by the CapSense ISR at its end. The CapSense
+*  mutex is held from the start of the scan to the end of processing, and the
+*  tuner task is woken when it is released.
+*
+* Parameters:
+*  arg - unused
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sensing_task(void *arg)
+{
+    TickType_t last_wake = xTaskGetTickCount();
+#if LOOP_STATS_EN
+    uint32_t frame_start;
+#endif
+
+    (void)arg;
+
+    for (;;)
+    {
+        /* A Tuner or BIST run that holds the mutex past the period counts */
+        HEALTH_FRAME_START();
+        (void)xSemaphoreTake(capsense_mutex, portMAX_DELAY);
+
+        /* Drop notifications left by BIST measurements */
+        (void)ulTaskNotifyTake(pdTRUE, 0u);
+
+        TRACE_EVENT(TRACE_EVT_SCAN_START);
+        Cy_CapSense_ScanAllWidgets(&cy_capsense_context);
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+#if LOOP_STATS_EN
+        frame_start = timestamp_get_cycles();
+#endif
+
+        /* Process all widgets and update the LEDs */
+        process_touch();
+
+#if HOST_REGS_EN
+        host_regs_publish_frame(frame_count, scan_end_us);
+#endif
+        apply_host_requests();
+
+#if FLASH_LOG_EN
+        flash_log_service();
+#endif
+
+#if LOOP_STATS_EN
+        loop_stats_add(frame_start);
+#endif
+
+        (void)xSemaphoreGive(capsense_mutex);
+
+        /* The tuner runs between frames */
+        xTaskNotifyGive(tuner_task_handle);
+
+        HEALTH_FRAME_IDLE();
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(RTOS_SCAN_PERIOD_MS));
+    }
+}
+
+/*******************************************************************************
+* Function Name: tuner_task
+********************************************************************************
+* Summary:
+*  Services the CapSense Tuner after every frame. While the Tuner holds the
+*  device suspended, Cy_CapSense_RunTuner() does not return and the sensing
+*  task waits for the mutex, as in the bare-metal loop.
+*
+* Parameters:
+*  arg - unused
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void tuner_task(void *arg)
+{
+    (void)arg;
+
+    for (;;)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        (void)xSemaphoreTake(capsense_mutex, portMAX_DELAY);
+        TRACE_EVENT(TRACE_EVT_TUNER_BEGIN);
+        Cy_CapSense_RunTuner(&cy_capsense_context);
+        TRACE_EVENT(TRACE_EVT_TUNER_END);
+        (void)xSemaphoreGive(capsense_mutex);
+    }
+}
+
+#if CY_CAPSENSE_BIST_EN
+/*******************************************************************************
+* Function Name: diag_task
+********************************************************************************
+* Summary:
+*  Measures the sensor Cp every RTOS_DIAG_PERIOD_MS between frames.
+*
+* Parameters:
+*  arg - unused
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void diag_task(void *arg)
+{
+    (void)arg;
+
+    for (;;)
+    {
+        vTaskDelay(pdMS_TO_TICKS(RTOS_DIAG_PERIOD_MS));
+
+        (void)xSemaphoreTake(capsense_mutex, portMAX_DELAY);
+        measure_sensor_cp();
+        (void)xSemaphoreGive(capsense_mutex);
+    }
+}
+#endif /* CY_CAPSENSE_BIST_EN */
+
+/*******************************************************************************
+* Function Name: vApplicationIdleHook
+********************************************************************************
+* Summary:
+*  Puts the CPU into Sleep when no task is ready.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void vApplicationIdleHook(void)
+{
+    Cy_SysPm_CpuEnterSleep();
+}
+
+/*******************************************************************************
+* Function Name: vApplicationGetIdleTaskMemory
+********************************************************************************
+* Summary:
+*  Provides the statically allocated memory of the idle task.
+*
+* Parameters:
+*  tcb - receives the task control block
+*  stack - receives the stack
+*  stack_size - receives the stack size in words
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void vApplicationGetIdleTaskMemory(StaticTask_t **tcb, StackType_t **stack,
+                                   configSTACK_DEPTH_TYPE *stack_size)
+{
+    *tcb = &idle_task_tcb;
+    *stack = idle_task_stack;
+    *stack_size = configMINIMAL_STACK_SIZE;
+}
+
+/*******************************************************************************
+* Function Name: vApplicationStackOverflowHook
+********************************************************************************
+* Summary:
+*  Stops on a task stack overflow.
+*
+* Parameters:
+*  task - task that overflowed its stack
+*  name - name of the task
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void vApplicationStackOverflowHook(TaskHandle_t task, char *name)
+{
+    (void)task;
+    (void)name;
+
+    CY_ASSERT(CY_ASSERT_FAILED);
+}
+#endif /* RTOS_EN */
+
+/*******************************************************************************
+* Function Name: capsense_isr
+********************************************************************************
+* Summary:
+*  Wrapper function for handling interrupts from CapSense block.
+*
+* Parameters:
+*   void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void capsense_isr(void)
+{
+#if RTOS_EN
+    BaseType_t woken = pdFALSE;
+#endif
+
+    TRACE_EVENT(TRACE_EVT_CAPSENSE_ISR_BEGIN);
+
+    Cy_CapSense_InterruptHandler(CYBSP_CSD_HW, &cy_capsense_context);
+
+#if HOST_REGS_EN || LOOP_STATS_EN || RTOS_EN
+    if (CY_CAPSENSE_BUSY != Cy_CapSense_IsBusy(&cy_capsense_context))
+    {
+#if HOST_REGS_EN
+        scan_end_us = timestamp_get_us();
+#endif
+#if LOOP_STATS_EN
+        scan_end_cycles = timestamp_get_cycles();
+#endif
+#if RTOS_EN
+        /* Scans during start-up run before the tasks exist */
+        if (NULL != sensing_task_handle)
+        {
+            vTaskNotifyGiveFromISR(sensing_task_handle, &woken);
+        }
+#endif
+    }
+#endif
+
+    TRACE_EVENT(TRACE_EVT_CAPSENSE_ISR_END);
+
+#if RTOS_EN
+    portYIELD_FROM_ISR(woken);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: ezi2c_isr
+********************************************************************************
+* Summary:
+*  Wrapper function for handling interrupts from EZI2C block.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void ezi2c_isr(void)
+{
+#if HOST_REGS_SECOND_ADDR_EN
+    uint32_t start = timestamp_get_cycles();
+#endif
+#if HOST_REGS_EN
+    uint32_t activity;
+#endif
+
+    TRACE_EVENT(TRACE_EVT_EZI2C_ISR_BEGIN);
+
+    Cy_SCB_EZI2C_Interrupt(CYBSP_EZI2C_HW, &ezi2c_context);
+
+#if HOST_REGS_EN
+    activity = Cy_SCB_EZI2C_GetActivity(CYBSP_EZI2C_HW, &ezi2c_context);
+    host_regs_isr_update(activity);
+#endif
+
+#if HOST_REGS_SECOND_ADDR_EN
+    /* Cost of this interrupt for the address of its transaction */
+    host_regs_isr_cost(activity, timestamp_get_cycles() - start);
+#endif
+
+    TRACE_EVENT(TRACE_EVT_EZI2C_ISR_END);
+}
+
+#if CY_CAPSENSE_BIST_EN
+
+/*******************************************************************************
+* Function Name: measure_sensor_cp
+********************************************************************************
+* Summary:
+*  Measures the self capacitance of the sensor electrode (Cp) in Femto Farad and
+*  stores its value in the variable button_0_sensor_cp for Button 0 and button_1_sensor_cp for
+*  Button 1. With CP_ESTIMATE_EN, the measurement is skipped unless the Cp
+*  estimate from the calibration state calls for it.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void measure_sensor_cp(void)
+{
+#if CP_ESTIMATE_EN
+    if (!cp_estimate_bist_due())
+    {
+        return;
+    }
+#endif
+
+    TRACE_EVENT(TRACE_EVT_BIST_BEGIN);
+
+    /* Measure the self capacitance of sensor electrode for Button 0 Widget */
+    cp_0_status = Cy_CapSense_MeasureCapacitanceSensor(CY_CAPSENSE_BUTTON0_WDGT_ID,
+                                                  CY_CAPSENSE_BUTTON0_SNS0_ID,
+                                             &button_0_sensor_cp, &cy_capsense_context);
+
+
+    /* Measure the self capacitance of sensor electrode for Button 1 Widget */
+    cp_1_status = Cy_CapSense_MeasureCapacitanceSensor(CY_CAPSENSE_BUTTON1_WDGT_ID,
+                                                  CY_CAPSENSE_BUTTON1_SNS0_ID,
+                                             &button_1_sensor_cp, &cy_capsense_context);
+
+#if CP_ESTIMATE_EN
+    cp_estimate_bist_done(CY_CAPSENSE_BUTTON0_WDGT_ID, CY_CAPSENSE_BUTTON0_SNS0_ID,
+                          button_0_sensor_cp, (CY_CAPSENSE_BIST_SUCCESS_E == cp_0_status));
+    cp_estimate_bist_done(CY_CAPSENSE_BUTTON1_WDGT_ID, CY_CAPSENSE_BUTTON1_SNS0_ID,
+                          button_1_sensor_cp, (CY_CAPSENSE_BIST_SUCCESS_E == cp_1_status));
+#endif
+
+#if FLASH_LOG_EN
+    flash_log_bist_status(0u, (uint32_t)cp_0_status);
+    flash_log_bist_status(1u, (uint32_t)cp_1_status);
+#endif
+
+    TRACE_EVENT(TRACE_EVT_BIST_END);
 }
 #endif /* CY_CAPSENSE_BIST_EN */
 
@@ -0,0 +1,408 @@
+/******************************************************************************
+* File Name: noise_filter.c
+*
+* Description: This file contains a noise classified adaptive raw count filter.
+*              A cheap per-sensor classifier tells impulse, broadband and
+*              periodic noise apart over a window of frames and enables only the
+*              filter stage that addresses the observed noise type, on the
+*              affected sensor only.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "noise_filter.h"
+#include "timestamp.h"
+
+#if NOISE_FILTER_EN
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Number of previous unfiltered samples kept per sensor */
+#define NOISE_HISTORY_SIZE       (3u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Filter and classifier state of one sensor */
+typedef struct
+{
+    uint16_t hist[NOISE_HISTORY_SIZE];
+    int32_t iir;
+    uint32_t sum_abs;
+    uint16_t max_abs;
+    uint8_t samples;
+    uint8_t crossings;
+    uint8_t interval;
+    uint8_t min_interval;
+    uint8_t max_interval;
+    int8_t last_sign;
+    uint8_t stages;
+    uint8_t quiet_windows;
+    uint8_t noise_class;
+    uint8_t primed;
+} noise_state_t;
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+noise_filter_stats_t noise_filter_stats;
+
+static noise_state_t noise_state[CY_CAPSENSE_SENSOR_COUNT];
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void noise_classify_sample(noise_state_t *state, uint32_t raw, uint32_t bsln);
+static void noise_classify_window(noise_state_t *state);
+static uint32_t noise_filter_sample(noise_state_t *state, uint32_t raw);
+
+/*******************************************************************************
+* Function Name: noise_filter_run
+********************************************************************************
+* Summary:
+*  Classifies the noise of every sensor and filters the raw counts of the
+*  scanned frame in place. Must be called before Cy_CapSense_ProcessAllWidgets().
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void noise_filter_run(void)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    cy_stc_capsense_sensor_context_t *sns_cxt;
+    noise_state_t *state;
+    uint32_t start = timestamp_get_cycles();
+    uint32_t cycles;
+    uint32_t sns_index = 0u;
+    uint32_t wd;
+    uint32_t sns;
+    uint32_t stage;
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+
+        for (sns = 0u; sns < wd_cfg->numSns; sns++)
+        {
+            sns_cxt = &wd_cfg->ptrSnsContext[sns];
+            state = &noise_state[sns_index];
+
+            if (0u == state->primed)
+            {
+                state->hist[0u] = sns_cxt->raw;
+                state->hist[1u] = sns_cxt->raw;
+                state->hist[2u] = sns_cxt->raw;
+                state->iir = (int32_t)sns_cxt->raw << 8u;
+                state->min_interval = UINT8_MAX;
+                state->primed = 1u;
+            }
+
+#if NOISE_FILTER_MODE == NOISE_FILTER_MODE_ADAPTIVE
+            /* A touch is signal, not noise */
+            if (0u == (sns_cxt->status & CY_CAPSENSE_SNS_TOUCH_STATUS_MASK))
+            {
+                noise_classify_sample(state, sns_cxt->raw, sns_cxt->bsln);
+            }
+#elif NOISE_FILTER_MODE == NOISE_FILTER_MODE_ALWAYS_ON
+            state->stages = NOISE_STAGE_MEDIAN | NOISE_STAGE_IIR | NOISE_STAGE_AVERAGE;
+#endif
+
+            sns_cxt->raw = (uint16_t)noise_filter_sample(state, sns_cxt->raw);
+
+            for (stage = 0u; stage < NOISE_STAGE_COUNT; stage++)
+            {
+                if (0u != (state->stages & (1u << stage)))
+                {
+                    noise_filter_stats.stage_frames[stage]++;
+                }
+            }
+
+            sns_index++;
+        }
+    }
+
+    cycles = timestamp_get_cycles() - start;
+    noise_filter_stats.frames++;
+    noise_filter_stats.cycles_total += cycles;
+    if (cycles > noise_filter_stats.cycles_max)
+    {
+        noise_filter_stats.cycles_max = cycles;
+    }
+}
+
+/*******************************************************************************
+* Function Name: noise_filter_get_class
+********************************************************************************
+* Summary:
+*  Returns the noise class of the last complete window of a sensor.
+*
+* Parameters:
+*  sns_index - sensor index across all widgets
+*
+* Return:
+*  noise_class_t - noise class
+*
+*******************************************************************************/
+noise_class_t noise_filter_get_class(uint32_t sns_index)
+{
+    return (noise_class_t)noise_state[sns_index].noise_class;
+}
+
+/*******************************************************************************
+* Function Name: noise_filter_get_stages
+********************************************************************************
+* Summary:
+*  Returns the filter stages enabled on a sensor.
+*
+* Parameters:
+*  sns_index - sensor index across all widgets
+*
+* Return:
+*  uint8_t - NOISE_STAGE_* bit mask
+*
+*******************************************************************************/
+uint8_t noise_filter_get_stages(uint32_t sns_index)
+{
+    return noise_state[sns_index].stages;
+}
+
+/*******************************************************************************
+* Function Name: noise_classify_sample
+********************************************************************************
+* Summary:
+*  Updates the window statistics with one unfiltered sample: the sum and the
+*  maximum of the absolute sample-to-sample change, and the spacing of the
+*  zero crossings of the deviation from the baseline.
+*
+* Parameters:
+*  state - sensor state
+*  raw - unfiltered raw count
+*  bsln - baseline
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void noise_classify_sample(noise_state_t *state, uint32_t raw, uint32_t bsln)
+{
+    int32_t change = (int32_t)raw - (int32_t)state->hist[0u];
+    uint32_t abs_change = (uint32_t)((change < 0) ? -change : change);
+    int8_t sign = (raw >= bsln) ? 1 : -1;
+
+    state->sum_abs += abs_change;
+    if (abs_change > state->max_abs)
+    {
+        state->max_abs = (uint16_t)abs_change;
+    }
+
+    if (state->interval < UINT8_MAX)
+    {
+        state->interval++;
+    }
+
+    if (sign != state->last_sign)
+    {
+        /* The interval before the first crossing of a window is incomplete */
+        if (0u != state->crossings)
+        {
+            if (state->interval < state->min_interval)
+            {
+                state->min_interval = state->interval;
+            }
+            if (state->interval > state->max_interval)
+            {
+                state->max_interval = state->interval;
+            }
+        }
+        state->crossings++;
+        state->interval = 0u;
+        state->last_sign = sign;
+    }
+
+    state->samples++;
+    if (state->samples >= NOISE_WINDOW_SIZE)
+    {
+        noise_classify_window(state);
+    }
+}
+
+/*******************************************************************************
+* Function Name: noise_classify_window
+********************************************************************************
+* Summary:
+*  Classifies a complete window and selects the filter stage:
+*  - quiet: small changes only, the filter is disabled after
+*    NOISE_HOLD_WINDOWS quiet windows
+*  - impulse: a few changes much larger than the mean, median filter
+*  - periodic: evenly spaced zero crossings, average filter
+*  - broadband: anything else, IIR filter
+*
+* Parameters:
+*  state - sensor state
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void noise_classify_window(noise_state_t *state)
+{
+    uint32_t mean = state->sum_abs / NOISE_WINDOW_SIZE;
+    noise_class_t noise_class;
+
+    if ((mean < NOISE_QUIET_TH) && (state->max_abs < (NOISE_QUIET_TH * NOISE_IMPULSE_RATIO)))
+    {
+        noise_class = NOISE_CLASS_QUIET;
+    }
+    else if (state->max_abs > (NOISE_IMPULSE_RATIO * (mean + 1u)))
+    {
+        noise_class = NOISE_CLASS_IMPULSE;
+    }
+    else if ((state->crossings >= NOISE_PERIODIC_MIN_CROSSINGS) &&
+             (((uint32_t)state->max_interval - state->min_interval) <= 1u))
+    {
+        noise_class = NOISE_CLASS_PERIODIC;
+    }
+    else
+    {
+        noise_class = NOISE_CLASS_BROADBAND;
+    }
+
+    state->noise_class = (uint8_t)noise_class;
+
+    switch (noise_class)
+    {
+        case NOISE_CLASS_IMPULSE:
+            state->stages = NOISE_STAGE_MEDIAN;
+            state->quiet_windows = 0u;
+            break;
+
+        case NOISE_CLASS_PERIODIC:
+            state->stages = NOISE_STAGE_AVERAGE;
+            state->quiet_windows = 0u;
+            break;
+
+        case NOISE_CLASS_BROADBAND:
+            state->stages = NOISE_STAGE_IIR;
+            state->quiet_windows = 0u;
+            break;
+
+        default:
+            if (state->quiet_windows < NOISE_HOLD_WINDOWS)
+            {
+                state->quiet_windows++;
+            }
+            else
+            {
+                state->stages = 0u;
+            }
+            break;
+    }
+
+    state->sum_abs = 0u;
+    state->max_abs = 0u;
+    state->samples = 0u;
+    state->crossings = 0u;
+    state->min_interval = UINT8_MAX;
+    state->max_interval = 0u;
+}
+
+/*******************************************************************************
+* Function Name: noise_filter_sample
+********************************************************************************
+* Summary:
+*  Runs the enabled stages on one raw sample, in the order median, average,
+*  IIR. The IIR state tracks the input even while the stage is disabled so
+*  that enabling it causes no transient.
+*
+* Parameters:
+*  state - sensor state
+*  raw - unfiltered raw count
+*
+* Return:
+*  uint32_t - filtered raw count
+*
+*******************************************************************************/
+static uint32_t noise_filter_sample(noise_state_t *state, uint32_t raw)
+{
+    uint32_t out = raw;
+    uint32_t a = state->hist[0u];
+    uint32_t b = state->hist[1u];
+
+    if (0u != (state->stages & NOISE_STAGE_MEDIAN))
+    {
+        /* Median of the current and the two previous samples */
+        if (((a <= raw) && (raw <= b)) || ((b <= raw) && (raw <= a)))
+        {
+            out = raw;
+        }
+        else if (((raw <= a) && (a <= b)) || ((b <= a) && (a <= raw)))
+        {
+            out = a;
+        }
+        else
+        {
+            out = b;
+        }
+    }
+
+    if (0u != (state->stages & NOISE_STAGE_AVERAGE))
+    {
+        out = (out + a + b + state->hist[2u] + 2u) >> 2u;
+    }
+
+    state->iir += ((((int32_t)out << 8u) - state->iir) * (int32_t)NOISE_IIR_COEFF) >> 8u;
+    if (0u != (state->stages & NOISE_STAGE_IIR))
+    {
+        out = (uint32_t)(state->iir >> 8u);
+    }
+
+    state->hist[2u] = state->hist[1u];
+    state->hist[1u] = state->hist[0u];
+    state->hist[0u] = (uint16_t)raw;
+
+    return out;
+}
+
+#endif /* NOISE_FILTER_EN */
+
+/* [] END OF FILE */
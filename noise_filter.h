@@ -0,0 +1,132 @@
+/******************************************************************************
+* File Name: noise_filter.h
+*
+* Description: This file contains the interface of the noise classified adaptive
+*              raw count filter.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef NOISE_FILTER_H_
+#define NOISE_FILTER_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include "cy_pdl.h"
+#include "cycfg_capsense.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Enables the noise classifier and the raw count filter stages */
+#define NOISE_FILTER_EN                  (0u)
+
+/* Filter modes, for comparing the adaptive chain with fixed settings */
+#define NOISE_FILTER_MODE_ADAPTIVE       (0u)
+#define NOISE_FILTER_MODE_ALWAYS_ON      (1u)
+#define NOISE_FILTER_MODE_ALWAYS_OFF     (2u)
+
+#define NOISE_FILTER_MODE                (NOISE_FILTER_MODE_ADAPTIVE)
+
+/* Frames per classification window */
+#define NOISE_WINDOW_SIZE                (16u)
+
+/* Mean absolute sample-to-sample change below which a sensor is quiet */
+#define NOISE_QUIET_TH                   (3u)
+
+/* A window is impulsive when the largest change exceeds the mean change by
+ * this factor.
+ */
+#define NOISE_IMPULSE_RATIO              (4u)
+
+/* Minimum number of zero crossings for the periodic test */
+#define NOISE_PERIODIC_MIN_CROSSINGS     (4u)
+
+/* Quiet windows before a filter stage is disabled again */
+#define NOISE_HOLD_WINDOWS               (4u)
+
+/* IIR coefficient out of 256, matches the configurator default of 128 */
+#define NOISE_IIR_COEFF                  (128u)
+
+/* Filter stages, one per noise type */
+#define NOISE_STAGE_MEDIAN               (0x01u) /* impulse noise */
+#define NOISE_STAGE_IIR                  (0x02u) /* broadband noise */
+#define NOISE_STAGE_AVERAGE              (0x04u) /* periodic noise */
+
+/* Number of filter stages, one usage counter each */
+#define NOISE_STAGE_COUNT                (3u)
+
+#if NOISE_FILTER_EN
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Noise class of a sensor */
+typedef enum
+{
+    NOISE_CLASS_QUIET = 0u,
+    NOISE_CLASS_IMPULSE,
+    NOISE_CLASS_BROADBAND,
+    NOISE_CLASS_PERIODIC
+} noise_class_t;
+
+/* Processing time and filter usage */
+typedef struct
+{
+    uint32_t frames;
+    uint32_t cycles_total;
+    uint32_t cycles_max;
+    uint32_t stage_frames[NOISE_STAGE_COUNT];
+} noise_filter_stats_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern noise_filter_stats_t noise_filter_stats;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void noise_filter_run(void);
+noise_class_t noise_filter_get_class(uint32_t sns_index);
+uint8_t noise_filter_get_stages(uint32_t sns_index);
+
+#endif /* NOISE_FILTER_EN */
+
+#endif /* NOISE_FILTER_H_ */
+
+/* [] END OF FILE */
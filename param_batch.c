@@ -0,0 +1,217 @@
+/******************************************************************************
+* File Name: param_batch.c
+*
+* Description: This file contains the batched widget parameter update received
+*              through the host mailbox.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "param_batch.h"
+#include "scratch.h"
+
+#if PARAM_BATCH_EN
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static bool param_batch_stage(uint16_t (*stage)[PARAM_COUNT], const uint8_t *payload, uint32_t len,
+                              uint8_t *bad_entry);
+
+/* The staging rows grow with the widget count, 384 bytes at 32 widgets, which
+ * the 192-word stack of the RTOS sensing task cannot spare. They are borrowed
+ * from the processing scratch phase instead.
+ */
+_Static_assert(PARAM_BATCH_SCRATCH_SIZE <= SCRATCH_ARENA_SIZE, "Staging rows do not fit the scratch arena");
+
+/*******************************************************************************
+* Function Name: param_batch_load
+********************************************************************************
+* Summary:
+*  Copies the current parameters of a widget into a staging row.
+*
+* Parameters:
+*  wd - widget index
+*  stage - PARAM_COUNT values
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void param_batch_load(uint32_t wd, uint16_t *stage)
+{
+    const cy_stc_capsense_widget_context_t *wd_cxt = cy_capsense_context.ptrWdConfig[wd].ptrWdContext;
+
+    stage[PARAM_FINGER_TH] = wd_cxt->fingerTh;
+    stage[PARAM_NOISE_TH] = wd_cxt->noiseTh;
+    stage[PARAM_NNOISE_TH] = wd_cxt->nNoiseTh;
+    stage[PARAM_HYSTERESIS] = wd_cxt->hysteresis;
+    stage[PARAM_ON_DEBOUNCE] = wd_cxt->onDebounce;
+    stage[PARAM_LOW_BSLN_RST] = wd_cxt->lowBslnRst;
+}
+
+/*******************************************************************************
+* Function Name: param_batch_store
+********************************************************************************
+* Summary:
+*  Writes a validated staging row to the widget.
+*
+* Parameters:
+*  wd - widget index
+*  stage - PARAM_COUNT values
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void param_batch_store(uint32_t wd, const uint16_t *stage)
+{
+    cy_stc_capsense_widget_context_t *wd_cxt = cy_capsense_context.ptrWdConfig[wd].ptrWdContext;
+
+    wd_cxt->fingerTh = stage[PARAM_FINGER_TH];
+    wd_cxt->noiseTh = stage[PARAM_NOISE_TH];
+    wd_cxt->nNoiseTh = stage[PARAM_NNOISE_TH];
+    wd_cxt->hysteresis = stage[PARAM_HYSTERESIS];
+    wd_cxt->onDebounce = (uint8_t)stage[PARAM_ON_DEBOUNCE];
+    wd_cxt->lowBslnRst = stage[PARAM_LOW_BSLN_RST];
+}
+
+/*******************************************************************************
+* Function Name: param_batch_apply
+********************************************************************************
+* Summary:
+*  Validates a batch of (widget, parameter, value) entries and applies all of
+*  them, or none. The entries are staged on a copy of the current parameters,
+*  so later entries may override earlier ones and the consistency checks see
+*  the final values: the noise threshold and the hysteresis must stay below
+*  the finger threshold, debounce and baseline reset counts must be 1 to 255.
+*  Call at a frame boundary.
+*
+* Parameters:
+*  payload - mailbox payload
+*  len - payload length in bytes, a multiple of PARAM_BATCH_ENTRY_SIZE
+*  bad_entry - returns 1 + the index of the first rejected entry, or 0 when
+*              the batch itself or a widget as a whole was rejected
+*
+* Return:
+*  bool - true if the batch was applied
+*
+*******************************************************************************/
+bool param_batch_apply(const uint8_t *payload, uint32_t len, uint8_t *bad_entry)
+{
+    uint16_t (*stage)[PARAM_COUNT];
+    bool applied;
+
+    scratch_begin(SCRATCH_PHASE_PROCESSING);
+    stage = (uint16_t (*)[PARAM_COUNT])scratch_alloc(PARAM_BATCH_SCRATCH_SIZE);
+    applied = param_batch_stage(stage, payload, len, bad_entry);
+    scratch_end(SCRATCH_PHASE_PROCESSING);
+
+    return applied;
+}
+
+/*******************************************************************************
+* Function Name: param_batch_stage
+********************************************************************************
+* Summary:
+*  Stages, validates and applies a batch, see param_batch_apply().
+*
+* Parameters:
+*  stage - staging rows of all widgets
+*  payload - mailbox payload
+*  len - payload length in bytes
+*  bad_entry - returns 1 + the index of the first rejected entry, or 0
+*
+* Return:
+*  bool - true if the batch was applied
+*
+*******************************************************************************/
+static bool param_batch_stage(uint16_t (*stage)[PARAM_COUNT], const uint8_t *payload, uint32_t len,
+                              uint8_t *bad_entry)
+{
+    const uint8_t *entry;
+    uint32_t count = len / PARAM_BATCH_ENTRY_SIZE;
+    uint32_t wd;
+    uint32_t i;
+
+    *bad_entry = 0u;
+
+    if ((0u == count) || (count > PARAM_BATCH_MAX) || (0u != (len % PARAM_BATCH_ENTRY_SIZE)))
+    {
+        return false;
+    }
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        param_batch_load(wd, stage[wd]);
+    }
+
+    for (i = 0u; i < count; i++)
+    {
+        entry = &payload[i * PARAM_BATCH_ENTRY_SIZE];
+
+        if ((entry[0] >= CY_CAPSENSE_WIDGET_COUNT) || (entry[1] >= PARAM_COUNT))
+        {
+            *bad_entry = (uint8_t)(i + 1u);
+            return false;
+        }
+        stage[entry[0]][entry[1]] = (uint16_t)((uint32_t)entry[2] | ((uint32_t)entry[3] << 8u));
+    }
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        if ((stage[wd][PARAM_NOISE_TH] >= stage[wd][PARAM_FINGER_TH]) ||
+            (stage[wd][PARAM_HYSTERESIS] >= stage[wd][PARAM_FINGER_TH]) ||
+            (0u == stage[wd][PARAM_ON_DEBOUNCE]) || (stage[wd][PARAM_ON_DEBOUNCE] > UINT8_MAX) ||
+            (0u == stage[wd][PARAM_LOW_BSLN_RST]) || (stage[wd][PARAM_LOW_BSLN_RST] > UINT8_MAX))
+        {
+            return false;
+        }
+    }
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        param_batch_store(wd, stage[wd]);
+    }
+
+    return true;
+}
+
+#endif /* PARAM_BATCH_EN */
+
+/* [] END OF FILE */
@@ -0,0 +1,96 @@
+/******************************************************************************
+* File Name: param_batch.h
+*
+* Description: This file contains the batched widget parameter update received
+*              through the host mailbox.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef PARAM_BATCH_H_
+#define PARAM_BATCH_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_pdl.h"
+#include "cycfg_capsense.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Enables the batched parameter write command */
+#define PARAM_BATCH_EN                   (0u)
+
+/* Entries per batch. The mailbox payload grows to hold a full batch. */
+#define PARAM_BATCH_MAX                  (32u)
+
+/* Size of one entry in the payload: widget, parameter, value (LE) */
+#define PARAM_BATCH_ENTRY_SIZE           (4u)
+
+/* Parameter IDs */
+#define PARAM_FINGER_TH                  (0x00u)
+#define PARAM_NOISE_TH                   (0x01u)
+#define PARAM_NNOISE_TH                  (0x02u)
+#define PARAM_HYSTERESIS                 (0x03u)
+#define PARAM_ON_DEBOUNCE                (0x04u)
+#define PARAM_LOW_BSLN_RST               (0x05u)
+#define PARAM_COUNT                      (0x06u)
+
+/* Processing scratch: the staging rows of all widgets */
+#if PARAM_BATCH_EN
+#define PARAM_BATCH_SCRATCH_SIZE         (CY_CAPSENSE_WIDGET_COUNT * PARAM_COUNT * sizeof(uint16_t))
+#else
+#define PARAM_BATCH_SCRATCH_SIZE         (0u)
+#endif
+
+#if PARAM_BATCH_EN
+
+#if (PARAM_BATCH_MAX * PARAM_BATCH_ENTRY_SIZE) > 255u
+#error "A batch must fit into the 8-bit mailbox length"
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool param_batch_apply(const uint8_t *payload, uint32_t len, uint8_t *bad_entry);
+
+#endif /* PARAM_BATCH_EN */
+
+#endif /* PARAM_BATCH_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,489 @@
+/******************************************************************************
+* File Name: profiles.c
+*
+* Description: This file contains the precomputed CapSense configuration
+*              profiles. Every profile holds the complete widget configuration
+*              including the calibrated IDAC values, so switching between
+*              profiles at a frame boundary needs no recalibration.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <string.h>
+#include "profiles.h"
+#include "timestamp.h"
+#include "scratch.h"
+
+#if PROFILES_EN
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Number of flash rows reserved for the profile store */
+#define PROFILES_FLASH_ROWS      ((sizeof(profile_store_t) + CY_FLASH_SIZEOF_ROW - 1u) / \
+                                  CY_FLASH_SIZEOF_ROW)
+
+#define PROFILES_FLASH_SIZE      (PROFILES_FLASH_ROWS * CY_FLASH_SIZEOF_ROW)
+
+/* FNV-1a hash parameters used for the store signature */
+#define FNV_OFFSET_BASIS         (0x811C9DC5u)
+#define FNV_PRIME                (0x01000193u)
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+profiles_stats_t profiles_stats;
+
+/* Build-time parameters of each profile, applied to all widgets. NORMAL holds
+ * the thresholds from Table 4 of README.md, the others are starting points
+ * that have to be tuned for the end product.
+ */
+static const profile_params_t profile_defaults[PROFILE_COUNT] =
+{
+    /* resolution, on_debounce, finger_th, noise_th, nnoise_th, hysteresis, low_bsln_rst */
+    [PROFILE_NORMAL]    = { 10u, 3u,  80u, 40u, 40u, 10u, 30u },
+    [PROFILE_GLOVE]     = { 12u, 3u, 120u, 60u, 60u, 15u, 30u },
+    [PROFILE_WET]       = { 10u, 5u, 100u, 50u, 50u, 20u, 30u },
+    [PROFILE_LOW_POWER] = {  9u, 2u,  40u, 20u, 20u,  5u, 15u },
+};
+
+/* Flash rows holding the profile store */
+CY_ALIGN(CY_FLASH_SIZEOF_ROW)
+static const uint8_t profile_flash[PROFILES_FLASH_SIZE] = {0u};
+
+/* Profile store in flash. Volatile so that reads of the zero-initialized
+ * flash array are not folded.
+ */
+static const profile_store_t * volatile profile_store;
+
+/* Active profile, switched by pointer at a frame boundary */
+static const profile_t *active_profile;
+static profile_id_t active_id = PROFILE_NORMAL;
+static volatile profile_id_t requested_id = PROFILE_NORMAL;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static uint32_t profiles_signature(void);
+static void profiles_apply(const profile_t *profile);
+static void profiles_apply_params(const profile_params_t *params);
+static cy_capsense_status_t profiles_calibrate(profile_store_t *image);
+
+/*******************************************************************************
+* Function Name: profiles_init
+********************************************************************************
+* Summary:
+*  Validates the profile store in flash. At first boot, or after the build-time
+*  parameters changed, calibrates every profile and programs the store. Then
+*  applies the NORMAL profile and initializes the baselines. Call after
+*  Cy_CapSense_Enable() and before the first scan.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  cy_capsense_status_t - status of the calibration, CY_CAPSENSE_STATUS_BAD_DATA
+*  if the store could not be programmed
+*
+*******************************************************************************/
+cy_capsense_status_t profiles_init(void)
+{
+    cy_capsense_status_t status = CY_CAPSENSE_STATUS_SUCCESS;
+    uint32_t signature = profiles_signature();
+    profile_store_t *image;
+
+    profile_store = (const profile_store_t *)profile_flash;
+
+    if ((PROFILES_MAGIC != profile_store->magic) || (signature != profile_store->signature))
+    {
+        scratch_begin(SCRATCH_PHASE_CALIBRATION);
+
+        image = (profile_store_t *)scratch_alloc(sizeof(profile_store_t));
+        status = profiles_calibrate(image);
+        image->magic = PROFILES_MAGIC;
+        image->signature = signature;
+
+        if (CY_CAPSENSE_STATUS_SUCCESS == status)
+        {
+            if (CY_FLASH_DRV_SUCCESS != profiles_commit(image))
+            {
+                status = CY_CAPSENSE_STATUS_BAD_DATA;
+            }
+        }
+
+        scratch_end(SCRATCH_PHASE_CALIBRATION);
+    }
+
+    active_id = PROFILE_NORMAL;
+    requested_id = PROFILE_NORMAL;
+    active_profile = &profile_store->profile[PROFILE_NORMAL];
+    profiles_apply(active_profile);
+    Cy_CapSense_InitializeAllBaselines(&cy_capsense_context);
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: profiles_request
+********************************************************************************
+* Summary:
+*  Requests a profile switch. The switch takes effect at the next frame
+*  boundary. Can be called from an ISR.
+*
+* Parameters:
+*  id - profile to switch to
+*  frame - current frame number, recorded for the latency statistics
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void profiles_request(profile_id_t id, uint32_t frame)
+{
+    if (id < PROFILE_COUNT)
+    {
+        profiles_stats.request_frame = frame;
+        requested_id = id;
+    }
+}
+
+/*******************************************************************************
+* Function Name: profiles_apply_pending
+********************************************************************************
+* Summary:
+*  Applies a requested profile. Must be called between the end of processing
+*  of one frame and the start of the next scan.
+*
+* Parameters:
+*  frame - number of the frame that was just processed
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void profiles_apply_pending(uint32_t frame)
+{
+    profile_id_t id = requested_id;
+    uint32_t start;
+    uint32_t cycles;
+
+    if (id != active_id)
+    {
+        start = timestamp_get_cycles();
+
+        active_profile = &profile_store->profile[id];
+        profiles_apply(active_profile);
+        active_id = id;
+
+        cycles = timestamp_get_cycles() - start;
+        profiles_stats.switch_count++;
+        profiles_stats.last_switch_cycles = cycles;
+        profiles_stats.apply_frame = frame;
+        if (cycles > profiles_stats.max_switch_cycles)
+        {
+            profiles_stats.max_switch_cycles = cycles;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: profiles_get_active
+********************************************************************************
+* Summary:
+*  Returns the profile in use.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  profile_id_t - active profile
+*
+*******************************************************************************/
+profile_id_t profiles_get_active(void)
+{
+    return active_id;
+}
+
+/*******************************************************************************
+* Function Name: profiles_get_store
+********************************************************************************
+* Summary:
+*  Returns the profile store in use.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  const profile_store_t* - profile store
+*
+*******************************************************************************/
+const profile_store_t *profiles_get_store(void)
+{
+    return profile_store;
+}
+
+/*******************************************************************************
+* Function Name: profiles_commit
+********************************************************************************
+* Summary:
+*  Programs a complete profile store into flash. Blocks the CPU for the flash
+*  write time of every row, so it must be called while no scan is in progress.
+*  Borrows the row buffer from the calibration scratch phase, which the caller
+*  must have started.
+*
+* Parameters:
+*  image - profile store to program
+*
+* Return:
+*  cy_en_flashdrv_status_t - flash driver status
+*
+*******************************************************************************/
+cy_en_flashdrv_status_t profiles_commit(const profile_store_t *image)
+{
+    cy_en_flashdrv_status_t status = CY_FLASH_DRV_SUCCESS;
+    uint32_t *row_buf = (uint32_t *)scratch_alloc(CY_FLASH_SIZEOF_ROW);
+    const uint8_t *src = (const uint8_t *)image;
+    uint32_t remaining = sizeof(profile_store_t);
+    uint32_t row;
+    uint32_t len;
+
+    for (row = 0u; (row < PROFILES_FLASH_ROWS) && (CY_FLASH_DRV_SUCCESS == status); row++)
+    {
+        len = (remaining < CY_FLASH_SIZEOF_ROW) ? remaining : CY_FLASH_SIZEOF_ROW;
+        memset(row_buf, 0, CY_FLASH_SIZEOF_ROW);
+        memcpy(row_buf, src, len);
+
+        status = Cy_Flash_WriteRow((uint32_t)&profile_flash[row * CY_FLASH_SIZEOF_ROW], row_buf);
+
+        src += len;
+        remaining -= len;
+    }
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: profiles_signature
+********************************************************************************
+* Summary:
+*  Hashes the build-time profile parameters and the widget layout so that the
+*  flash store is rebuilt whenever the firmware changes them.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - signature
+*
+*******************************************************************************/
+static uint32_t profiles_signature(void)
+{
+    const uint8_t *data = (const uint8_t *)profile_defaults;
+    uint32_t hash = FNV_OFFSET_BASIS;
+    uint32_t i;
+
+    for (i = 0u; i < sizeof(profile_defaults); i++)
+    {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+
+    hash = (hash ^ CY_CAPSENSE_WIDGET_COUNT) * FNV_PRIME;
+    hash = (hash ^ CY_CAPSENSE_SENSOR_COUNT) * FNV_PRIME;
+
+    return hash;
+}
+
+/*******************************************************************************
+* Function Name: profiles_apply_params
+********************************************************************************
+* Summary:
+*  Writes the build-time parameters of a profile to all widgets without
+*  touching the IDAC values. Used before calibration.
+*
+* Parameters:
+*  params - profile parameters
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void profiles_apply_params(const profile_params_t *params)
+{
+    cy_stc_capsense_widget_context_t *wd_cxt;
+    uint32_t wd;
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        wd_cxt = cy_capsense_context.ptrWdConfig[wd].ptrWdContext;
+
+        wd_cxt->resolution = params->resolution;
+        wd_cxt->maxRawCount = (uint16_t)((1uL << params->resolution) - 1u);
+        wd_cxt->fingerTh = params->finger_th;
+        wd_cxt->noiseTh = params->noise_th;
+        wd_cxt->nNoiseTh = params->nnoise_th;
+        wd_cxt->hysteresis = params->hysteresis;
+        wd_cxt->lowBslnRst = params->low_bsln_rst;
+        wd_cxt->onDebounce = params->on_debounce;
+    }
+}
+
+/*******************************************************************************
+* Function Name: profiles_apply
+********************************************************************************
+* Summary:
+*  Writes a complete profile to the CapSense context. The cost is a fixed copy
+*  per widget and sensor. When the resolution changes the baselines are scaled
+*  with it, as every profile is calibrated to the same raw count level. This
+*  keeps the touch state across the switch and avoids a baseline dead period.
+*
+* Parameters:
+*  profile - profile to apply
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void profiles_apply(const profile_t *profile)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    cy_stc_capsense_widget_context_t *wd_cxt;
+    cy_stc_capsense_sensor_context_t *sns_cxt;
+    const profile_widget_t *widget;
+    uint32_t old_resolution;
+    uint32_t wd;
+    uint32_t sns;
+    uint32_t sns_index = 0u;
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+        wd_cxt = wd_cfg->ptrWdContext;
+        widget = &profile->widget[wd];
+        old_resolution = wd_cxt->resolution;
+
+        wd_cxt->resolution = widget->params.resolution;
+        wd_cxt->maxRawCount = (uint16_t)((1uL << widget->params.resolution) - 1u);
+        wd_cxt->fingerTh = widget->params.finger_th;
+        wd_cxt->noiseTh = widget->params.noise_th;
+        wd_cxt->nNoiseTh = widget->params.nnoise_th;
+        wd_cxt->hysteresis = widget->params.hysteresis;
+        wd_cxt->lowBslnRst = widget->params.low_bsln_rst;
+        wd_cxt->onDebounce = widget->params.on_debounce;
+        wd_cxt->idacMod[CY_CAPSENSE_MFS_CH0_INDEX] = widget->idac_mod;
+        wd_cxt->idacGainIndex = widget->idac_gain_index;
+
+        for (sns = 0u; sns < wd_cfg->numSns; sns++)
+        {
+            sns_cxt = &wd_cfg->ptrSnsContext[sns];
+            sns_cxt->idacComp = profile->idac_comp[sns_index];
+            sns_index++;
+
+            if (widget->params.resolution > old_resolution)
+            {
+                sns_cxt->bsln = (uint16_t)((uint32_t)sns_cxt->bsln <<
+                                           (widget->params.resolution - old_resolution));
+                sns_cxt->bslnExt = 0u;
+            }
+            else if (widget->params.resolution < old_resolution)
+            {
+                sns_cxt->bsln = (uint16_t)((uint32_t)sns_cxt->bsln >>
+                                           (old_resolution - widget->params.resolution));
+                sns_cxt->bslnExt = 0u;
+            }
+            else
+            {
+                /* Same scale, baseline is kept as is */
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: profiles_calibrate
+********************************************************************************
+* Summary:
+*  Calibrates the IDACs of every profile and captures the result into the RAM
+*  image. Leaves the last calibrated profile in the CapSense context.
+*
+* Parameters:
+*  image - RAM image to fill
+*
+* Return:
+*  cy_capsense_status_t - status of the first failing calibration
+*
+*******************************************************************************/
+static cy_capsense_status_t profiles_calibrate(profile_store_t *image)
+{
+    cy_capsense_status_t status = CY_CAPSENSE_STATUS_SUCCESS;
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    profile_t *profile;
+    uint32_t id;
+    uint32_t wd;
+    uint32_t sns;
+    uint32_t sns_index;
+
+    memset(image, 0, sizeof(profile_store_t));
+
+    for (id = 0u; (id < PROFILE_COUNT) && (CY_CAPSENSE_STATUS_SUCCESS == status); id++)
+    {
+        profile = &image->profile[id];
+        profiles_apply_params(&profile_defaults[id]);
+        status = Cy_CapSense_CalibrateAllWidgets(&cy_capsense_context);
+
+        sns_index = 0u;
+        for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+        {
+            wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+            profile->widget[wd].params = profile_defaults[id];
+            profile->widget[wd].idac_mod = wd_cfg->ptrWdContext->idacMod[CY_CAPSENSE_MFS_CH0_INDEX];
+            profile->widget[wd].idac_gain_index = wd_cfg->ptrWdContext->idacGainIndex;
+
+            for (sns = 0u; sns < wd_cfg->numSns; sns++)
+            {
+                profile->idac_comp[sns_index] = wd_cfg->ptrSnsContext[sns].idacComp;
+                sns_index++;
+            }
+        }
+    }
+
+    return status;
+}
+
+#endif /* PROFILES_EN */
+
+/* [] END OF FILE */
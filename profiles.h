@@ -0,0 +1,147 @@
+/******************************************************************************
+* File Name: profiles.h
+*
+* Description: This file contains the interface of the precomputed CapSense
+*              configuration profiles.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef PROFILES_H_
+#define PROFILES_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include "cy_pdl.h"
+#include "cycfg_capsense.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Enables precomputed sensing profiles with frame boundary switching */
+#define PROFILES_EN                      (0u)
+
+/* Profile store marker, "PROF" */
+#define PROFILES_MAGIC                   (0x464F5250u)
+
+#if PROFILES_EN
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Sensing profiles */
+typedef enum
+{
+    PROFILE_NORMAL = 0u,
+    PROFILE_GLOVE,
+    PROFILE_WET,
+    PROFILE_LOW_POWER,
+    PROFILE_COUNT
+} profile_id_t;
+
+/* Build-time widget parameters of a profile */
+typedef struct
+{
+    uint8_t resolution;
+    uint8_t on_debounce;
+    uint16_t finger_th;
+    uint16_t noise_th;
+    uint16_t nnoise_th;
+    uint16_t hysteresis;
+    uint16_t low_bsln_rst;
+} profile_params_t;
+
+/* Complete widget configuration including the calibrated IDAC values */
+typedef struct
+{
+    profile_params_t params;
+    uint8_t idac_mod;
+    uint8_t idac_gain_index;
+} profile_widget_t;
+
+/* One sensing profile */
+typedef struct
+{
+    profile_widget_t widget[CY_CAPSENSE_WIDGET_COUNT];
+    uint8_t idac_comp[CY_CAPSENSE_SENSOR_COUNT];
+} profile_t;
+
+/* Flash image of all profiles */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t signature;
+    profile_t profile[PROFILE_COUNT];
+} profile_store_t;
+
+/* Switch latency statistics */
+typedef struct
+{
+    uint32_t switch_count;
+    uint32_t last_switch_cycles;
+    uint32_t max_switch_cycles;
+    uint32_t request_frame;
+    uint32_t apply_frame;
+} profiles_stats_t;
+
+/* Calibration scratch: the store image and a flash row buffer */
+#define PROFILES_SCRATCH_SIZE            (sizeof(profile_store_t) + CY_FLASH_SIZEOF_ROW)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern profiles_stats_t profiles_stats;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+cy_capsense_status_t profiles_init(void);
+void profiles_request(profile_id_t id, uint32_t frame);
+void profiles_apply_pending(uint32_t frame);
+profile_id_t profiles_get_active(void);
+const profile_store_t *profiles_get_store(void);
+cy_en_flashdrv_status_t profiles_commit(const profile_store_t *image);
+
+#else
+
+#define PROFILES_SCRATCH_SIZE            (0u)
+
+#endif /* PROFILES_EN */
+
+#endif /* PROFILES_H_ */
+
+/* [] END OF FILE */
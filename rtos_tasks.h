@@ -0,0 +1,114 @@
+/******************************************************************************
+* File Name: rtos_tasks.h
+*
+* Description: This file contains the configuration of the FreeRTOS variant of the
+*              scan loop and the loop statistics used to compare it with the
+*              bare-metal loop.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef RTOS_TASKS_H_
+#define RTOS_TASKS_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Runs sensing, tuner and diagnostics as FreeRTOS tasks instead of the
+ * bare-metal loop. Requires the freertos library, see README.md. The host
+ * build in tools/rtos_posix sets this and the stack sizes on the command line.
+ */
+#ifndef RTOS_EN
+#define RTOS_EN                          (0u)
+#endif
+
+/* Measures the latency from the end of a scan to the start of processing and
+ * the time spent per frame, in both the bare-metal loop and RTOS_EN
+ */
+#ifndef LOOP_STATS_EN
+#define LOOP_STATS_EN                    (0u)
+#endif
+
+/* Task priorities, sensing preempts the tuner and diagnostics */
+#define RTOS_SENSING_PRIORITY            (3u)
+#define RTOS_TUNER_PRIORITY              (2u)
+#define RTOS_DIAG_PRIORITY               (1u)
+
+/* Task stack sizes in words */
+#ifndef RTOS_SENSING_STACK_SIZE
+#define RTOS_SENSING_STACK_SIZE          (192u)
+#define RTOS_TUNER_STACK_SIZE            (128u)
+#define RTOS_DIAG_STACK_SIZE             (128u)
+#endif
+
+/* Frame period of the sensing task in milliseconds */
+#define RTOS_SCAN_PERIOD_MS              (10u)
+
+/* Period of the BIST measurement in the diagnostics task in milliseconds */
+#define RTOS_DIAG_PERIOD_MS              (1000u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+#if LOOP_STATS_EN
+/* Frame timing in CPU cycles. wake is the time from the end of the scan,
+ * latched in the CapSense ISR, to the start of processing. busy is the time
+ * from there to the end of the frame work. switches counts RTOS context
+ * switches.
+ */
+typedef struct
+{
+    uint32_t frames;
+    uint64_t wake_cycles_sum;
+    uint32_t wake_cycles_max;
+    uint64_t busy_cycles_sum;
+    uint32_t busy_cycles_max;
+    uint32_t switches;
+} loop_stats_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern loop_stats_t loop_stats;
+#endif /* LOOP_STATS_EN */
+
+#endif /* RTOS_TASKS_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,322 @@
+/******************************************************************************
+* File Name: scan_slot.c
+*
+* Description: This file contains the time-division scan schedule. Boards that sit
+*              next to each other share a repeating schedule and each board starts
+*              its scans only in its own slot, so their scans do not couple into
+*              each other.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "scan_slot.h"
+#include "timestamp.h"
+
+#if SCAN_SLOT_EN
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Waits longer than one SysTick period are spent in Sleep */
+#define SCAN_SLOT_SLEEP_MARGIN_US        (1000000u / TIMESTAMP_TICKS_PER_SEC)
+
+#define SCAN_SLOT_NOMINAL_Q8             (SCAN_SLOT_PERIOD_US << 8u)
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+scan_slot_stats_t scan_slot_stats;
+
+/* Device time of the last sync, start of a schedule period */
+static volatile uint32_t slot_epoch_us;
+
+/* Schedule period in device time, in 1/256 microseconds */
+static volatile uint32_t slot_period_q8;
+
+static volatile bool slot_synced;
+static uint16_t slot_period_index;
+static volatile uint32_t slot_id;
+static volatile uint32_t slot_count;
+
+/* Start time of the previous scan */
+static uint32_t slot_last_start;
+static bool slot_started;
+
+#if SCAN_SLOT_GPIO_EN
+/* Sync input interrupt configuration */
+static const cy_stc_sysint_t scan_slot_intr_config =
+{
+    .intrSrc = SCAN_SLOT_SYNC_IRQ,
+    .intrPriority = SCAN_SLOT_SYNC_INTR_PRIORITY,
+};
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#if SCAN_SLOT_GPIO_EN
+static void scan_slot_sync_isr(void);
+#endif
+
+/*******************************************************************************
+* Function Name: scan_slot_init
+********************************************************************************
+* Summary:
+*  Starts the schedule from the current device time with the nominal period
+*  and enables the sync input. Must be called after timestamp_init().
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void scan_slot_init(void)
+{
+    slot_period_q8 = SCAN_SLOT_NOMINAL_Q8;
+    slot_epoch_us = timestamp_get_us();
+    slot_synced = false;
+    slot_id = SCAN_SLOT_ID;
+    slot_count = SCAN_SLOT_COUNT;
+    slot_started = false;
+    scan_slot_stats.period_us = SCAN_SLOT_PERIOD_US;
+
+#if SCAN_SLOT_GPIO_EN
+    Cy_GPIO_Pin_FastInit(SCAN_SLOT_SYNC_PORT, SCAN_SLOT_SYNC_PIN, CY_GPIO_DM_HIGHZ,
+                         0u, HSIOM_SEL_GPIO);
+    Cy_GPIO_SetInterruptEdge(SCAN_SLOT_SYNC_PORT, SCAN_SLOT_SYNC_PIN, CY_GPIO_INTR_RISING);
+    Cy_GPIO_ClearInterrupt(SCAN_SLOT_SYNC_PORT, SCAN_SLOT_SYNC_PIN);
+
+    (void)Cy_SysInt_Init(&scan_slot_intr_config, scan_slot_sync_isr);
+    NVIC_ClearPendingIRQ(scan_slot_intr_config.intrSrc);
+    NVIC_EnableIRQ(scan_slot_intr_config.intrSrc);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: scan_slot_track
+********************************************************************************
+* Summary:
+*  Moves the start of the schedule to a sync point. The time since the previous
+*  sync, divided by the number of periods in between, measures the period in
+*  device time. This corrects the schedule for the clock error of the board
+*  between syncs.
+*
+* Parameters:
+*  epoch_us - device time of the start of a period
+*  periods - periods since the previous sync, 0 if unknown
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void scan_slot_track(uint32_t epoch_us, uint32_t periods)
+{
+    uint32_t elapsed = epoch_us - slot_epoch_us;
+    uint32_t period = slot_period_q8 >> 8u;
+    uint32_t measured_q8;
+
+    /* Longer gaps would overflow the fixed-point period */
+    if (slot_synced && (0u != periods) && (elapsed < (1uL << 24u)))
+    {
+        scan_slot_stats.phase_error_us = (int32_t)(elapsed - (periods * period));
+
+        measured_q8 = (elapsed << 8u) / periods;
+        if ((measured_q8 > (SCAN_SLOT_NOMINAL_Q8 - (SCAN_SLOT_NOMINAL_Q8 >> SCAN_SLOT_MAX_DRIFT_SHIFT))) &&
+            (measured_q8 < (SCAN_SLOT_NOMINAL_Q8 + (SCAN_SLOT_NOMINAL_Q8 >> SCAN_SLOT_MAX_DRIFT_SHIFT))))
+        {
+            slot_period_q8 = (uint32_t)((int32_t)slot_period_q8 +
+                             (((int32_t)measured_q8 - (int32_t)slot_period_q8) >> SCAN_SLOT_PERIOD_FILTER_SHIFT));
+            scan_slot_stats.period_us = slot_period_q8 >> 8u;
+        }
+        else
+        {
+            scan_slot_stats.rejected++;
+        }
+    }
+
+    slot_epoch_us = epoch_us;
+    slot_synced = true;
+    scan_slot_stats.syncs++;
+}
+
+/*******************************************************************************
+* Function Name: scan_slot_sync
+********************************************************************************
+* Summary:
+*  Applies a sync sent by the host with HOST_CMD_SLOT_SYNC. The host numbers
+*  the periods, because the clock error of the board makes the number of
+*  periods between distant syncs ambiguous.
+*
+* Parameters:
+*  epoch_us - device time of the start of the period
+*  period_index - number of the period, counted by the host
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void scan_slot_sync(uint32_t epoch_us, uint16_t period_index)
+{
+    uint32_t intr_state = Cy_SysLib_EnterCriticalSection();
+
+    scan_slot_track(epoch_us, (uint16_t)(period_index - slot_period_index));
+    slot_period_index = period_index;
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+}
+
+/*******************************************************************************
+* Function Name: scan_slot_configure
+********************************************************************************
+* Summary:
+*  Assigns the slot of this board.
+*
+* Parameters:
+*  slot - slot of this board, counted from the start of the period
+*  count - number of slots per period
+*
+* Return:
+*  bool - false if the slot does not exist
+*
+*******************************************************************************/
+bool scan_slot_configure(uint32_t slot, uint32_t count)
+{
+    uint32_t intr_state;
+
+    if ((0u == count) || (slot >= count))
+    {
+        return false;
+    }
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+    slot_id = slot;
+    slot_count = count;
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: scan_slot_wait
+********************************************************************************
+* Summary:
+*  Waits for the next start of the slot of this board. Call it right before
+*  starting the scan. A frame that takes longer than one period skips a slot,
+*  which is counted as an overrun.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void scan_slot_wait(void)
+{
+    uint32_t intr_state = Cy_SysLib_EnterCriticalSection();
+    uint32_t period_q8 = slot_period_q8;
+    uint32_t slot_start = slot_epoch_us + (((period_q8 * slot_id) / slot_count) >> 8u);
+    uint32_t period = period_q8 >> 8u;
+    uint32_t now;
+    uint32_t start;
+    int32_t since;
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    now = timestamp_get_us();
+    since = (int32_t)(now - slot_start);
+    if (since < 0)
+    {
+        start = now + ((uint32_t)(-since) % period);
+    }
+    else
+    {
+        /* A call exactly at a slot start takes that slot */
+        start = now + ((period - ((uint32_t)since % period)) % period);
+    }
+
+    if (slot_started && ((start - slot_last_start) > (period + (period / 2u))))
+    {
+        scan_slot_stats.overruns++;
+    }
+    slot_last_start = start;
+    slot_started = true;
+
+    /* SysTick wakes the CPU every millisecond, the rest is a busy wait */
+    while ((int32_t)(start - timestamp_get_us()) > (int32_t)SCAN_SLOT_SLEEP_MARGIN_US)
+    {
+        Cy_SysPm_CpuEnterSleep();
+    }
+    while ((int32_t)(start - timestamp_get_us()) > 0)
+    {
+    }
+}
+
+#if SCAN_SLOT_GPIO_EN
+/*******************************************************************************
+* Function Name: scan_slot_sync_isr
+********************************************************************************
+* Summary:
+*  Sync input interrupt handler. Time-stamps the rising edge first. Runs above
+*  the EZI2C priority, so it does not race with scan_slot_sync().
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void scan_slot_sync_isr(void)
+{
+    uint32_t now = timestamp_get_us();
+    uint32_t period = slot_period_q8 >> 8u;
+    uint32_t periods = ((now - slot_epoch_us) + (period / 2u)) / period;
+
+    Cy_GPIO_ClearInterrupt(SCAN_SLOT_SYNC_PORT, SCAN_SLOT_SYNC_PIN);
+
+    /* The edge comes every period, the count is only clear for short gaps */
+    scan_slot_track(now, (periods <= SCAN_SLOT_MAX_EDGE_PERIODS) ? periods : 0u);
+}
+#endif /* SCAN_SLOT_GPIO_EN */
+
+#endif /* SCAN_SLOT_EN */
+
+/* [] END OF FILE */
@@ -0,0 +1,126 @@
+/******************************************************************************
+* File Name: scan_slot.h
+*
+* Description: This file contains the interface of the time-division scan
+*              schedule shared by neighboring boards.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef SCAN_SLOT_H_
+#define SCAN_SLOT_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_pdl.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Enables scanning in an assigned slot of a schedule shared with other boards */
+#define SCAN_SLOT_EN                     (0u)
+
+/* Schedule period in microseconds, one frame per period */
+#define SCAN_SLOT_PERIOD_US              (10000u)
+
+/* Default number of slots per period and slot of this board. The host changes
+ * both with HOST_CMD_SET_SLOT.
+ */
+#define SCAN_SLOT_COUNT                  (4u)
+#define SCAN_SLOT_ID                     (0u)
+
+/* Largest accepted deviation of the measured period from the nominal one, as
+ * a right shift of the nominal period: 4 accepts 1/16, about 6%.
+ */
+#define SCAN_SLOT_MAX_DRIFT_SHIFT        (4u)
+
+/* Weight of a new period measurement, as a right shift */
+#define SCAN_SLOT_PERIOD_FILTER_SHIFT    (2u)
+
+/* Sync edges further apart than this many periods only restart the schedule.
+ * With a clock error below 1/16, 8 periods stay below half a period of error.
+ */
+#define SCAN_SLOT_MAX_EDGE_PERIODS       (8u)
+
+/* Enables the sync input: a rising edge marks the start of every period */
+#define SCAN_SLOT_GPIO_EN                (0u)
+
+/* Sync input pin, select a free pin of the board */
+#define SCAN_SLOT_SYNC_PORT              (GPIO_PRT2)
+#define SCAN_SLOT_SYNC_PIN               (0u)
+#define SCAN_SLOT_SYNC_IRQ               (ioss_interrupts_gpio_2_IRQn)
+
+/* The sync edge is time-stamped before the EZI2C and CapSense interrupts */
+#define SCAN_SLOT_SYNC_INTR_PRIORITY     (1u)
+
+#if SCAN_SLOT_EN
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Schedule tracking. period_us is the period measured in device time, which
+ * differs from the nominal one by the clock error of the board. phase_error_us
+ * is the distance of the last sync from its predicted time.
+ */
+typedef struct
+{
+    uint32_t syncs;
+    uint32_t rejected;
+    uint32_t overruns;
+    uint32_t period_us;
+    int32_t phase_error_us;
+} scan_slot_stats_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern scan_slot_stats_t scan_slot_stats;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void scan_slot_init(void);
+void scan_slot_sync(uint32_t epoch_us, uint16_t period_index);
+bool scan_slot_configure(uint32_t slot, uint32_t count);
+void scan_slot_wait(void);
+
+#endif /* SCAN_SLOT_EN */
+
+#endif /* SCAN_SLOT_H_ */
+
+/* [] END OF FILE */
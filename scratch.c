@@ -0,0 +1,160 @@
+/******************************************************************************
+* File Name: scratch.c
+*
+* Description: This file contains the scratch arena shared by calibration, burst
+*              scanning, processing and BIST. These phases never run at the same
+*              time, so their working buffers are borrowed from one statically
+*              sized arena instead of each owning static RAM.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "scratch.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* CY assert failure */
+#define CY_ASSERT_FAILED          (0u)
+
+#if SCRATCH_EN
+
+/*******************************************************************************
+* Build-time checks
+*******************************************************************************/
+_Static_assert(SCRATCH_CALIBRATION_SIZE <= SCRATCH_ARENA_SIZE, "Calibration scratch does not fit");
+_Static_assert(SCRATCH_SCAN_SIZE <= SCRATCH_ARENA_SIZE, "Scan scratch does not fit");
+_Static_assert(SCRATCH_PROCESSING_SIZE <= SCRATCH_ARENA_SIZE, "Processing scratch does not fit");
+_Static_assert(SCRATCH_BIST_SIZE <= SCRATCH_ARENA_SIZE, "BIST scratch does not fit");
+_Static_assert((SCRATCH_ARENA_SIZE % sizeof(uint32_t)) == 0u, "Arena size must be a multiple of 4 bytes");
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+static uint32_t scratch_arena[SCRATCH_ARENA_SIZE / sizeof(uint32_t)];
+
+/* Phase in progress and bytes handed out in it */
+static scratch_phase_t scratch_phase = SCRATCH_PHASE_NONE;
+static uint32_t scratch_used = 0u;
+
+/*******************************************************************************
+* Function Name: scratch_begin
+********************************************************************************
+* Summary:
+*  Starts a phase. Phases do not nest.
+*
+* Parameters:
+*  phase - phase to start
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void scratch_begin(scratch_phase_t phase)
+{
+    if (SCRATCH_PHASE_NONE != scratch_phase)
+    {
+        CY_ASSERT(CY_ASSERT_FAILED);
+    }
+
+    scratch_phase = phase;
+    scratch_used = 0u;
+}
+
+/*******************************************************************************
+* Function Name: scratch_alloc
+********************************************************************************
+* Summary:
+*  Borrows a zeroed, 4-byte aligned buffer until the end of the phase.
+*
+* Parameters:
+*  size - buffer size in bytes
+*
+* Return:
+*  void* - buffer
+*
+*******************************************************************************/
+void *scratch_alloc(uint32_t size)
+{
+    uint8_t *buf = &((uint8_t *)scratch_arena)[scratch_used];
+    uint32_t aligned = SCRATCH_ALIGN(size);
+    uint32_t i;
+
+    if ((SCRATCH_PHASE_NONE == scratch_phase) ||
+        (aligned > (SCRATCH_ARENA_SIZE - scratch_used)))
+    {
+        /* The phase size macros do not cover this allocation */
+        CY_ASSERT(CY_ASSERT_FAILED);
+    }
+
+    for (i = 0u; i < aligned; i++)
+    {
+        buf[i] = 0u;
+    }
+    scratch_used += aligned;
+
+    return buf;
+}
+
+/*******************************************************************************
+* Function Name: scratch_end
+********************************************************************************
+* Summary:
+*  Ends a phase and returns all its buffers to the arena.
+*
+* Parameters:
+*  phase - phase to end
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void scratch_end(scratch_phase_t phase)
+{
+    if (phase != scratch_phase)
+    {
+        CY_ASSERT(CY_ASSERT_FAILED);
+    }
+
+    scratch_phase = SCRATCH_PHASE_NONE;
+    scratch_used = 0u;
+}
+
+#endif /* SCRATCH_EN */
+
+/* [] END OF FILE */
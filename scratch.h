@@ -0,0 +1,112 @@
+/******************************************************************************
+* File Name: scratch.h
+*
+* Description: This file contains the interface of the shared scratch arena.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef SCRATCH_H_
+#define SCRATCH_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include "cy_pdl.h"
+#include "profiles.h"
+#include "burst.h"
+#include "common_mode.h"
+#include "startup.h"
+#include "param_batch.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* The arena is built when any of its users is enabled */
+#define SCRATCH_EN                       (PROFILES_EN || BURST_SCAN_EN || COMMON_MODE_EN || STARTUP_EN || \
+                                          PARAM_BATCH_EN)
+
+#define SCRATCH_MAX(a, b)                (((a) > (b)) ? (a) : (b))
+
+/* Rounds an allocation up to the arena alignment of 4 bytes */
+#define SCRATCH_ALIGN(size)              ((((uint32_t)(size)) + 3u) & ~3u)
+
+/* Scratch needed by each phase, the sum of what its users borrow. Every
+ * user declares its need in multiples of 4 bytes.
+ */
+#define SCRATCH_CALIBRATION_SIZE         (PROFILES_SCRATCH_SIZE + STARTUP_SCRATCH_SIZE)
+#define SCRATCH_SCAN_SIZE                (BURST_SCRATCH_SIZE)
+#define SCRATCH_PROCESSING_SIZE          (COMMON_MODE_SCRATCH_SIZE + PARAM_BATCH_SCRATCH_SIZE)
+#define SCRATCH_BIST_SIZE                (0u)
+
+/* Arena size, defaults to the peak phase. May be set to a fixed size in
+ * bytes on the compiler command line, the build then checks that every phase
+ * fits.
+ */
+#ifndef SCRATCH_ARENA_SIZE
+#define SCRATCH_ARENA_SIZE               (SCRATCH_MAX(SCRATCH_MAX(SCRATCH_CALIBRATION_SIZE, \
+                                                                  SCRATCH_SCAN_SIZE),       \
+                                                      SCRATCH_MAX(SCRATCH_PROCESSING_SIZE,  \
+                                                                  SCRATCH_BIST_SIZE)))
+#endif
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Phases that never run at the same time */
+typedef enum
+{
+    SCRATCH_PHASE_NONE = 0u,
+    SCRATCH_PHASE_CALIBRATION,
+    SCRATCH_PHASE_SCAN,
+    SCRATCH_PHASE_PROCESSING,
+    SCRATCH_PHASE_BIST
+} scratch_phase_t;
+
+#if SCRATCH_EN
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void scratch_begin(scratch_phase_t phase);
+void *scratch_alloc(uint32_t size);
+void scratch_end(scratch_phase_t phase);
+
+#endif /* SCRATCH_EN */
+
+#endif /* SCRATCH_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,240 @@
+/******************************************************************************
+* File Name: startup.c
+*
+* Description: This file contains the startup phase that seeds the baselines
+*              from a burst of scans and ramps the finger thresholds.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "startup.h"
+#include "scratch.h"
+#include "timestamp.h"
+
+#if STARTUP_EN
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+startup_stats_t startup_stats;
+
+/* Normal finger threshold of each widget and the value last written by the
+ * ramp. A widget whose threshold was changed by someone else, for example a
+ * profile switch, leaves the ramp.
+ */
+static uint16_t normal_th[CY_CAPSENSE_WIDGET_COUNT];
+static uint16_t ramp_th[CY_CAPSENSE_WIDGET_COUNT];
+static uint32_t ramp_frame = STARTUP_RAMP_FRAMES;
+
+/*******************************************************************************
+* Function Name: startup_seed_sensor
+********************************************************************************
+* Summary:
+*  Sorts the burst of one sensor and returns the mean of the samples left
+*  after dropping STARTUP_TRIM samples from each end. A disturbed first scan
+*  or a noise spike does not reach the baseline.
+*
+* Parameters:
+*  samples - STARTUP_SCANS raw counts, sorted in place
+*  spread - returns the range of the burst
+*
+* Return:
+*  uint16_t - baseline seed
+*
+*******************************************************************************/
+static uint16_t startup_seed_sensor(uint16_t *samples, uint16_t *spread)
+{
+    uint32_t sum = 0u;
+    uint16_t value;
+    uint32_t i;
+    uint32_t j;
+
+    for (i = 1u; i < STARTUP_SCANS; i++)
+    {
+        value = samples[i];
+        for (j = i; (j > 0u) && (samples[j - 1u] > value); j--)
+        {
+            samples[j] = samples[j - 1u];
+        }
+        samples[j] = value;
+    }
+
+    for (i = STARTUP_TRIM; i < (STARTUP_SCANS - STARTUP_TRIM); i++)
+    {
+        sum += samples[i];
+    }
+
+    *spread = (uint16_t)(samples[STARTUP_SCANS - 1u] - samples[0u]);
+
+    return (uint16_t)((sum + ((STARTUP_SCANS - (2u * STARTUP_TRIM)) >> 1u)) /
+                      (STARTUP_SCANS - (2u * STARTUP_TRIM)));
+}
+
+/*******************************************************************************
+* Function Name: startup_run
+********************************************************************************
+* Summary:
+*  Takes STARTUP_SCANS scans, seeds every baseline from the trimmed mean of
+*  its raw counts, and raises the finger thresholds for the ramp. Call once
+*  after Cy_CapSense_Enable() and before the first frame; the CSD block is
+*  idle on return.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  cy_capsense_status_t - status of the scans
+*
+*******************************************************************************/
+cy_capsense_status_t startup_run(void)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    cy_stc_capsense_sensor_context_t *sns_cxt;
+    cy_stc_capsense_widget_context_t *wd_cxt;
+    cy_capsense_status_t status = CY_CAPSENSE_STATUS_SUCCESS;
+    uint16_t *samples;
+    uint32_t start;
+    uint32_t sns_index;
+    uint32_t scan;
+    uint32_t wd;
+    uint32_t sns;
+
+    start = timestamp_get_cycles();
+
+    scratch_begin(SCRATCH_PHASE_CALIBRATION);
+    samples = (uint16_t *)scratch_alloc(STARTUP_SCRATCH_SIZE);
+
+    for (scan = 0u; (scan < STARTUP_SCANS) && (CY_CAPSENSE_STATUS_SUCCESS == status); scan++)
+    {
+        status = Cy_CapSense_ScanAllWidgets(&cy_capsense_context);
+        while (CY_CAPSENSE_BUSY == Cy_CapSense_IsBusy(&cy_capsense_context))
+        {
+        }
+
+        sns_index = 0u;
+        for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+        {
+            wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+
+            for (sns = 0u; sns < wd_cfg->numSns; sns++)
+            {
+                samples[(sns_index * STARTUP_SCANS) + scan] = wd_cfg->ptrSnsContext[sns].raw;
+                sns_index++;
+            }
+        }
+    }
+
+    if (CY_CAPSENSE_STATUS_SUCCESS == status)
+    {
+        sns_index = 0u;
+        for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+        {
+            wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+            wd_cxt = wd_cfg->ptrWdContext;
+
+            for (sns = 0u; sns < wd_cfg->numSns; sns++)
+            {
+                sns_cxt = &wd_cfg->ptrSnsContext[sns];
+                sns_cxt->bsln = startup_seed_sensor(&samples[sns_index * STARTUP_SCANS],
+                                                    &startup_stats.spread[sns_index]);
+                sns_cxt->bslnExt = 0u;
+                sns_cxt->negBslnRstCnt = 0u;
+                sns_index++;
+            }
+
+            normal_th[wd] = wd_cxt->fingerTh;
+            ramp_th[wd] = (uint16_t)(((uint32_t)wd_cxt->fingerTh * (100u + STARTUP_TH_BOOST_PERCENT)) / 100u);
+            wd_cxt->fingerTh = ramp_th[wd];
+        }
+
+        ramp_frame = 0u;
+    }
+
+    scratch_end(SCRATCH_PHASE_CALIBRATION);
+
+    startup_stats.seed_cycles = timestamp_get_cycles() - start;
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: startup_update
+********************************************************************************
+* Summary:
+*  Lowers the finger thresholds one step towards their normal values. Call
+*  before the widgets of each frame are processed.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void startup_update(void)
+{
+    cy_stc_capsense_widget_context_t *wd_cxt;
+    uint32_t boost;
+    uint32_t wd;
+
+    if (ramp_frame >= STARTUP_RAMP_FRAMES)
+    {
+        return;
+    }
+
+    ramp_frame++;
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        wd_cxt = cy_capsense_context.ptrWdConfig[wd].ptrWdContext;
+
+        if (wd_cxt->fingerTh == ramp_th[wd])
+        {
+            boost = ((uint32_t)normal_th[wd] * STARTUP_TH_BOOST_PERCENT *
+                     (STARTUP_RAMP_FRAMES - ramp_frame)) / (100u * STARTUP_RAMP_FRAMES);
+            ramp_th[wd] = (uint16_t)(normal_th[wd] + boost);
+            wd_cxt->fingerTh = ramp_th[wd];
+        }
+    }
+
+    startup_stats.ramp_frames = ramp_frame;
+}
+
+#endif /* STARTUP_EN */
+
+/* [] END OF FILE */
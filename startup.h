@@ -0,0 +1,115 @@
+/******************************************************************************
+* File Name: startup.h
+*
+* Description: This file contains the startup phase that seeds the baselines
+*              from a burst of scans and ramps the finger thresholds.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef STARTUP_H_
+#define STARTUP_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include "cy_pdl.h"
+#include "cycfg_capsense.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Enables baseline seeding and the threshold ramp at power-up */
+#define STARTUP_EN                       (0u)
+
+/* Scans taken before the first frame, must be even */
+#define STARTUP_SCANS                    (16u)
+
+/* Samples dropped from each end of the sorted burst before averaging */
+#define STARTUP_TRIM                     (4u)
+
+/* Frames over which the finger threshold ramps down to its normal value */
+#define STARTUP_RAMP_FRAMES              (100u)
+
+/* Finger threshold increase at the first frame, in percent */
+#define STARTUP_TH_BOOST_PERCENT         (50u)
+
+#if STARTUP_EN
+
+#if (STARTUP_SCANS & 1u) != 0u
+#error "STARTUP_SCANS must be even"
+#endif
+
+#if (2u * STARTUP_TRIM) >= STARTUP_SCANS
+#error "STARTUP_TRIM leaves no samples to average"
+#endif
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Startup statistics. spread is the range of the raw counts of each sensor
+ * within the burst.
+ */
+typedef struct
+{
+    uint32_t seed_cycles;
+    uint32_t ramp_frames;
+    uint16_t spread[CY_CAPSENSE_SENSOR_COUNT];
+} startup_stats_t;
+
+/* Calibration scratch: the raw counts of the burst */
+#define STARTUP_SCRATCH_SIZE             (STARTUP_SCANS * CY_CAPSENSE_SENSOR_COUNT * sizeof(uint16_t))
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern startup_stats_t startup_stats;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+cy_capsense_status_t startup_run(void);
+void startup_update(void);
+
+#else
+
+#define STARTUP_SCRATCH_SIZE             (0u)
+
+#endif /* STARTUP_EN */
+
+#endif /* STARTUP_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,260 @@
+/******************************************************************************
+* File Name: timestamp.c
+*
+* Description: This file contains the SysTick based free-running timestamp.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "timestamp.h"
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+volatile uint32_t timestamp_ms = 0u;
+
+uint32_t timestamp_cycles_per_ms = 0u;
+
+/* CPU cycles per microsecond */
+static uint32_t timestamp_cycles_per_us = 0u;
+
+/* Cycles of the SysTick period in progress when the stall began */
+static uint32_t stall_phase = 0u;
+
+#if RTOS_EN
+/* SysTick handler of the kernel, restored when the scheduler starts */
+static cy_israddress kernel_systick_isr = NULL;
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void timestamp_systick_isr(void);
+
+/*******************************************************************************
+* Function Name: timestamp_init
+********************************************************************************
+* Summary:
+*  Starts SysTick from the CPU clock with a 1 ms period. Must be called after
+*  cybsp_init() so that SystemCoreClock holds the final CPU frequency.
+*  With RTOS_EN the counter runs with its own handler until
+*  timestamp_start_kernel_tick() gives SysTick to the kernel, so the time
+*  stamps taken during initialization are valid.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void timestamp_init(void)
+{
+    timestamp_cycles_per_ms = SystemCoreClock / TIMESTAMP_TICKS_PER_SEC;
+    timestamp_cycles_per_us = SystemCoreClock / 1000000u;
+    timestamp_ms = 0u;
+
+#if RTOS_EN
+    kernel_systick_isr = Cy_SysInt_SetVector(SysTick_IRQn, timestamp_systick_isr);
+#else
+    (void)Cy_SysInt_SetVector(SysTick_IRQn, timestamp_systick_isr);
+#endif
+    NVIC_SetPriority(SysTick_IRQn, TIMESTAMP_INTR_PRIORITY);
+
+    SysTick->CTRL = 0u;
+    SysTick->LOAD = timestamp_cycles_per_ms - 1u;
+    SysTick->VAL = 0u;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk |
+                    SysTick_CTRL_ENABLE_Msk;
+}
+
+#if RTOS_EN
+/*******************************************************************************
+* Function Name: timestamp_start_kernel_tick
+********************************************************************************
+* Summary:
+*  Stops SysTick and restores the kernel handler. Must be called right before
+*  vTaskStartScheduler(), which starts SysTick again with the same period
+*  (configTICK_RATE_HZ); from then on the tick hook advances the counter. The
+*  counter keeps its value, the time up to the first kernel tick is lost.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void timestamp_start_kernel_tick(void)
+{
+    SysTick->CTRL = 0u;
+    SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+    (void)Cy_SysInt_SetVector(SysTick_IRQn, kernel_systick_isr);
+}
+#endif /* RTOS_EN */
+
+/*******************************************************************************
+* Function Name: timestamp_get_us
+********************************************************************************
+* Summary:
+*  Returns the microseconds elapsed since timestamp_init(). The value wraps
+*  after about 71 minutes.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - free-running microsecond count
+*
+*******************************************************************************/
+uint32_t timestamp_get_us(void)
+{
+    uint32_t ms;
+    uint32_t val;
+    uint32_t pending;
+
+    do
+    {
+        ms = timestamp_ms;
+        val = SysTick->VAL;
+        pending = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+    } while (ms != timestamp_ms);
+
+    if (0u != pending)
+    {
+        val = SysTick->VAL;
+        ms++;
+    }
+
+    return ((ms * 1000u) + ((timestamp_cycles_per_ms - 1u - val) / timestamp_cycles_per_us));
+}
+
+/*******************************************************************************
+* Function Name: timestamp_stall_begin
+********************************************************************************
+* Summary:
+*  Prepares SysTick to measure a call that blocks all interrupts for longer
+*  than a SysTick period, such as a flash row write. SysTick is reloaded with
+*  TIMESTAMP_STALL_LOAD, so no period ends during the call. Must be called
+*  with interrupts disabled, and followed by timestamp_stall_end() before they
+*  are enabled again. The time stamps are not valid in between.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void timestamp_stall_begin(void)
+{
+    stall_phase = timestamp_cycles_per_ms - 1u - SysTick->VAL;
+
+    SysTick->LOAD = TIMESTAMP_STALL_LOAD;
+    SysTick->VAL = 0u;
+}
+
+/*******************************************************************************
+* Function Name: timestamp_stall_end
+********************************************************************************
+* Summary:
+*  Ends the measurement started by timestamp_stall_begin() and restores the
+*  1 ms period. timestamp_ms advances by the periods that passed in the
+*  stall, rounded up, since no tick was serviced. The time stamps therefore
+*  never go backwards, and run ahead by less than 1 ms per stall.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - CPU cycles since timestamp_stall_begin()
+*
+*******************************************************************************/
+uint32_t timestamp_stall_end(void)
+{
+    uint32_t elapsed = TIMESTAMP_STALL_LOAD - SysTick->VAL;
+    uint32_t total = stall_phase + elapsed;
+
+    SysTick->LOAD = timestamp_cycles_per_ms - 1u;
+    SysTick->VAL = 0u;
+    timestamp_ms += (total + timestamp_cycles_per_ms - 1u) / timestamp_cycles_per_ms;
+
+    return elapsed;
+}
+
+/*******************************************************************************
+* Function Name: timestamp_systick_isr
+********************************************************************************
+* Summary:
+*  SysTick interrupt handler. Advances the millisecond counter. With RTOS_EN
+*  it runs until the scheduler starts.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void timestamp_systick_isr(void)
+{
+    timestamp_ms++;
+}
+
+#if RTOS_EN
+/*******************************************************************************
+* Function Name: vApplicationTickHook
+********************************************************************************
+* Summary:
+*  FreeRTOS tick hook. Advances the millisecond counter once the kernel owns
+*  SysTick.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void vApplicationTickHook(void)
+{
+    timestamp_ms++;
+}
+#endif /* RTOS_EN */
+
+/* [] END OF FILE */
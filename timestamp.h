@@ -0,0 +1,132 @@
+/******************************************************************************
+* File Name: timestamp.h
+*
+* Description: This file contains the free-running timestamp used to measure
+*              latencies and stamp frames.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef TIMESTAMP_H_
+#define TIMESTAMP_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include "cy_pdl.h"
+#include "rtos_tasks.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* SysTick interrupt rate. The tick also serves as the periodic wakeup source
+ * for the sleep based scanning modes.
+ */
+#define TIMESTAMP_TICKS_PER_SEC          (1000u)
+
+/* SysTick has the highest priority so that the millisecond counter stays
+ * coherent with the counter register inside the CapSense and EZI2C ISRs.
+ * With RTOS_EN the kernel runs SysTick at the lowest priority, the pending
+ * check in the readers covers one missed tick.
+ */
+#define TIMESTAMP_INTR_PRIORITY          (0u)
+
+/* SysTick reload while a stall is measured, the 24-bit counter maximum. A
+ * stall of up to 2^24 cycles (349 ms at 48 MHz) is measured exactly.
+ */
+#define TIMESTAMP_STALL_LOAD             (0x00FFFFFFuL)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Milliseconds elapsed since timestamp_init(), incremented by the SysTick ISR */
+extern volatile uint32_t timestamp_ms;
+
+/* CPU cycles per SysTick period */
+extern uint32_t timestamp_cycles_per_ms;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void timestamp_init(void);
+uint32_t timestamp_get_us(void);
+void timestamp_stall_begin(void);
+uint32_t timestamp_stall_end(void);
+#if RTOS_EN
+void timestamp_start_kernel_tick(void);
+#endif
+
+/*******************************************************************************
+* Function Name: timestamp_get_cycles
+********************************************************************************
+* Summary:
+*  Returns the CPU cycles elapsed since timestamp_init(). The value wraps after
+*  2^32 cycles (about 89 s at 48 MHz) and is intended for interval measurement.
+*  Safe to call from any ISR and with interrupts disabled.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - free-running cycle count
+*
+*******************************************************************************/
+__STATIC_INLINE uint32_t timestamp_get_cycles(void)
+{
+    uint32_t ms;
+    uint32_t val;
+    uint32_t pending;
+
+    do
+    {
+        ms = timestamp_ms;
+        val = SysTick->VAL;
+        pending = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+    } while (ms != timestamp_ms);
+
+    /* The counter reloaded but the ISR did not run yet */
+    if (0u != pending)
+    {
+        val = SysTick->VAL;
+        ms++;
+    }
+
+    return ((ms * timestamp_cycles_per_ms) + (timestamp_cycles_per_ms - 1u - val));
+}
+
+#endif /* TIMESTAMP_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""Builds the production tuning commands and exports the tuning record of a board.
+
+Production sequence, one mailbox command at a time, each written as the
+payload at offset 1 and then the command byte at offset 0. Poll the status
+block until the command is DONE before the next step:
+
+    1. HOST_CMD_TUNE_WINDOW 0    no-touch window, fixture finger away
+    2. HOST_CMD_TUNE_WINDOW 1    touch window, fixture finger on the sensors;
+                                 repeat for groups of sensors if needed
+    3. HOST_CMD_TUNE_APPLY       derive, apply and program the thresholds
+    4. read the register map and run this script on the dump
+
+The record has one line per widget with the derived parameters and the
+measured signal and noise, prefixed with the board serial number given on the
+command line.
+
+Usage:
+    autotune.py --commands
+    autotune.py dump.bin --serial SN1234 [--csv record.csv]
+"""
+
+import argparse
+import os
+import sys
+
+import hostregs
+
+CMD_TUNE_WINDOW = 0x0C
+CMD_TUNE_APPLY = 0x0D
+
+RESULTS = {
+    0: "none",
+    1: "applied",
+    2: "no no-touch window",
+    3: "sensor not touched",
+    4: "SNR too low",
+    5: "flash error",
+}
+
+FIELDS = ("serial", "widget", "result", "signal", "noise_pp", "snr", "finger_th", "noise_th",
+          "nnoise_th", "hysteresis", "on_debounce", "low_bsln_rst")
+
+
+def read_record(regs):
+    offset = regs.block(hostregs.BLOCK_AUTOTUNE)
+    if offset is None:
+        raise ValueError("the firmware was built without AUTOTUNE_EN")
+
+    window, result, bad, sensors, widgets, _, frames = regs.unpack("BBBBBBH", offset)
+    offset += 8
+    idle = regs.unpack("%dH" % sensors, offset)
+    noise = regs.unpack("%dH" % sensors, offset + 2 * sensors)
+    signal = regs.unpack("%dH" % sensors, offset + 4 * sensors)
+    offset += 6 * sensors
+    widget_signal = regs.unpack("%dH" % widgets, offset)
+    widget_noise = regs.unpack("%dH" % widgets, offset + 2 * widgets)
+    offset += 4 * widgets
+    params = [regs.unpack("BBHHHHH", offset + 12 * w) for w in range(widgets)]
+    return result, bad, widget_signal, widget_noise, params
+
+
+def commands():
+    """Mailbox writes of the sequence as (offset, bytes) pairs."""
+    return [
+        ("no-touch window", [(1, bytes([1, 1, 0, 0])), (0, bytes([CMD_TUNE_WINDOW]))]),
+        ("touch window", [(1, bytes([2, 1, 0, 1])), (0, bytes([CMD_TUNE_WINDOW]))]),
+        ("apply", [(1, bytes([3, 0, 0])), (0, bytes([CMD_TUNE_APPLY]))]),
+    ]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dump", nargs="?", help="binary dump of the register map")
+    parser.add_argument("--serial", default="", help="board serial number for the record")
+    parser.add_argument("--csv", default=None, help="append the record to this file")
+    parser.add_argument("--commands", action="store_true", help="print the mailbox writes")
+    args = parser.parse_args()
+
+    if args.commands:
+        for name, writes in commands():
+            print("%-16s " % name + "  ".join("@%d: %s" % (o, d.hex(" ")) for o, d in writes))
+        return
+    if args.dump is None:
+        parser.error("give a dump or --commands")
+
+    try:
+        result, bad, signal, noise, params = read_record(hostregs.load(args.dump))
+    except ValueError as err:
+        sys.exit(str(err))
+
+    rows = []
+    for w, (_, debounce, finger, nth, nnth, hyst, lbr) in enumerate(params):
+        sig = signal[w]
+        pp = noise[w]
+        if result != 1:
+            finger = nth = nnth = hyst = debounce = lbr = ""
+        rows.append((args.serial, w, RESULTS.get(result, str(result)), sig, pp,
+                     "%.1f" % (sig / pp) if pp else "-", finger, nth, nnth, hyst, debounce, lbr))
+
+    if result != 1:
+        print("result: %s%s" % (RESULTS.get(result, result), ", widget %d" % (bad - 1) if bad else ""),
+              file=sys.stderr)
+
+    if args.csv:
+        new = not os.path.exists(args.csv)
+        with open(args.csv, "a") as f:
+            if new:
+                f.write(",".join(FIELDS) + "\n")
+            for row in rows:
+                f.write(",".join(str(v) for v in row) + "\n")
+    else:
+        print(",".join(FIELDS))
+        for row in rows:
+            print(",".join(str(v) for v in row))
+
+    sys.exit(0 if result == 1 else 1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""Reports the benchmark block of register map dumps and fits a per-sensor cost.
+
+Build the firmware with BENCH_EN. It runs synthetic frames instead of scans
+and publishes the cycle counts of each stage every BENCH_FRAMES frames. Select
+the virtual sensor count with HOST_CMD_BENCH_SENSORS, wait for the next
+result, and save a dump. With dumps at two or more sensor counts, the script
+fits cycles = fixed + per_sensor * sensors for every stage and prints the
+timing_sim.c parameters for a given sensor count.
+
+Stage times are corrected for the cost of the stage marks. Frame rates count
+processing only; the scan time adds to the frame period.
+
+Usage:
+    bench.py dump16.bin dump64.bin [--sensors 48]
+"""
+
+import argparse
+import sys
+
+import hostregs
+
+STAGES = ("filter", "process", "telemetry", "host")
+
+
+def read_bench(regs):
+    offset = regs.block(hostregs.BLOCK_BENCH)
+    if offset is None:
+        raise ValueError("the firmware was built without BENCH_EN")
+
+    seq, clock_hz, sensors, passes, frames, mark = regs.unpack("IIHHHH", offset)
+    values = regs.unpack("%dI" % (2 * len(STAGES) + 5), offset + 16)
+    if seq == 0:
+        raise ValueError("no result yet, read again after BENCH_FRAMES frames")
+    if seq != values[-1]:
+        raise ValueError("torn read, the block changed during the transfer")
+
+    n = len(STAGES)
+    marks = [passes] * (n - 1) + [1]
+    return {
+        "clock_hz": clock_hz,
+        "sensors": sensors,
+        "frames": frames,
+        "mean": [max(0, v - m * mark) for v, m in zip(values[:n], marks)],
+        "max": [max(0, v - m * mark) for v, m in zip(values[n:2 * n], marks)],
+        "frame_max": values[2 * n + 1],
+        "fps_mean": values[2 * n + 2],
+        "fps_min": values[2 * n + 3],
+    }
+
+
+def fit(points):
+    """Least squares line through (sensors, cycles) points."""
+    n = len(points)
+    sx = sum(x for x, _ in points)
+    sy = sum(y for _, y in points)
+    sxx = sum(x * x for x, _ in points)
+    sxy = sum(x * y for x, y in points)
+    den = n * sxx - sx * sx
+    if den == 0:
+        return None
+    slope = (n * sxy - sx * sy) / den
+    return (sy - slope * sx) / n, slope
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dumps", nargs="+", help="binary dumps of the register map")
+    parser.add_argument("--sensors", type=int, default=None,
+                        help="sensor count for the timing_sim.c parameters")
+    args = parser.parse_args()
+
+    results = []
+    for path in args.dumps:
+        try:
+            results.append(read_bench(hostregs.load(path)))
+        except ValueError as err:
+            sys.exit("%s: %s" % (path, err))
+    results.sort(key=lambda r: r["sensors"])
+
+    print("sensors  frames  " + "  ".join("%9s" % s for s in STAGES) + "  frame_max  fps_mean  fps_min")
+    for r in results:
+        print("%7d  %6d  " % (r["sensors"], r["frames"]) +
+              "  ".join("%9d" % v for v in r["mean"]) +
+              "  %9d  %8d  %7d" % (r["frame_max"], r["fps_mean"], r["fps_min"]))
+
+    if len({r["sensors"] for r in results}) < 2:
+        return
+
+    print()
+    print("stage      fixed  per_sensor (cycles)")
+    lines = []
+    for i, name in enumerate(STAGES):
+        lines.append(fit([(r["sensors"], r["mean"][i]) for r in results]))
+        print("%-9s %6.0f  %10.1f" % (name, lines[i][0], lines[i][1]))
+
+    if args.sensors is not None:
+        n = args.sensors
+        process = sum(lines[i][0] + lines[i][1] * n for i in range(3))
+        host = lines[3][0] + lines[3][1] * n
+        clock_hz = results[0]["clock_hz"]
+        print()
+        print("%d sensors: %.0f cycles per frame, %.0f frames/s without scan time" %
+              (n, process + host, clock_hz / (process + host)))
+        print("make -C tools/rtos_posix timing_sim SENSORS=%d" % n)
+        print("timing_sim process_cycles=%.0f tuner_cycles=%.0f" % (process, host))
+
+
+if __name__ == "__main__":
+    main()
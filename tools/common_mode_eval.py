@@ -0,0 +1,365 @@
+#!/usr/bin/env python3
+"""Measures the SNR gain of the common-mode rejection stage per scan resolution.
+
+The capture is a CSV file with one raw count column per sensor at the
+resolution of the design, for example a raw count log of the CAPSENSE Tuner,
+or a synthetic capture with correlated supply noise and touches. Lower
+resolutions are derived from it as in tools/kalman_eval.py: one step halves
+the raw counts, and with them the touch signal and the supply noise, while
+the uncorrelated noise of each sensor drops by the square root of 2 only, so
+that part is added back. Each resolution goes through a model of the baseline
+and touch processing of this design with thresholds scaled to the
+resolution, with and without the stage:
+
+    none        raw counts as scanned
+    cm          the fast part of the estimate of common_mode.c subtracted
+                from all sensors
+
+The reference touch state is the capture at the design resolution without
+the stage. For every case the script reports the SNR (mean touch signal over
+peak-to-peak noise in 512-frame blocks without touch, against the model
+baseline), the delay of touch onsets against the reference, touches without
+a reference touch, missed touches, the share of corrected frames, and the
+largest deviation from the baseline that a sensor with a touch held or
+developing contributed to an estimate.
+The last lines give the lowest resolution that reaches the SNR of the design
+resolution without the stage, and the conversion time it saves.
+
+Usage:
+    common_mode_eval.py --synthetic [--frames 200000]
+    common_mode_eval.py capture.csv [--columns 1,2] [--steps 3]
+"""
+
+import argparse
+import csv
+import math
+import random
+
+# Widget parameters of design.cycapsense, at RESOLUTION
+RESOLUTION = 10
+FINGER_TH = 80
+HYSTERESIS = 10
+NOISE_TH = 40
+NNOISE_TH = 40
+LOW_BSLN_RST = 30
+ON_DEBOUNCE = 3
+
+# Conversion time, as in tools/rtos_posix/sim_hw.c
+MOD_CLK_HZ = 48e6
+INIT_MOD_CYCLES = 10
+
+# common_mode.h
+MIN_SENSORS = 2
+SPREAD_TH = 20
+LEVEL_SHIFT = 4
+
+# Frames before a reference touch onset in which the touch develops
+PULL_FRAMES = 40
+
+
+class Sensor:
+    """Baseline and touch processing, as in tools/kalman_eval.py, with the
+    difference count of the last frame kept for the common-mode stage."""
+
+    def __init__(self, first, scale):
+        self.bsln_q8 = first << 8
+        self.neg = 0
+        self.debounce = 0
+        self.touched = False
+        self.diff = 0
+        self.max_raw = int(((1 << RESOLUTION) - 1) * scale)
+        self.finger_th = FINGER_TH * scale
+        self.hysteresis = HYSTERESIS * scale
+        self.noise_th = NOISE_TH * scale
+        self.nnoise_th = NNOISE_TH * scale
+
+    def bsln(self):
+        return self.bsln_q8 >> 8
+
+    def process(self, raw):
+        bsln = self.bsln_q8 >> 8
+        diff = 0
+        if raw > bsln:
+            diff = raw - bsln
+            self.neg = 0
+            if diff < self.noise_th:
+                self.bsln_q8 += ((raw << 8) - self.bsln_q8) >> 8
+        elif bsln - raw > self.nnoise_th:
+            self.neg += 1
+            if self.neg >= LOW_BSLN_RST:
+                self.bsln_q8 = raw << 8
+                self.neg = 0
+        else:
+            self.neg = 0
+            self.bsln_q8 -= (self.bsln_q8 - (raw << 8)) >> 8
+
+        if self.touched:
+            if diff < self.finger_th - self.hysteresis:
+                self.touched = False
+        elif diff >= self.finger_th + self.hysteresis:
+            self.debounce += 1
+            if self.debounce >= ON_DEBOUNCE:
+                self.touched = True
+                self.debounce = 0
+        else:
+            self.debounce = 0
+        self.diff = diff
+        return bsln
+
+
+def c_div(a, b):
+    """Integer division that truncates toward zero, as in C."""
+    q = abs(a) // abs(b)
+    return q if (a >= 0) == (b >= 0) else -q
+
+
+class CommonMode:
+    """common_mode_run() of common_mode.c."""
+
+    def __init__(self):
+        self.level_q8 = 0
+        self.used = []
+
+    def run(self, sensors, raws):
+        """Returns the correction in raw counts."""
+        estimate, self.used = self.estimate(sensors, raws)
+        if estimate is None:
+            return 0
+        self.level_q8 += c_div(estimate * 256 - self.level_q8, 1 << LEVEL_SHIFT)
+        return estimate - c_div(self.level_q8, 256)
+
+    @staticmethod
+    def estimate(sensors, raws):
+        """The shift in raw counts, None if there is no estimate, and the
+        sensors and deviations that went into it."""
+        devs = []
+        for i, (sensor, raw) in enumerate(zip(sensors, raws)):
+            dev = raw - sensor.bsln()
+            # A debouncing sensor is above the noise threshold
+            if not sensor.touched and sensor.diff <= sensor.noise_th and dev <= sensor.noise_th:
+                devs.append((dev, i))
+        devs.sort()
+        count = len(devs)
+        if count < MIN_SENSORS:
+            return None, []
+        median = c_div(devs[(count - 1) // 2][0] + devs[count // 2][0], 2)
+        agree = [(d, i) for d, i in devs if abs(d - median) <= SPREAD_TH]
+        if len(agree) < MIN_SENSORS or 2 * len(agree) <= count:
+            return None, []
+        return c_div(sum(d for d, _ in agree), len(agree)), agree
+
+
+def synthetic(frames, sensors, rng):
+    """Touches as in tools/kalman_eval.py, uncorrelated noise of 2 counts per
+    sensor, and supply noise common to all sensors: 4 counts RMS with bursts
+    of 20 counts RMS for 1 % of the frames."""
+    max_raw = (1 << RESOLUTION) - 1
+    supply = []
+    burst = 0
+    for f in range(frames):
+        if burst == 0 and rng.random() < 1.0 / 5000:
+            burst = 50
+        supply.append(rng.gauss(0.0, 20.0 if burst > 0 else 4.0))
+        burst = max(0, burst - 1)
+    columns = []
+    for _ in range(sensors):
+        column = []
+        touch_left = 0
+        level = 0.0
+        amp = 0.0
+        for f in range(frames):
+            if touch_left == 0 and rng.random() < 1.0 / 4000:
+                touch_left = rng.randint(200, 4000)
+                amp = rng.uniform(110.0, 200.0)
+            target = amp if touch_left > 0 else 0.0
+            touch_left = max(0, touch_left - 1)
+            level += (target - level) / 40.0
+            value = 870.0 + 20.0 * math.sin(f / 50000.0) + level + supply[f] + rng.gauss(0.0, 2.0)
+            column.append(int(min(max_raw, max(0, value))))
+        columns.append(column)
+    return columns
+
+
+def changes(column, references):
+    """Frame-to-frame changes of a sensor, None where any sensor is touched."""
+    return [column[i] - column[i - 1] if not any(r[i] or r[i - 1] for r in references) else None
+            for i in range(1, len(column))]
+
+
+def own_sigma(columns, references):
+    """RMS of the noise of each sensor that is not shared with the others:
+    the variance of its changes less their mean covariance with the other
+    sensors."""
+    deltas = [changes(c, references) for c in columns]
+    sigmas = []
+    for i, di in enumerate(deltas):
+        pairs = [(a, b) for j, dj in enumerate(deltas) if j != i
+                 for a, b in zip(di, dj) if a is not None]
+        own = [a for a in di if a is not None]
+        var = sum(a * a for a in own) / (2.0 * len(own)) if own else 1.0
+        cov = sum(a * b for a, b in pairs) / (2.0 * len(pairs)) if pairs else 0.0
+        sigmas.append(math.sqrt(max(var - cov, 0.0)))
+    return sigmas
+
+
+def reduce(column, steps, sigma, rng):
+    """The capture at `steps` resolution steps lower."""
+    if steps == 0:
+        return list(column)
+    scale = 1.0 / (1 << steps)
+    extra = sigma * math.sqrt(scale - scale * scale)
+    return [max(0, int(round(v * scale + rng.gauss(0.0, extra)))) for v in column]
+
+
+def run(columns, scale, stage):
+    """Touch states and difference counts of all sensors, the corrections, and
+    the sensors and deviations of every estimate."""
+    sensors = [Sensor(c[0], scale) for c in columns]
+    states = [[] for _ in columns]
+    diffs = [[] for _ in columns]
+    corrections = []
+    used = []
+    stage = CommonMode() if stage else None
+    for raws in zip(*columns):
+        cm = stage.run(sensors, raws) if stage else 0
+        corrections.append(cm)
+        used.append(stage.used if stage else [])
+        for i, (sensor, raw) in enumerate(zip(sensors, raws)):
+            raw = min(max(raw - cm, 0), sensor.max_raw)
+            bsln = sensor.process(raw)
+            states[i].append(sensor.touched)
+            diffs[i].append(raw - bsln)
+    return states, diffs, corrections, used
+
+
+def edges(states, value):
+    return [i for i in range(1, len(states)) if states[i] == value and states[i - 1] != value]
+
+
+def compare(reference, states):
+    onset = []
+    found = edges(states, True)
+    ref_on = edges(reference, True)
+    for r in ref_on:
+        match = [e for e in found if -50 < e - r < 400]
+        if match:
+            onset.append(min(match, key=lambda e: abs(e - r)) - r)
+    false_touches = sum(1 for e in found
+                        if not reference[e] and not any(-50 < e - r < 400 for r in ref_on))
+    return onset, false_touches, len(ref_on) - len(onset)
+
+
+def snr(reference, diffs):
+    """As in tools/kalman_eval.py."""
+    far = [True] * len(reference)
+    for i, touched in enumerate(reference):
+        if touched:
+            for j in range(max(0, i - 400), min(len(far), i + 401)):
+                far[j] = False
+    blocks = []
+    block = []
+    for i, d in enumerate(diffs):
+        if far[i]:
+            block.append(d)
+            if len(block) == 512:
+                blocks.append(max(block) - min(block))
+                block = []
+    signal = [diffs[i] for i in range(100, len(diffs)) if all(reference[i - 100:i + 1])]
+    if not blocks or not signal:
+        return 0.0, 0.0
+    noise = sum(blocks) / len(blocks)
+    return sum(signal) / len(signal) / max(noise, 1), noise
+
+
+def touch_dev(references, used):
+    """Largest deviation that went into an estimate from a sensor whose touch
+    is held or develops: its reference touch is on, or turns on within the
+    next PULL_FRAMES frames."""
+    largest = 0
+    for sns, reference in enumerate(references):
+        window = [False] * len(reference)
+        for i, touched in enumerate(reference):
+            if touched:
+                for j in range(max(0, i - PULL_FRAMES), i + 1):
+                    window[j] = True
+        for frame_used, w in zip(used, window):
+            if w:
+                largest = max([largest] + [d for d, i in frame_used if i == sns])
+    return largest
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", nargs="?", help="CSV with raw counts")
+    parser.add_argument("--columns", default=None, help="raw count columns, default all")
+    parser.add_argument("--synthetic", action="store_true")
+    parser.add_argument("--frames", type=int, default=200000)
+    parser.add_argument("--sensors", type=int, default=2)
+    parser.add_argument("--steps", type=int, default=3, help="resolution steps below RESOLUTION")
+    parser.add_argument("--overhead-us", type=float, default=179.0,
+                        help="frame time besides the conversions")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    if args.synthetic:
+        columns = synthetic(args.frames, args.sensors, rng)
+    elif args.capture:
+        with open(args.capture) as f:
+            rows = [r for r in csv.reader(f) if r and r[0].strip().lstrip("-").isdigit()]
+        picks = [int(c) for c in args.columns.split(",")] if args.columns else range(len(rows[0]))
+        columns = [[int(r[c]) for r in rows] for c in picks]
+    else:
+        parser.error("give a capture file or --synthetic")
+    if len(columns) < MIN_SENSORS:
+        parser.error("the stage needs at least %d sensors" % MIN_SENSORS)
+
+    references = run(columns, 1, False)[0]
+    sigmas = own_sigma(columns, references)
+
+    print("%d sensors, %d frames, %d reference touches, uncorrelated noise %s counts RMS at %d bits" %
+          (len(columns), len(columns[0]), sum(len(edges(r, True)) for r in references),
+           "/".join("%.1f" % s for s in sigmas), RESOLUTION))
+    print("bits stage scan_us frame_us   SNR  noise_pp  onset_mean/max  false  missed"
+          "  corrected  touch_dev")
+    results = []
+    for steps in range(args.steps + 1):
+        bits = RESOLUTION - steps
+        scale = 1.0 / (1 << steps)
+        scan_us = len(columns) * ((1 << bits) - 1 + INIT_MOD_CYCLES) / MOD_CLK_HZ * 1e6
+        reduced = [reduce(c, steps, s, rng) for c, s in zip(columns, sigmas)]
+        for stage in (False, True):
+            states, diffs, corrections, used = run(reduced, scale, stage)
+            onset, snrs, noises = [], [], []
+            false_touches = missed = 0
+            for reference, sns_states, sns_diffs in zip(references, states, diffs):
+                on, f, m = compare(reference, sns_states)
+                onset += on
+                false_touches += f
+                missed += m
+                s, n = snr(reference, sns_diffs)
+                snrs.append(s)
+                noises.append(n)
+            corrected = 100.0 * sum(1 for cm in corrections if cm != 0) / len(corrections)
+            pull = touch_dev(references, used)
+            results.append((bits, stage, min(snrs), scan_us))
+            print("%4d %-5s %7.1f %8.1f %5.1f %9.1f %7.2f/%-6d %6d %7d %9.1f%% %10d" %
+                  (bits, "cm" if stage else "none", scan_us, args.overhead_us + scan_us,
+                   min(snrs), max(noises), sum(onset) / len(onset) if onset else 0.0,
+                   max(onset or [0]), false_touches, missed, corrected, pull))
+
+    base = results[0]
+    print("SNR gain per resolution: %s" %
+          ", ".join("%d bits %.2fx" % (r[0], r[2] / max(n[2], 0.01))
+                    for n, r in zip(results[0::2], results[1::2])))
+    lowest = min((r for r in results if r[1] and r[2] >= base[2]), key=lambda r: r[0], default=None)
+    if lowest is None:
+        print("no resolution with the stage reaches SNR %.1f of %d bits without it" %
+              (base[2], base[0]))
+    else:
+        print("%d bits with the stage reach SNR %.1f of %d bits without it, %.1f us less conversion "
+              "per frame" % (lowest[0], base[2], base[0], base[3] - lowest[3]))
+
+
+if __name__ == "__main__":
+    main()
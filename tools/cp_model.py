@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""Compares the calibration-state Cp estimate of cp_estimate.c with the true Cp.
+
+A behavioral model of a CSD conversion: the modulator capacitor is charged
+by the modulator IDAC while the comparator reports it below Vref and by the
+compensation IDAC all the time, and every sense clock period the sensor
+removes a charge packet of Cp * Vref. The raw count is the number of
+modulator clock periods with the modulator IDAC on in a window of
+2^resolution - 1 periods. IDAC auto-calibration is modeled as a bisection of
+the modulator code towards 85 percent of the maximum raw count, with the
+compensation code set to half of the uncompensated modulator code, and the
+gain raised when the code would exceed 127.
+
+Each board gets random IDAC gain and Vref errors within the tolerances and a
+random integral nonlinearity per IDAC code. BIST is taken as exact, so the
+reported errors are those of the estimate alone:
+
+    nominal     estimate with the nominal constants, as after reset
+    pinned      estimate scaled by one BIST at the calibration point and then
+                tracking Cp through the baseline, without recalibration
+    recal       like pinned, but after recalibrating at the new Cp, so the
+                IDAC codes change
+
+The tolerances are assumptions, not datasheet limits; pass the figures of
+the device in use.
+
+Usage:
+    cp_model.py [--boards 200] [--gain-tol 0.1] [--vref-tol 0.02] [--inl 1.0]
+"""
+
+import argparse
+import random
+
+F_MOD = 48e6
+SNS_DIV = 12
+VREF = 1.219
+CMOD = 2.2e-9
+RESOLUTION = 10
+TARGET = 0.85
+CODE_MAX = 127
+GAINS = [37.5e-9, 75e-9, 300e-9, 600e-9, 2400e-9, 4800e-9]
+MAX_RAW = (1 << RESOLUTION) - 1
+
+
+class Board:
+    def __init__(self, rng, args):
+        self.gain_err = 1.0 + rng.uniform(-args.gain_tol, args.gain_tol)
+        self.vref = VREF * (1.0 + rng.uniform(-args.vref_tol, args.vref_tol))
+        self.inl = [0.0] + [rng.uniform(-args.inl, args.inl) for _ in range(CODE_MAX)]
+
+    def current(self, code, gain):
+        return (code + self.inl[code]) * GAINS[gain] * self.gain_err if code else 0.0
+
+    def convert(self, cp, mod, comp, gain):
+        i_mod = self.current(mod, gain)
+        i_comp = self.current(comp, gain)
+        dt = 1.0 / F_MOD
+        packet = cp * self.vref / CMOD
+        v = self.vref
+        count = 0
+        # The second window is taken, the first one settles Cmod
+        for _ in range(2):
+            count = 0
+            for t in range(MAX_RAW):
+                on = v < self.vref
+                count += on
+                v += (i_mod * on + i_comp) * dt / CMOD
+                if t % SNS_DIV == SNS_DIV - 1:
+                    v -= packet
+        return count
+
+    def bisect(self, cp, comp, gain):
+        lo, hi = 1, CODE_MAX
+        while lo < hi:
+            mid = (lo + hi) // 2
+            if self.convert(cp, mid, comp, gain) <= TARGET * MAX_RAW:
+                hi = mid
+            else:
+                lo = mid + 1
+        return lo
+
+    def calibrate(self, cp):
+        for gain in range(len(GAINS)):
+            mod = self.bisect(cp, 0, gain)
+            if mod < CODE_MAX:
+                break
+        comp = mod // 2
+        mod = self.bisect(cp, comp, gain)
+        return mod, comp, gain
+
+
+def estimate(raw, mod, comp, gain):
+    """cp_estimate.c with the nominal constants, in farads."""
+    f_sw = F_MOD / SNS_DIV
+    return (raw * mod * GAINS[gain] / MAX_RAW + comp * GAINS[gain]) / (VREF * f_sw)
+
+
+def stats(errors):
+    errors = sorted(abs(e) for e in errors)
+    mean = sum(errors) / len(errors)
+    return mean, errors[int(0.95 * (len(errors) - 1))], errors[-1]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--boards", type=int, default=200)
+    parser.add_argument("--gain-tol", type=float, default=0.10, help="IDAC gain error, fraction")
+    parser.add_argument("--vref-tol", type=float, default=0.02, help="Vref error, fraction")
+    parser.add_argument("--inl", type=float, default=1.0, help="IDAC INL, LSB")
+    parser.add_argument("--cp-min", type=float, default=5.0, help="pF")
+    parser.add_argument("--cp-max", type=float, default=40.0, help="pF")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    drifts = (-0.20, -0.10, -0.05, 0.05, 0.10)
+    nominal = []
+    per_count = []
+    pinned = {d: [] for d in drifts}
+    recal = {d: [] for d in drifts}
+    saturated = {d: 0 for d in drifts}
+
+    for _ in range(args.boards):
+        board = Board(rng, args)
+        cp = rng.uniform(args.cp_min, args.cp_max) * 1e-12
+        mod, comp, gain = board.calibrate(cp)
+        est = estimate(board.convert(cp, mod, comp, gain), mod, comp, gain)
+        nominal.append(est / cp - 1.0)
+        raw = board.convert(cp, mod, comp, gain)
+        per_count.append(estimate(raw + 1, mod, comp, gain) / estimate(raw, mod, comp, gain) - 1.0)
+        scale = cp / est
+
+        for d in drifts:
+            cp2 = cp * (1.0 + d)
+            raw = board.convert(cp2, mod, comp, gain)
+            if raw >= MAX_RAW or raw == 0:
+                saturated[d] += 1
+            else:
+                pinned[d].append(scale * estimate(raw, mod, comp, gain) / cp2 - 1.0)
+            m2, c2, g2 = board.calibrate(cp2)
+            recal[d].append(scale * estimate(board.convert(cp2, m2, c2, g2), m2, c2, g2) / cp2 - 1.0)
+
+    print("%d boards, Cp %.0f to %.0f pF, gain +-%.0f%%, Vref +-%.0f%%, INL +-%.1f LSB" %
+          (args.boards, args.cp_min, args.cp_max, 100 * args.gain_tol, 100 * args.vref_tol, args.inl))
+    print("one baseline count moves the estimate by %.3f%% on average, %.3f%% at most" %
+          (100 * sum(per_count) / len(per_count), 100 * max(per_count)))
+    print("case             mean_err  p95_err  max_err (percent)")
+    print("nominal          %8.2f %8.2f %8.2f" % tuple(100 * v for v in stats(nominal)))
+    for d in drifts:
+        if pinned[d]:
+            print("pinned, Cp %+3.0f%% %8.2f %8.2f %8.2f" % ((100 * d,) + tuple(100 * v for v in stats(pinned[d]))) +
+                  ("  (%d saturated)" % saturated[d] if saturated[d] else ""))
+        else:
+            print("pinned, Cp %+3.0f%%  all saturated" % (100 * d))
+    for d in drifts:
+        print("recal,  Cp %+3.0f%% %8.2f %8.2f %8.2f" % ((100 * d,) + tuple(100 * v for v in stats(recal[d]))))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""Generates design.cycapsense and design.modus variants with more widgets.
+
+The variants are derived from the two-button design in
+templates/TARGET_PMG1-CY7113/config. Every widget is a copy of Button0 with
+the same tuning. Buttons are named Button0..ButtonN-1, so the firmware
+still finds Button0 and Button1. Sliders are CSD linear sliders named
+LinearSlider0..LinearSliderM-1.
+
+Sensors are assigned to the CSD pins of the board in order: the buttons,
+then the slider segments. The CY7113 board has seven of them. Beyond that,
+the sensors share the pins round-robin. Such designs are only meant for
+builds that do not scan real electrodes, such as the synthetic-load
+benchmark (BENCH_EN), the host simulators, and emulation.
+
+Copy the two files over the config directory of the BSP; the build
+regenerates the configuration sources from them.
+
+Usage:
+    design_gen.py --buttons 32 [--sliders 2 --segments 5] --out gen/b32_s2
+"""
+
+import argparse
+import os
+import re
+import sys
+import xml.etree.ElementTree as ET
+
+TEMPLATE_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..",
+                            "templates", "TARGET_PMG1-CY7113", "config")
+
+
+def widget_template(capsense):
+    match = re.search(r'( *)<Widget id="Button0" type="CSD_BUTTON">.*?</Widget>\n', capsense, re.S)
+    if match is None:
+        raise ValueError("Button0 not found in design.cycapsense")
+    widget = match.group(0)
+    electrode = re.search(r' *<Electrode id="Sns0" kind="Sensor">.*?</Electrode>\n', widget, re.S).group(0)
+    return widget, electrode
+
+
+def make_widget(widget, electrode, name, kind, sensors):
+    body = widget.replace('id="Button0" type="CSD_BUTTON"', 'id="%s" type="%s"' % (name, kind), 1)
+    electrodes = "".join(electrode.replace('id="Sns0"', 'id="Sns%d"' % i, 1) for i in range(sensors))
+    return body.replace(electrode, electrodes, 1)
+
+
+def sensor_pins(modus):
+    """Board CSD pins as (port, pin), buttons first, then slider segments."""
+    pins = []
+    for match in re.finditer(r'<Block location="ioss\[0\]\.port\[(\d+)\]\.pin\[(\d+)\]">\s*'
+                             r'<Alias value="CYBSP_CSD_(BTN|SLD)(\d+)"/>', modus):
+        port, pin, kind, index = match.groups()
+        pins.append(((kind != "BTN"), int(index), int(port), int(pin)))
+    return [(port, pin) for _, _, port, pin in sorted(pins)]
+
+
+def generate(buttons, sliders, segments):
+    with open(os.path.join(TEMPLATE_DIR, "design.cycapsense")) as f:
+        capsense = f.read()
+    with open(os.path.join(TEMPLATE_DIR, "design.modus")) as f:
+        modus = f.read()
+
+    widget, electrode = widget_template(capsense)
+
+    widgets = []
+    names = []
+    for i in range(buttons):
+        widgets.append(make_widget(widget, electrode, "Button%d" % i, "CSD_BUTTON", 1))
+        names.append("Button%d_Sns0" % i)
+    for i in range(sliders):
+        widgets.append(make_widget(widget, electrode, "LinearSlider%d" % i, "CSD_LINEAR_SLIDER", segments))
+        names += ["LinearSlider%d_Sns%d" % (i, s) for s in range(segments)]
+
+    capsense = re.sub(r'(<Widgets>\n).*\n( *</Widgets>)',
+                      lambda m: m.group(1) + "".join(widgets) + m.group(2),
+                      capsense, count=1, flags=re.S)
+
+    # Sensor 0 of the CSD block is Cmod, its pin is the first arm of the mux
+    pins = sensor_pins(modus)
+    arms = re.search(r'( *)<Mux name="sense" location="csd\[0\]\.csd\[0\]">\n(.*?)\n *</Mux>', modus, re.S)
+    indent = arms.group(1)
+    cmod_arm = re.search(r' *<Arm>.*?</Arm>', arms.group(2), re.S).group(0)
+    arm = ('%s    <Arm>\n%s        <Port name="ioss[0].port[%%d].pin[%%d].analog[0]"/>\n%s    </Arm>' %
+           (indent, indent, indent))
+    new_arms = [cmod_arm] + [arm % pins[i % len(pins)] for i in range(len(names))]
+    modus = modus[:arms.start(2)] + "\n".join(new_arms) + modus[arms.end(2):]
+
+    params = re.search(r'( *)<Param id="SensorName0" value="Cmod"/>\n(?: *<Param id="SensorName\d+" value="[^"]*"/>\n)*',
+                       modus)
+    lines = params.group(0).splitlines(True)[:1]
+    lines += ['%s<Param id="SensorName%d" value="%s"/>\n' % (params.group(1), i + 1, n)
+              for i, n in enumerate(names)]
+    modus = modus[:params.start()] + "".join(lines) + modus[params.end():]
+    modus = re.sub(r'<Param id="SensorCount" value="\d+"/>',
+                   '<Param id="SensorCount" value="%d"/>' % (len(names) + 1), modus, count=1)
+
+    # Both files must stay well-formed
+    ET.fromstring(capsense.encode())
+    ET.fromstring(modus.encode())
+
+    return capsense, modus, len(names), len(pins)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--buttons", type=int, default=2, help="CSD buttons, at least 2")
+    parser.add_argument("--sliders", type=int, default=0, help="CSD linear sliders")
+    parser.add_argument("--segments", type=int, default=5, help="segments per slider")
+    parser.add_argument("--out", required=True, help="output directory")
+    args = parser.parse_args()
+
+    if args.buttons < 2:
+        parser.error("the firmware uses Button0 and Button1")
+    if args.sliders < 0 or not 2 <= args.segments <= 32:
+        parser.error("a slider has 2 to 32 segments")
+
+    try:
+        capsense, modus, sensors, pins = generate(args.buttons, args.sliders, args.segments)
+    except (ValueError, AttributeError, ET.ParseError) as err:
+        sys.exit("template not understood: %s" % err)
+
+    os.makedirs(args.out, exist_ok=True)
+    with open(os.path.join(args.out, "design.cycapsense"), "w") as f:
+        f.write(capsense)
+    with open(os.path.join(args.out, "design.modus"), "w") as f:
+        f.write(modus)
+
+    print("%d widgets, %d sensors" % (args.buttons + args.sliders, sensors))
+    if sensors > pins:
+        print("%d board pins: sensors share pins, not for scanning real electrodes" % pins)
+
+
+if __name__ == "__main__":
+    main()
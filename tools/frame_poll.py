@@ -0,0 +1,228 @@
+#!/usr/bin/env python3
+"""Schedules register map reads just after each frame from the frame ETA block.
+
+The frame ETA block holds the time stamp of the last frame, the filtered
+frame period and the predicted time stamp of the next frame, in device time.
+FramePoller maps the prediction to host time and returns when to read next:
+a guard time after the predicted frame, to cover processing and frame
+jitter, or a short retry when a read found no new frame.
+
+The --simulate option compares it with fixed-rate polling. The device
+publishes frames with jitter and occasional pauses, the host has latency
+jitter before each transfer, and every read takes the bus for the transfer
+time. Latency is the time from the frame time stamp to the end of the read
+that delivered the frame, in host time.
+"""
+
+import argparse
+import random
+import struct
+
+import hostregs
+from time_sync import ClockEstimator, SimDevice
+
+DEVICE_WRAP = 1 << 32
+
+# host_regs.h
+FRAME_ETA_SHIFT = 4
+FRAME_ETA_PAUSE_MULT = 4
+
+
+def parse_eta(regs):
+    """Returns (seq, time_us, period_us, next_us, eta_us) of a register map
+    dump, or None when the block is absent or was read during an update."""
+    offset = regs.block(hostregs.BLOCK_FRAME_ETA)
+    if offset is None:
+        return None
+    seq, time_us, period_us, next_us, eta_us, seq_end = regs.unpack("6I", offset)
+    if seq != seq_end:
+        return None
+    return seq, time_us, period_us, next_us, eta_us
+
+
+class FramePoller:
+    """Read scheduling from the frame ETA block. Call next_read() with the
+    host time at the end of each read and the parsed block, and read again at
+    the returned host time.
+
+    The device clock is fitted from the frames themselves: a new frame time
+    stamp lies between the previous read and this one, which is an exchange
+    for the ClockEstimator of tools/time_sync.py, so no time sync commands are
+    needed. Reads that follow a retry bracket the frame tightly and dominate
+    the fit. The guard time adapts: a read that found no new frame lengthens
+    it by half the retry time, and each read that found one on the first try
+    shortens it by 1/32, so few reads come too early."""
+
+    def __init__(self, guard_s=300e-6, retry_s=200e-6):
+        self.clock = ClockEstimator()
+        self.guard = guard_s
+        self.retry = retry_s
+        self.seq = None
+        self.last_read = None
+        self.retried = False
+
+    def next_read(self, now, eta):
+        last_read, self.last_read = self.last_read, now
+        if eta is None:
+            return now + self.retry
+        seq, time_us, period_us, next_us, _ = eta
+        if seq == self.seq:
+            self.guard += self.retry / 2.0
+            self.retried = True
+            return now + self.retry
+        if last_read is not None and self.seq is not None:
+            self.clock.add(last_read, now, time_us)
+        if not self.retried:
+            self.guard -= self.guard / 32.0
+        self.retried = False
+        self.seq = seq
+        if period_us == 0 or last_read is None:
+            return now + self.retry
+        target = self.clock.to_host(next_us) + self.guard
+        return max(target, now + self.retry)
+
+
+class SimFirmware:
+    """Frame ETA update of host_regs.c."""
+
+    def __init__(self):
+        self.period_q4 = 0
+        self.seen = 0
+        self.seq = 0
+        self.time_us = 0
+        self.period_us = 0
+        self.next_us = 0
+
+    def publish(self, seq, time_us):
+        frames = seq - self.seq
+        if self.seen > 0 and frames > 0:
+            period_q4 = (((time_us - self.time_us) % DEVICE_WRAP) // frames) << 4
+            if self.period_q4 == 0:
+                self.period_q4 = period_q4
+            elif period_q4 <= self.period_q4 * FRAME_ETA_PAUSE_MULT:
+                self.period_q4 = (self.period_q4 - (self.period_q4 >> FRAME_ETA_SHIFT) +
+                                  (period_q4 >> FRAME_ETA_SHIFT))
+        self.seen += 1
+        self.seq = seq
+        self.time_us = time_us
+        self.period_us = (self.period_q4 + 8) >> 4
+        if self.period_us:
+            self.next_us = (time_us + self.period_us) % DEVICE_WRAP
+
+    def block(self):
+        return self.seq, self.time_us, self.period_us, self.next_us, 0
+
+
+def frame_times(args, rng):
+    """Host times of frame time stamps and of their publication."""
+    frames = []
+    t = 1.0
+    while t < args.duration:
+        t += args.frame_period * (1.0 + rng.gauss(0.0, args.frame_jitter))
+        if rng.random() < args.pause_rate:
+            t += args.pause
+        frames.append(t)
+    return frames
+
+
+def simulate_fixed(args, frames, interval, rng):
+    latency = []
+    reads = 0
+    seen = -1
+    index = 0
+    host = frames[0]
+    while host < args.duration:
+        start = host + rng.expovariate(1.0 / args.jitter)
+        end = start + args.transfer
+        reads += 1
+        while index + 1 < len(frames) and frames[index + 1] + args.publish <= start:
+            index += 1
+        if frames[index] + args.publish <= start and index != seen:
+            latency.append(end - frames[index])
+            seen = index
+        host += interval
+    return latency, reads
+
+
+def simulate_eta(args, frames, rng):
+    device = SimDevice(rng, args.drift_ppm, args.wander_ppm)
+    poller = FramePoller(args.guard, args.retry)
+    firmware = SimFirmware()
+    latency = []
+    reads = 0
+    seen = -1
+    published = -1
+    host = frames[0] - 1.0
+
+    while host < args.duration:
+        start = host + rng.expovariate(1.0 / args.jitter)
+        end = start + args.transfer
+        reads += 1
+        # The device clock only runs forward, so frames are stamped in order
+        while published + 1 < len(frames) and frames[published + 1] + args.publish <= start:
+            published += 1
+            firmware.publish(published, device.now_us(frames[published]))
+        block = firmware.block() if published >= 0 else None
+        if published >= 0 and published != seen:
+            latency.append(end - frames[published])
+            seen = published
+        host = poller.next_read(end, block)
+    return latency, reads
+
+
+def summary(name, latency, reads, frames):
+    latency = sorted(latency)
+    p99 = latency[int(0.99 * (len(latency) - 1))]
+    print("%-14s %8d %9.2f %10.3f %9.3f %7.1f%%" %
+          (name, reads, reads / float(len(latency)), 1e3 * sum(latency) / len(latency),
+           1e3 * p99, 100.0 * (1.0 - len(latency) / float(frames))))
+
+
+def simulate(args):
+    rng = random.Random(args.seed)
+    frames = frame_times(args, rng)
+    print("%d frames, period %.1f ms, jitter %.0f%%, transfer %.2f ms, host latency %.2f ms mean" %
+          (len(frames), 1e3 * args.frame_period, 100 * args.frame_jitter, 1e3 * args.transfer,
+           1e3 * args.jitter))
+    print("poller            reads  per_frame  latency_ms   p99_ms  missed")
+    for divisor in (1, 2, 4, 8):
+        interval = args.frame_period / divisor
+        latency, reads = simulate_fixed(args, frames, interval, random.Random(args.seed))
+        summary("fixed %.2f ms" % (1e3 * interval), latency, reads, len(frames))
+    latency, reads = simulate_eta(args, frames, random.Random(args.seed))
+    summary("frame ETA", latency, reads, len(frames))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dump", nargs="?", help="register map dump, prints the frame ETA block")
+    parser.add_argument("--simulate", action="store_true", help="compare with fixed-rate polling")
+    parser.add_argument("--duration", type=float, default=120.0, help="seconds")
+    parser.add_argument("--frame-period", type=float, default=0.01, help="seconds")
+    parser.add_argument("--frame-jitter", type=float, default=0.02, help="fraction of the period")
+    parser.add_argument("--pause-rate", type=float, default=0.001, help="pauses per frame")
+    parser.add_argument("--pause", type=float, default=0.02, help="pause length, seconds")
+    parser.add_argument("--publish", type=float, default=150e-6,
+                        help="time from the frame time stamp to the block update, seconds")
+    parser.add_argument("--transfer", type=float, default=500e-6, help="read duration, seconds")
+    parser.add_argument("--jitter", type=float, default=100e-6, help="mean host latency, seconds")
+    parser.add_argument("--guard", type=float, default=300e-6, help="read after the prediction, seconds")
+    parser.add_argument("--retry", type=float, default=200e-6, help="retry after an early read, seconds")
+    parser.add_argument("--drift-ppm", type=float, default=20000.0, help="max device clock error")
+    parser.add_argument("--wander-ppm", type=float, default=1.0, help="per sqrt(s)")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    if args.simulate:
+        simulate(args)
+    elif args.dump:
+        eta = parse_eta(hostregs.load(args.dump))
+        if eta is None:
+            raise SystemExit("no consistent frame ETA block in the dump")
+        print("seq %d time %d us period %d us next %d us eta %d us" % eta)
+    else:
+        parser.print_help()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,220 @@
+#!/usr/bin/env python3
+"""Evaluates the raw count glitch rejection stage on captures with injected glitches.
+
+The capture is a CSV file with one raw count column per sensor, for example
+a raw count log of the CAPSENSE Tuner, or a synthetic capture with noise and
+touches. Single-frame glitches are injected at random frames. Three runs go
+through a model of the baseline and touch processing of this design:
+
+    clean       the capture as recorded, taken as the reference touch state
+    glitched    with injected glitches, no rejection
+    filtered    with injected glitches and the rejection stage of
+                glitch_filter.c
+
+For the glitched and filtered runs the script reports false touches (touch
+onsets without a reference touch), dropouts (releases while the reference
+touch is held), missed touches, and the delay of touch onsets against the
+reference, in frames.
+
+Usage:
+    glitch_eval.py --synthetic [--frames 200000]
+    glitch_eval.py capture.csv [--columns 1,2] [--debounce 1]
+"""
+
+import argparse
+import csv
+import math
+import random
+
+# Widget parameters of design.cycapsense
+FINGER_TH = 80
+HYSTERESIS = 10
+NOISE_TH = 40
+NNOISE_TH = 40
+LOW_BSLN_RST = 30
+ON_DEBOUNCE = 3
+on_debounce = ON_DEBOUNCE
+MAX_RAW = 1023
+
+# glitch_filter.h
+BOUND_MULT = 8
+MIN_BOUND = 40
+MEAN_SHIFT = 4
+
+
+class Sensor:
+    """Baseline and touch processing, as in tools/rtos_posix/sim_hw.c."""
+
+    def __init__(self, first):
+        self.bsln_q8 = first << 8
+        self.neg = 0
+        self.debounce = 0
+        self.touched = False
+
+    def process(self, raw):
+        bsln = self.bsln_q8 >> 8
+        diff = 0
+        if raw > bsln:
+            diff = raw - bsln
+            self.neg = 0
+            if diff < NOISE_TH:
+                self.bsln_q8 += ((raw << 8) - self.bsln_q8) >> 8
+        elif bsln - raw > NNOISE_TH:
+            self.neg += 1
+            if self.neg >= LOW_BSLN_RST:
+                self.bsln_q8 = raw << 8
+                self.neg = 0
+        else:
+            self.neg = 0
+            self.bsln_q8 -= (self.bsln_q8 - (raw << 8)) >> 8
+
+        if self.touched:
+            if diff < FINGER_TH - HYSTERESIS:
+                self.touched = False
+        elif diff >= FINGER_TH + HYSTERESIS:
+            self.debounce += 1
+            if self.debounce >= on_debounce:
+                self.touched = True
+                self.debounce = 0
+        else:
+            self.debounce = 0
+        return self.touched
+
+
+class GlitchFilter:
+    """Rejection stage, as in glitch_filter.c."""
+
+    def __init__(self, first):
+        self.prev = first
+        self.mean_q4 = 0
+        self.held = False
+
+    def run(self, raw):
+        delta = abs(raw - self.prev)
+        bound = max(MIN_BOUND, (self.mean_q4 * BOUND_MULT) >> 4)
+        if delta > bound:
+            if not self.held:
+                self.held = True
+                return self.prev
+            delta = bound
+        self.held = False
+        self.prev = raw
+        self.mean_q4 += ((delta << 4) - self.mean_q4) >> MEAN_SHIFT
+        return raw
+
+
+def synthetic(frames, sensors, rng):
+    """Noise of 3 counts, slow drift, and touches that build up over 40 frames."""
+    columns = []
+    for _ in range(sensors):
+        base = 870.0
+        column = []
+        touch_left = 0
+        level = 0.0
+        amp = 0.0
+        for f in range(frames):
+            if touch_left == 0 and rng.random() < 1.0 / 4000:
+                touch_left = rng.randint(200, 4000)
+                amp = rng.uniform(110.0, 200.0)
+            target = amp if touch_left > 0 else 0.0
+            touch_left = max(0, touch_left - 1)
+            level += (target - level) / 40.0
+            value = base + 20.0 * math.sin(f / 50000.0) + level + rng.gauss(0.0, 3.0)
+            column.append(int(min(MAX_RAW, max(0, value))))
+        columns.append(column)
+    return columns
+
+
+def onsets(states):
+    return [i for i in range(1, len(states)) if states[i] and not states[i - 1]]
+
+
+def run(column, use_filter):
+    sensor = Sensor(column[0])
+    filt = GlitchFilter(column[0])
+    states = []
+    for raw in column:
+        if use_filter:
+            raw = filt.run(raw)
+        states.append(sensor.process(raw))
+    return states
+
+
+def compare(reference, states):
+    ref_on = onsets(reference)
+    dropouts = sum(1 for i in range(1, len(states))
+                   if states[i - 1] and not states[i] and reference[i])
+    false_touches = 0
+    delays = []
+    for onset in onsets(states):
+        if reference[onset] or any(0 <= onset - r < 50 for r in ref_on):
+            continue
+        false_touches += 1
+    for r in ref_on:
+        match = [o for o in onsets(states) if -50 < o - r < 200]
+        if match:
+            delays.append(min(match, key=lambda o: abs(o - r)) - r)
+    missed = len(ref_on) - len(delays)
+    return false_touches, dropouts, missed, delays
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", nargs="?", help="CSV with raw counts")
+    parser.add_argument("--columns", default=None, help="raw count columns, default all")
+    parser.add_argument("--synthetic", action="store_true")
+    parser.add_argument("--frames", type=int, default=200000)
+    parser.add_argument("--sensors", type=int, default=2)
+    parser.add_argument("--glitch-rate", type=float, default=1e-3, help="per sensor frame")
+    parser.add_argument("--glitch-min", type=int, default=100)
+    parser.add_argument("--glitch-max", type=int, default=400)
+    parser.add_argument("--glitch-len", type=int, default=1, help="frames per glitch")
+    parser.add_argument("--debounce", type=int, default=ON_DEBOUNCE, help="on debounce, frames")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    global on_debounce
+    on_debounce = args.debounce
+
+    rng = random.Random(args.seed)
+    if args.synthetic:
+        columns = synthetic(args.frames, args.sensors, rng)
+    elif args.capture:
+        with open(args.capture) as f:
+            rows = [r for r in csv.reader(f) if r and r[0].strip().lstrip("-").isdigit()]
+        picks = [int(c) for c in args.columns.split(",")] if args.columns else range(len(rows[0]))
+        columns = [[int(r[c]) for r in rows] for c in picks]
+    else:
+        parser.error("give a capture file or --synthetic")
+
+    totals = {"glitched": [0, 0, 0, []], "filtered": [0, 0, 0, []]}
+    glitches = 0
+    for column in columns:
+        reference = run(column, False)
+        dirty = list(column)
+        for i in range(1, len(dirty)):
+            if rng.random() < args.glitch_rate:
+                size = rng.randint(args.glitch_min, args.glitch_max)
+                if rng.random() < 0.5:
+                    size = -size
+                for j in range(i, min(len(dirty), i + args.glitch_len)):
+                    dirty[j] = min(MAX_RAW, max(0, dirty[j] + size))
+                glitches += 1
+        for name, use_filter in (("glitched", False), ("filtered", True)):
+            result = compare(reference, run(dirty, use_filter))
+            for k in range(4):
+                totals[name][k] += result[k]
+
+    print("%d sensor frames, %d injected glitches, %d reference touches" %
+          (sum(len(c) for c in columns), glitches,
+           sum(len(onsets(run(c, False))) for c in columns)))
+    print("run       false  dropout  missed  delay_mean  delay_max (frames)")
+    for name in ("glitched", "filtered"):
+        false_touches, dropouts, missed, delays = totals[name]
+        mean = sum(delays) / len(delays) if delays else 0.0
+        print("%-8s %6d %8d %7d %11.2f %10d" %
+              (name, false_touches, dropouts, missed, mean, max(delays or [0])))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""Derives noise, percentiles and SNR from the histogram block of a register map dump.
+
+The firmware keeps two histograms of 16-bit bins per sensor. The diff
+histogram counts the difference count of every frame. The deviation histogram
+counts raw count minus baseline in frames where the sensor is not touched,
+centered on the middle bin. A bin stops at 65535, so clear the histograms
+with HOST_CMD_HISTOGRAM_CLEAR after each download, at least every 65535
+frames.
+
+SNR follows the CAPSENSE tuning guide: the mean difference count of touched
+frames divided by the peak-to-peak noise. Bin values are taken at the bin
+centers, so the resolution is the bin width.
+
+Usage:
+    histogram.py dump.bin [--finger-th 80] [--csv]
+"""
+
+import argparse
+import sys
+
+import hostregs
+
+BIN_MAX = 0xFFFF
+
+
+def read_histograms(regs):
+    offset = regs.block(hostregs.BLOCK_HISTOGRAM)
+    if offset is None:
+        raise ValueError("the firmware was built without HISTOGRAM_EN")
+
+    seq, bins, shift, sensors, _, frames = regs.unpack("IBBBBI", offset)
+    cells = sensors * bins
+    values = regs.unpack("%dH" % (2 * cells), offset + 12)
+    seq_end = regs.unpack("I", offset + 12 + 4 * cells)[0]
+    if seq != seq_end:
+        raise ValueError("torn read, the block changed during the transfer")
+
+    diff = [list(values[s * bins:(s + 1) * bins]) for s in range(sensors)]
+    dev = [list(values[cells + s * bins:cells + (s + 1) * bins]) for s in range(sensors)]
+    return frames, bins, 1 << shift, diff, dev
+
+
+def percentile(counts, centers, q):
+    total = sum(counts)
+    if total == 0:
+        return None
+    target = q * total
+    acc = 0
+    for count, center in zip(counts, centers):
+        acc += count
+        if acc >= target:
+            return center
+    return centers[-1]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dump", help="binary dump of the register map")
+    parser.add_argument("--finger-th", type=float, default=80.0,
+                        help="diff counts at or above this are touch samples")
+    parser.add_argument("--csv", action="store_true", help="print the bins instead")
+    args = parser.parse_args()
+
+    try:
+        frames, bins, width, diff, dev = read_histograms(hostregs.load(args.dump))
+    except ValueError as err:
+        sys.exit(str(err))
+
+    diff_centers = [(b + 0.5) * width for b in range(bins)]
+    dev_centers = [(b - bins // 2 + 0.5) * width for b in range(bins)]
+
+    if args.csv:
+        print("sensor,kind,bin_low,count")
+        for s in range(len(diff)):
+            for b in range(bins):
+                print("%d,diff,%d,%d" % (s, b * width, diff[s][b]))
+            for b in range(bins):
+                print("%d,dev,%d,%d" % (s, (b - bins // 2) * width, dev[s][b]))
+        return
+
+    print("%d frames, bin width %d counts" % (frames, width))
+    if any(n == BIN_MAX for h in diff + dev for n in h):
+        print("saturated bins, the results are skewed: clear more often than every %d frames" %
+              BIN_MAX)
+    print("sensor  noise_p1  noise_p99  noise_pp  noise_rms  signal  snr")
+    for s in range(len(diff)):
+        counts = dev[s]
+        total = sum(counts)
+        if total == 0:
+            print("%6d  no untouched frames" % s)
+            continue
+        used = [c for c, n in zip(dev_centers, counts) if n]
+        pp = used[-1] - used[0] + width
+        mean = sum(c * n for c, n in zip(dev_centers, counts)) / total
+        rms = (sum((c - mean) ** 2 * n for c, n in zip(dev_centers, counts)) / total) ** 0.5
+
+        touch = [(c, n) for c, n in zip(diff_centers, diff[s]) if c - width / 2 >= args.finger_th]
+        touch_total = sum(n for _, n in touch)
+        signal = sum(c * n for c, n in touch) / touch_total if touch_total else 0.0
+        snr = "%5.1f" % (signal / pp) if touch_total else "    -"
+
+        print("%6d  %8.1f  %9.1f  %8.1f  %9.2f  %6.1f  %s" %
+              (s, percentile(counts, dev_centers, 0.01), percentile(counts, dev_centers, 0.99),
+               pp, rms, signal, snr))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,57 @@
+"""Helpers for reading dumps of the application register map.
+
+The register map is read from the EZI2C slave in one transfer and saved as a
+binary file. The block directory follows the mailbox and starts with the
+"HREG" marker, so the blocks are located without knowing the firmware build
+options. See host_regs.h for the layout.
+"""
+
+import struct
+
+HOST_REGS_MAGIC = b"HREG"
+
+BLOCK_STATUS = 0
+BLOCK_FRAME = 1
+BLOCK_SCAN_STATS = 2
+BLOCK_TOUCH_HISTORY = 3
+BLOCK_SYNC = 4
+BLOCK_TRACE = 5
+BLOCK_HEALTH = 6
+BLOCK_HISTOGRAM = 7
+BLOCK_BENCH = 8
+BLOCK_AUTOTUNE = 9
+BLOCK_FRAME_ETA = 10
+BLOCK_EZI2C = 11
+
+CMD_TIME_SYNC = 0x04
+CMD_TRACE_FREEZE = 0x07
+
+
+class RegisterMap:
+    def __init__(self, data):
+        self.data = bytes(data)
+        self.info = self.data.find(HOST_REGS_MAGIC)
+        if self.info < 0:
+            raise ValueError("register map marker not found")
+
+        _, self.version, self.size = struct.unpack_from("<IHH", self.data, self.info)
+        directory = self.info + 8
+
+        # The status block directly follows the directory
+        first = struct.unpack_from("<H", self.data, directory)[0]
+        count = (first - directory) // 2
+        self.block_offset = list(struct.unpack_from("<%dH" % count, self.data, directory))
+
+    def block(self, block_id):
+        """Returns the offset of a block, or None when the firmware does not provide it."""
+        if block_id >= len(self.block_offset) or self.block_offset[block_id] == 0:
+            return None
+        return self.block_offset[block_id]
+
+    def unpack(self, fmt, offset):
+        return struct.unpack_from("<" + fmt, self.data, offset)
+
+
+def load(path):
+    with open(path, "rb") as f:
+        return RegisterMap(f.read())
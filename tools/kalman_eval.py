@@ -0,0 +1,315 @@
+#!/usr/bin/env python3
+"""Compares raw count filters at lower scan resolutions on a capture.
+
+The capture is a CSV file with one raw count column per sensor at the
+resolution of the design, for example a raw count log of the CAPSENSE Tuner,
+or a synthetic capture with noise and touches. Lower resolutions are derived
+from it: one step halves the signal and the conversion time, and, for white
+noise, lowers the noise by the square root of 2 only, so the raw counts are
+halved and noise is added back. Each resolution goes through a model of the
+baseline and touch processing of this design with thresholds scaled to the
+resolution, after one of these filters:
+
+    none        raw counts as scanned
+    iir         the IIR stage of noise_filter.c, always on
+    kalman      the estimator of kalman_filter.c, with KALMAN_MEAS_VAR
+                measured on the capture at that resolution
+
+The reference touch state is the unfiltered capture at the design
+resolution. For every case the script reports the SNR (mean touch signal over
+peak-to-peak noise in 512-frame blocks without touch, against the model
+baseline), the delay of touch onsets and releases against the reference,
+touches without a reference touch and missed touches, and the conversion time
+of a frame.
+
+Usage:
+    kalman_eval.py --synthetic [--frames 200000]
+    kalman_eval.py capture.csv [--columns 1,2] [--steps 2]
+"""
+
+import argparse
+import csv
+import math
+import random
+
+# Widget parameters of design.cycapsense, at RESOLUTION
+RESOLUTION = 10
+FINGER_TH = 80
+HYSTERESIS = 10
+NOISE_TH = 40
+NNOISE_TH = 40
+LOW_BSLN_RST = 30
+ON_DEBOUNCE = 3
+
+# Conversion time, as in tools/rtos_posix/sim_hw.c
+MOD_CLK_HZ = 48e6
+INIT_MOD_CYCLES = 10
+
+# noise_filter.h
+IIR_COEFF = 128
+
+# kalman_filter.h
+PROC_VAR_Q8 = 16
+TOUCH_PROC_VAR_Q8 = 256
+GATE = 3
+STEP_VAR = 255
+GAIN_SHIFT = 12
+
+
+class Sensor:
+    """Baseline and touch processing, as in tools/glitch_eval.py, with the
+    thresholds scaled by 2^(resolution - RESOLUTION)."""
+
+    def __init__(self, first, scale):
+        self.bsln_q8 = first << 8
+        self.neg = 0
+        self.debounce = 0
+        self.touched = False
+        self.finger_th = FINGER_TH * scale
+        self.hysteresis = HYSTERESIS * scale
+        self.noise_th = NOISE_TH * scale
+        self.nnoise_th = NNOISE_TH * scale
+
+    def process(self, raw):
+        bsln = self.bsln_q8 >> 8
+        diff = 0
+        if raw > bsln:
+            diff = raw - bsln
+            self.neg = 0
+            if diff < self.noise_th:
+                self.bsln_q8 += ((raw << 8) - self.bsln_q8) >> 8
+        elif bsln - raw > self.nnoise_th:
+            self.neg += 1
+            if self.neg >= LOW_BSLN_RST:
+                self.bsln_q8 = raw << 8
+                self.neg = 0
+        else:
+            self.neg = 0
+            self.bsln_q8 -= (self.bsln_q8 - (raw << 8)) >> 8
+
+        if self.touched:
+            if diff < self.finger_th - self.hysteresis:
+                self.touched = False
+        elif diff >= self.finger_th + self.hysteresis:
+            self.debounce += 1
+            if self.debounce >= ON_DEBOUNCE:
+                self.touched = True
+                self.debounce = 0
+        else:
+            self.debounce = 0
+        return self.touched, bsln
+
+
+class Iir:
+    """IIR stage of noise_filter.c."""
+
+    def __init__(self, first):
+        self.iir = first << 8
+
+    def run(self, raw, touched):
+        self.iir += (((raw << 8) - self.iir) * IIR_COEFF) >> 8
+        return self.iir >> 8
+
+
+class Kalman:
+    """kalman_filter_sample() of kalman_filter.c."""
+
+    def __init__(self, first, meas_var):
+        self.r_q8 = meas_var << 8
+        self.x_q8 = first << 8
+        self.p_q8 = self.r_q8
+        self.touched = False
+        self.outside = 0
+
+    def run(self, raw, touched):
+        p_q8 = self.p_q8 + (TOUCH_PROC_VAR_Q8 if touched else PROC_VAR_Q8)
+        innov_q8 = (raw << 8) - self.x_q8
+        abs_q4 = abs(innov_q8) >> 4
+        sign = 0
+        if abs_q4 * abs_q4 > GATE * GATE * (p_q8 + self.r_q8):
+            sign = 1 if innov_q8 > 0 else -1
+        if (sign != 0 and sign == self.outside) or touched != self.touched:
+            p_q8 = max(p_q8, STEP_VAR << 8)
+            self.touched = touched
+            sign = 0
+        self.outside = sign
+        p_q8 = min(p_q8, STEP_VAR << 8)
+        gain = (p_q8 << GAIN_SHIFT) // (p_q8 + self.r_q8)
+        # 64-bit product, division truncates toward zero as in C
+        step = (abs(innov_q8) * gain) >> GAIN_SHIFT
+        self.x_q8 += step if innov_q8 >= 0 else -step
+        self.p_q8 = (((1 << GAIN_SHIFT) - gain) * p_q8) >> GAIN_SHIFT
+        return (self.x_q8 + 128) >> 8
+
+
+class Passthrough:
+    def __init__(self, first):
+        pass
+
+    def run(self, raw, touched):
+        return raw
+
+
+def synthetic(frames, sensors, rng):
+    """As in tools/glitch_eval.py: noise of 3 counts, slow drift, and touches
+    that build up over 40 frames."""
+    max_raw = (1 << RESOLUTION) - 1
+    columns = []
+    for _ in range(sensors):
+        column = []
+        touch_left = 0
+        level = 0.0
+        amp = 0.0
+        for f in range(frames):
+            if touch_left == 0 and rng.random() < 1.0 / 4000:
+                touch_left = rng.randint(200, 4000)
+                amp = rng.uniform(110.0, 200.0)
+            target = amp if touch_left > 0 else 0.0
+            touch_left = max(0, touch_left - 1)
+            level += (target - level) / 40.0
+            value = 870.0 + 20.0 * math.sin(f / 50000.0) + level + rng.gauss(0.0, 3.0)
+            column.append(int(min(max_raw, max(0, value))))
+        columns.append(column)
+    return columns
+
+
+def noise_var(column, reference):
+    """Variance of the raw count without touch, from sample-to-sample changes."""
+    changes = [column[i] - column[i - 1] for i in range(1, len(column))
+               if not reference[i] and not reference[i - 1]]
+    return sum(c * c for c in changes) / (2.0 * len(changes)) if changes else 1.0
+
+
+def reduce(column, steps, sigma, rng):
+    """The capture at `steps` resolution steps lower."""
+    if steps == 0:
+        return list(column)
+    scale = 1.0 / (1 << steps)
+    extra = sigma * math.sqrt(scale - scale * scale)
+    return [max(0, int(round(v * scale + rng.gauss(0.0, extra)))) for v in column]
+
+
+def run(column, scale, filt):
+    sensor = Sensor(column[0], scale)
+    touched = False
+    states = []
+    diffs = []
+    for raw in column:
+        out = filt.run(raw, touched)
+        touched, bsln = sensor.process(out)
+        states.append(touched)
+        diffs.append(out - bsln)
+    return states, diffs
+
+
+def edges(states, value):
+    return [i for i in range(1, len(states)) if states[i] == value and states[i - 1] != value]
+
+
+def compare(reference, states):
+    delays = {True: [], False: []}
+    for value in (True, False):
+        found = edges(states, value)
+        for r in edges(reference, value):
+            match = [e for e in found if -50 < e - r < 400]
+            if match:
+                delays[value].append(min(match, key=lambda e: abs(e - r)) - r)
+    ref_on = edges(reference, True)
+    false_touches = sum(1 for e in edges(states, True)
+                        if not reference[e] and not any(-50 < e - r < 400 for r in ref_on))
+    missed = len(ref_on) - len(delays[True])
+    return delays[True], delays[False], false_touches, missed
+
+
+def snr(reference, diffs):
+    """Mean signal of touches held for 100 frames over the mean peak-to-peak
+    noise of 512-frame blocks at least 400 frames from any touch."""
+    far = [True] * len(reference)
+    for i, touched in enumerate(reference):
+        if touched:
+            for j in range(max(0, i - 400), min(len(far), i + 401)):
+                far[j] = False
+    blocks = []
+    block = []
+    for i, d in enumerate(diffs):
+        if far[i]:
+            block.append(d)
+            if len(block) == 512:
+                blocks.append(max(block) - min(block))
+                block = []
+    signal = [diffs[i] for i in range(100, len(diffs)) if all(reference[i - 100:i + 1])]
+    if not blocks or not signal:
+        return 0.0, 0.0
+    noise = sum(blocks) / len(blocks)
+    return sum(signal) / len(signal) / max(noise, 1), noise
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", nargs="?", help="CSV with raw counts")
+    parser.add_argument("--columns", default=None, help="raw count columns, default all")
+    parser.add_argument("--synthetic", action="store_true")
+    parser.add_argument("--frames", type=int, default=200000)
+    parser.add_argument("--sensors", type=int, default=2)
+    parser.add_argument("--steps", type=int, default=2, help="resolution steps below RESOLUTION")
+    parser.add_argument("--overhead-us", type=float, default=179.0,
+                        help="frame time besides the conversions")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    if args.synthetic:
+        columns = synthetic(args.frames, args.sensors, rng)
+    elif args.capture:
+        with open(args.capture) as f:
+            rows = [r for r in csv.reader(f) if r and r[0].strip().lstrip("-").isdigit()]
+        picks = [int(c) for c in args.columns.split(",")] if args.columns else range(len(rows[0]))
+        columns = [[int(r[c]) for r in rows] for c in picks]
+    else:
+        parser.error("give a capture file or --synthetic")
+
+    references = [run(c, 1, Passthrough(c[0]))[0] for c in columns]
+    sigmas = [math.sqrt(noise_var(c, r)) for c, r in zip(columns, references)]
+
+    print("%d sensor frames, %d reference touches, noise %s counts RMS at %d bits" %
+          (sum(len(c) for c in columns), sum(len(edges(r, True)) for r in references),
+           "/".join("%.1f" % s for s in sigmas), RESOLUTION))
+    print("bits filter  scan_us frame_us   SNR  noise_pp  onset_mean/max  release_mean/max"
+          "  onset_ms  false  missed")
+    for steps in range(args.steps + 1):
+        bits = RESOLUTION - steps
+        scale = 1.0 / (1 << steps)
+        scan_us = len(columns) * ((1 << bits) - 1 + INIT_MOD_CYCLES) / MOD_CLK_HZ * 1e6
+        frame_us = args.overhead_us + scan_us
+        reduced = [reduce(c, steps, s, rng) for c, s in zip(columns, sigmas)]
+        meas_var = [max(1, int(round(noise_var(c, r)))) for c, r in zip(reduced, references)]
+        for name in ("none", "iir", "kalman"):
+            onset, release, snrs, noises = [], [], [], []
+            false_touches = missed = 0
+            for column, reference, var in zip(reduced, references, meas_var):
+                if name == "none":
+                    filt = Passthrough(column[0])
+                elif name == "iir":
+                    filt = Iir(column[0])
+                else:
+                    filt = Kalman(column[0], var)
+                states, diffs = run(column, scale, filt)
+                on, off, f, m = compare(reference, states)
+                onset += on
+                release += off
+                false_touches += f
+                missed += m
+                s, n = snr(reference, diffs)
+                snrs.append(s)
+                noises.append(n)
+            mean_on = sum(onset) / len(onset) if onset else 0.0
+            mean_off = sum(release) / len(release) if release else 0.0
+            print("%4d %-7s %7.1f %8.1f %5.1f %9.1f %7.2f/%-6d %8.2f/%-6d %9.2f %6d %7d" %
+                  (bits, name, scan_us, frame_us, min(snrs), max(noises), mean_on,
+                   max(onset or [0]), mean_off, max(release or [0]), mean_on * frame_us / 1000.0,
+                   false_touches, missed))
+        print("%4d KALMAN_MEAS_VAR %s" % (bits, "/".join(str(v) for v in meas_var)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""Builds HOST_CMD_SET_PARAMS batches and estimates the reconfiguration time.
+
+A batch is written in two EZI2C writes: tag, len and the entries at offset 1
+of the mailbox, then the command byte at offset 0. The firmware applies the
+whole batch at the next frame boundary and reports one status in the status
+block. See param_batch.h for the parameter IDs and the validation rules.
+
+Usage:
+    param_batch.py 0:finger_th=100 0:hysteresis=12 1:finger_th=90
+    param_batch.py --estimate --widgets 32
+"""
+
+import argparse
+import struct
+import sys
+
+CMD_SET_PARAMS = 0x09
+ENTRY_SIZE = 4
+MAX_ENTRIES = 32
+
+PARAMS = {
+    "finger_th": 0x00,
+    "noise_th": 0x01,
+    "nnoise_th": 0x02,
+    "hysteresis": 0x03,
+    "on_debounce": 0x04,
+    "low_bsln_rst": 0x05,
+}
+
+
+def parse_entry(text):
+    """Parses widget:param=value."""
+    widget, rest = text.split(":", 1)
+    name, value = rest.split("=", 1)
+    if name not in PARAMS:
+        raise ValueError("unknown parameter %s, one of %s" % (name, ", ".join(PARAMS)))
+    return int(widget, 0), PARAMS[name], int(value, 0)
+
+
+def build(entries, tag=1):
+    """Returns the two mailbox writes as (offset, bytes) pairs."""
+    if not 0 < len(entries) <= MAX_ENTRIES:
+        raise ValueError("a batch holds 1 to %d entries" % MAX_ENTRIES)
+    payload = b"".join(struct.pack("<BBH", w, p, v) for w, p, v in entries)
+    return [(1, bytes([tag, len(payload), 0]) + payload), (0, bytes([CMD_SET_PARAMS]))]
+
+
+def transfer_s(data_bytes, args):
+    """One EZI2C transaction: address byte, sub-address, data, plus host overhead."""
+    bits = 9 * (1 + args.sub_address + data_bytes) + 2
+    return bits / args.i2c_hz + args.host_latency_ms * 1e-3
+
+
+def estimate(args):
+    frame_s = args.frame_us * 1e-6
+    # Status read: sub-address write, then a repeated start and 4 bytes
+    status_read = transfer_s(0, args) + transfer_s(4, args) - args.host_latency_ms * 1e-3
+
+    # One parameter per write through the Tuner data structure. Each write is
+    # applied by Cy_CapSense_RunTuner() at a frame boundary and confirmed by a
+    # read before the next one.
+    single = transfer_s(2, args) + status_read
+    individual = (args.widgets * single, args.widgets * (single + frame_s))
+
+    batches = (args.widgets + MAX_ENTRIES - 1) // MAX_ENTRIES
+    one = transfer_s(3 + ENTRY_SIZE * min(args.widgets, MAX_ENTRIES), args) + \
+        transfer_s(1, args) + status_read
+    batched = (batches * one, batches * (one + frame_s))
+
+    print("%d widgets, one parameter each, I2C %d kHz, %.1f ms host latency per transaction"
+          % (args.widgets, args.i2c_hz // 1000, args.host_latency_ms))
+    print("individual writes: %6.1f ms to %6.1f ms" % (individual[0] * 1e3, individual[1] * 1e3))
+    print("batched writes:    %6.1f ms to %6.1f ms" % (batched[0] * 1e3, batched[1] * 1e3))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("entries", nargs="*", help="widget:param=value")
+    parser.add_argument("--tag", type=int, default=1)
+    parser.add_argument("--estimate", action="store_true", help="print the timing model")
+    parser.add_argument("--widgets", type=int, default=32)
+    parser.add_argument("--frame-us", type=float, default=222.0, help="frame period")
+    parser.add_argument("--i2c-hz", type=int, default=400000)
+    parser.add_argument("--sub-address", type=int, default=2, help="EZI2C sub-address bytes")
+    parser.add_argument("--host-latency-ms", type=float, default=1.0,
+                        help="USB-I2C bridge turnaround per transaction")
+    args = parser.parse_args()
+
+    if args.estimate:
+        estimate(args)
+        return
+    if not args.entries:
+        parser.print_help()
+        sys.exit(1)
+
+    for offset, data in build([parse_entry(e) for e in args.entries], args.tag):
+        print("write offset %d: %s" % (offset, data.hex(" ")))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,248 @@
+/******************************************************************************
+* File Name: cy_pdl.h
+*
+* Description: Host stand-in for the PDL and the core registers, used by the
+*              FreeRTOS POSIX build of the RTOS_EN variant. The functions are
+*              implemented in sim_hw.c.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef CY_PDL_H
+#define CY_PDL_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define __STATIC_INLINE                  static inline
+#define CY_ALIGN(align)                  __attribute__((aligned(align)))
+#define CY_UNUSED_PARAMETER(param)       ((void)(param))
+
+/* Stops the simulation with the failing location */
+#define CY_ASSERT(x)                     do { if (!(x)) { sim_assert_failed(__FILE__, __LINE__); } } while (0)
+#define CY_ASSERT_FAILED                 (0u)
+
+#define CY_RSLT_SUCCESS                  (0u)
+
+/* Core registers: SysTick and SCB are recomputed from the host clock on every
+ * access, see sim_systick()
+ */
+#define SysTick                          (sim_systick())
+#define SCB                              (sim_scb())
+
+#define SysTick_CTRL_ENABLE_Msk          (1uL << 0u)
+#define SysTick_CTRL_TICKINT_Msk         (1uL << 1u)
+#define SysTick_CTRL_CLKSOURCE_Msk       (1uL << 2u)
+#define SCB_ICSR_PENDSTCLR_Msk           (1uL << 25u)
+#define SCB_ICSR_PENDSTSET_Msk           (1uL << 26u)
+
+#define __enable_irq()                   ((void)0)
+#define __disable_irq()                  ((void)0)
+#define __WFI()                          ((void)0)
+#define __NOP()                          ((void)0)
+#define __DMB()                          __asm__ volatile("" ::: "memory")
+
+#define CY_SYSINT_SUCCESS                (0u)
+#define CY_SYSPM_SUCCESS                 (0u)
+#define CY_SYSPM_FAIL                    (1u)
+#define CY_SYSPM_DEEPSLEEP               (1u)
+
+#define CY_SCB_EZI2C_SUCCESS             (0u)
+#define CY_SCB_EZI2C_STATUS_READ1        (0x01u)
+#define CY_SCB_EZI2C_STATUS_WRITE1       (0x02u)
+#define CY_SCB_EZI2C_STATUS_READ2        (0x04u)
+#define CY_SCB_EZI2C_STATUS_WRITE2       (0x08u)
+#define CY_SCB_EZI2C_STATUS_BUSY         (0x10u)
+#define CY_SCB_EZI2C_STATUS_ERR          (0x20u)
+
+#define CY_FLASH_SIZEOF_ROW              (128u)
+#define CY_FLASH_DRV_SUCCESS             (0u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef uint32_t cy_rslt_t;
+
+typedef enum
+{
+    SysTick_IRQn = -1,
+    csd_interrupt_IRQn = 10,
+    scb_0_interrupt_IRQn = 11,
+} IRQn_Type;
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t LOAD;
+    volatile uint32_t VAL;
+    volatile uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct
+{
+    volatile uint32_t CPUID;
+    volatile uint32_t ICSR;
+} SCB_Type;
+
+typedef void (*cy_israddress)(void);
+
+typedef struct
+{
+    IRQn_Type intrSrc;
+    uint32_t intrPriority;
+} cy_stc_sysint_t;
+
+typedef uint32_t cy_en_sysint_status_t;
+
+typedef struct { uint32_t reserved; } GPIO_PRT_Type;
+typedef struct { uint32_t reserved; } CySCB_Type;
+typedef struct { uint32_t reserved; } CSD_Type;
+
+typedef uint32_t cy_en_syspm_status_t;
+typedef uint32_t cy_en_syspm_callback_type_t;
+typedef uint32_t cy_en_syspm_callback_mode_t;
+
+typedef struct
+{
+    void *base;
+    void *context;
+} cy_stc_syspm_callback_params_t;
+
+typedef cy_en_syspm_status_t (*Cy_SysPmCallback)(cy_stc_syspm_callback_params_t *params,
+                                                 cy_en_syspm_callback_mode_t mode);
+
+typedef struct cy_stc_syspm_callback
+{
+    Cy_SysPmCallback callback;
+    cy_en_syspm_callback_type_t type;
+    uint32_t skipMode;
+    cy_stc_syspm_callback_params_t *callbackParams;
+    struct cy_stc_syspm_callback *prevItm;
+    struct cy_stc_syspm_callback *nextItm;
+} cy_stc_syspm_callback_t;
+
+typedef enum
+{
+    CY_SCB_EZI2C_ONE_ADDRESS,
+    CY_SCB_EZI2C_TWO_ADDRESSES
+} cy_en_scb_ezi2c_num_of_addr_t;
+
+typedef struct
+{
+    cy_en_scb_ezi2c_num_of_addr_t numberOfAddresses;
+    uint8_t slaveAddress1;
+    uint8_t slaveAddress2;
+    bool enableWakeFromSleep;
+} cy_stc_scb_ezi2c_config_t;
+
+typedef struct
+{
+    uint32_t status;
+    uint8_t *buf1;
+    uint32_t buf1Size;
+    uint8_t *buf2;
+    uint32_t buf2Size;
+} cy_stc_scb_ezi2c_context_t;
+
+typedef uint32_t cy_en_scb_ezi2c_status_t;
+
+typedef struct { uint32_t reserved; } cy_stc_scb_uart_config_t;
+typedef struct { uint32_t reserved; } cy_stc_scb_uart_context_t;
+
+typedef uint32_t cy_en_flashdrv_status_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern uint32_t SystemCoreClock;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void sim_assert_failed(const char *file, int line);
+SysTick_Type *sim_systick(void);
+SCB_Type *sim_scb(void);
+void sim_kernel_tick(void);
+
+void NVIC_EnableIRQ(IRQn_Type irq);
+void NVIC_DisableIRQ(IRQn_Type irq);
+void NVIC_ClearPendingIRQ(IRQn_Type irq);
+void NVIC_SetPriority(IRQn_Type irq, uint32_t priority);
+
+cy_en_sysint_status_t Cy_SysInt_Init(const cy_stc_sysint_t *config, cy_israddress isr);
+cy_israddress Cy_SysInt_SetVector(IRQn_Type irq, cy_israddress isr);
+
+uint32_t Cy_SysLib_EnterCriticalSection(void);
+void Cy_SysLib_ExitCriticalSection(uint32_t saved);
+void Cy_SysLib_Delay(uint32_t ms);
+void Cy_SysLib_DelayUs(uint16_t us);
+
+void Cy_SysPm_CpuEnterSleep(void);
+cy_en_syspm_status_t Cy_SysPm_CpuEnterDeepSleep(void);
+bool Cy_SysPm_RegisterCallback(cy_stc_syspm_callback_t *handler);
+
+void Cy_GPIO_Write(GPIO_PRT_Type *base, uint32_t pin, uint32_t value);
+void Cy_GPIO_Inv(GPIO_PRT_Type *base, uint32_t pin);
+uint32_t Cy_GPIO_Read(GPIO_PRT_Type *base, uint32_t pin);
+
+cy_en_scb_ezi2c_status_t Cy_SCB_EZI2C_Init(CySCB_Type *base, const cy_stc_scb_ezi2c_config_t *config,
+                                           cy_stc_scb_ezi2c_context_t *context);
+void Cy_SCB_EZI2C_Enable(CySCB_Type *base);
+void Cy_SCB_EZI2C_SetBuffer1(CySCB_Type const *base, uint8_t *buffer, uint32_t size,
+                             uint32_t rwBoundary, cy_stc_scb_ezi2c_context_t *context);
+void Cy_SCB_EZI2C_SetBuffer2(CySCB_Type const *base, uint8_t *buffer, uint32_t size,
+                             uint32_t rwBoundary, cy_stc_scb_ezi2c_context_t *context);
+void Cy_SCB_EZI2C_Interrupt(CySCB_Type *base, cy_stc_scb_ezi2c_context_t *context);
+uint32_t Cy_SCB_EZI2C_GetActivity(CySCB_Type const *base, cy_stc_scb_ezi2c_context_t *context);
+cy_en_syspm_status_t Cy_SCB_EZI2C_DeepSleepCallback(cy_stc_syspm_callback_params_t *params,
+                                                    cy_en_syspm_callback_mode_t mode);
+
+void Cy_SCB_UART_Init(CySCB_Type *base, const cy_stc_scb_uart_config_t *config,
+                      cy_stc_scb_uart_context_t *context);
+void Cy_SCB_UART_Enable(CySCB_Type *base);
+void Cy_SCB_UART_PutString(CySCB_Type *base, const char *string);
+
+cy_en_flashdrv_status_t Cy_Flash_WriteRow(uint32_t rowAddr, const uint32_t *data);
+
+#endif /* CY_PDL_H */
+
+/* [] END OF FILE */
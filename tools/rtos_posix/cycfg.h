@@ -0,0 +1,79 @@
+/******************************************************************************
+* File Name: cycfg.h
+*
+* Description: Host stand-in for the generated peripheral configuration, used by
+*              the FreeRTOS POSIX build of the RTOS_EN variant.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef CYCFG_H
+#define CYCFG_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define CYBSP_EZI2C_HW                   (&sim_scb0)
+#define CYBSP_EZI2C_IRQ                  (scb_0_interrupt_IRQn)
+#define CYBSP_UART_HW                    (&sim_scb1)
+#define CYBSP_CSD_HW                     (&sim_csd)
+#define CYBSP_CSD_IRQ                    (csd_interrupt_IRQn)
+
+#define CYBSP_LED_BTN0_PORT              (&sim_led_port)
+#define CYBSP_LED_BTN0_NUM               (0u)
+#define CYBSP_LED_BTN1_PORT              (&sim_led_port)
+#define CYBSP_LED_BTN1_NUM               (1u)
+#define CYBSP_LED_STATE_ON               (0u)
+#define CYBSP_LED_STATE_OFF              (1u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern CySCB_Type sim_scb0;
+extern CySCB_Type sim_scb1;
+extern CSD_Type sim_csd;
+extern GPIO_PRT_Type sim_led_port;
+
+extern const cy_stc_scb_ezi2c_config_t CYBSP_EZI2C_config;
+extern const cy_stc_scb_uart_config_t CYBSP_UART_config;
+
+#endif /* CYCFG_H */
+
+/* [] END OF FILE */
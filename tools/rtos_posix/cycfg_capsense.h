@@ -0,0 +1,194 @@
+/******************************************************************************
+* File Name: cycfg_capsense.h
+*
+* Description: Host stand-in for the CapSense configuration and middleware API,
+*              used by the FreeRTOS POSIX build of the RTOS_EN variant. Two button
+*              widgets with one sensor each, as in design.modus. The functions are
+*              implemented in sim_hw.c.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef CYCFG_CAPSENSE_H
+#define CYCFG_CAPSENSE_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* One button widget per sensor, the timing model may scan more of them */
+#ifndef CY_CAPSENSE_SENSOR_COUNT
+#define CY_CAPSENSE_SENSOR_COUNT             (2u)
+#endif
+#define CY_CAPSENSE_WIDGET_COUNT             (CY_CAPSENSE_SENSOR_COUNT)
+#define CY_CAPSENSE_BUTTON0_WDGT_ID          (0u)
+#define CY_CAPSENSE_BUTTON1_WDGT_ID          (1u)
+#define CY_CAPSENSE_BUTTON0_SNS0_ID          (0u)
+#define CY_CAPSENSE_BUTTON1_SNS0_ID          (0u)
+#define CY_CAPSENSE_BIST_EN                  (1u)
+
+#define CY_CAPSENSE_BUSY                     (0x80u)
+#define CY_CAPSENSE_NOT_BUSY                 (0u)
+#define CY_CAPSENSE_MFS_CH0_INDEX            (0u)
+#define CY_CAPSENSE_SNS_TOUCH_STATUS_MASK    (0x01u)
+#define CY_CAPSENSE_WD_ACTIVE_MASK           (0x01u)
+
+#define CY_CAPSENSE_STATUS_SUCCESS           (0u)
+#define CY_CAPSENSE_STATUS_BAD_PARAM         (1u)
+#define CY_CAPSENSE_STATUS_BAD_DATA          (2u)
+#define CY_CAPSENSE_STATUS_BAD_CONFIG        (4u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef uint32_t cy_capsense_status_t;
+
+typedef enum
+{
+    CY_CAPSENSE_BIST_SUCCESS_E = 0,
+    CY_CAPSENSE_BIST_HW_BUSY_E = 3,
+} cy_en_capsense_bist_status_t;
+
+typedef struct
+{
+    uint16_t raw;
+    uint16_t bsln;
+    uint16_t diff;
+    uint8_t status;
+    uint8_t negBslnRstCnt;
+    uint8_t idacComp;
+    uint8_t bslnExt;
+} cy_stc_capsense_sensor_context_t;
+
+typedef struct
+{
+    uint16_t fingerCap;
+    uint16_t sigPFC;
+    uint16_t resolution;
+    uint16_t maxRawCount;
+    uint16_t fingerTh;
+    uint16_t proxTh;
+    uint16_t lowBslnRst;
+    uint16_t snsClk;
+    uint16_t rowSnsClk;
+    uint16_t noiseTh;
+    uint16_t nNoiseTh;
+    uint16_t hysteresis;
+    uint8_t onDebounce;
+    uint8_t snsClkSource;
+    uint8_t idacMod[3];
+    uint8_t idacGainIndex;
+    uint8_t rowIdacMod[3];
+    uint8_t bslnCoeff;
+    uint8_t status;
+} cy_stc_capsense_widget_context_t;
+
+typedef struct
+{
+    cy_stc_capsense_widget_context_t *ptrWdContext;
+    cy_stc_capsense_sensor_context_t *ptrSnsContext;
+    uint8_t *ptrDebounceArr;
+    uint16_t numSns;
+    uint8_t senseMethod;
+    uint8_t wdType;
+} cy_stc_capsense_widget_config_t;
+
+typedef struct
+{
+    uint32_t gainReg;
+    uint32_t gainValue;
+} cy_stc_capsense_idac_gain_table_t;
+
+typedef struct
+{
+    uint32_t cpuClkHz;
+    uint32_t periClkHz;
+    uint16_t numWd;
+    uint16_t numSns;
+    uint16_t csdVref;
+    uint8_t csdRawTarget;
+    cy_stc_capsense_idac_gain_table_t idacGainTable[6];
+} cy_stc_capsense_common_config_t;
+
+typedef struct
+{
+    uint8_t modCsdClk;
+    uint16_t status;
+} cy_stc_capsense_common_context_t;
+
+typedef struct
+{
+    const cy_stc_capsense_common_config_t *ptrCommonConfig;
+    cy_stc_capsense_common_context_t *ptrCommonContext;
+    const cy_stc_capsense_widget_config_t *ptrWdConfig;
+} cy_stc_capsense_context_t;
+
+typedef struct
+{
+    uint8_t data[64];
+} cy_stc_capsense_tuner_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern cy_stc_capsense_context_t cy_capsense_context;
+extern cy_stc_capsense_tuner_t cy_capsense_tuner;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+cy_capsense_status_t Cy_CapSense_Init(cy_stc_capsense_context_t *context);
+cy_capsense_status_t Cy_CapSense_Enable(cy_stc_capsense_context_t *context);
+cy_capsense_status_t Cy_CapSense_ScanAllWidgets(cy_stc_capsense_context_t *context);
+uint32_t Cy_CapSense_IsBusy(const cy_stc_capsense_context_t *context);
+cy_capsense_status_t Cy_CapSense_ProcessAllWidgets(cy_stc_capsense_context_t *context);
+uint32_t Cy_CapSense_IsWidgetActive(uint32_t widgetId, const cy_stc_capsense_context_t *context);
+uint32_t Cy_CapSense_RunTuner(cy_stc_capsense_context_t *context);
+void Cy_CapSense_InterruptHandler(const CSD_Type *base, cy_stc_capsense_context_t *context);
+cy_capsense_status_t Cy_CapSense_CalibrateAllWidgets(cy_stc_capsense_context_t *context);
+cy_capsense_status_t Cy_CapSense_InitializeAllBaselines(cy_stc_capsense_context_t *context);
+cy_en_capsense_bist_status_t Cy_CapSense_MeasureCapacitanceSensor(uint32_t widgetId, uint32_t sensorId,
+                                                                  uint32_t *ptrValue,
+                                                                  cy_stc_capsense_context_t *context);
+cy_en_syspm_status_t Cy_CapSense_DeepSleepCallback(cy_stc_syspm_callback_params_t *params,
+                                                   cy_en_syspm_callback_mode_t mode);
+
+#endif /* CYCFG_CAPSENSE_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,1480 @@
+/******************************************************************************
+* File Name: sim_hw.c
+*
+* Description: Simulated hardware of the POSIX build: SysTick and the CSD block
+*              in host time, or in virtual time with SIM_VIRTUAL_TIME, a touch
+*              pattern on the buttons, and the PDL and CapSense calls used by
+*              main.c. Checks the scheduling invariants of the scan loop and
+*              prints a summary after SIM_SECONDS seconds.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "sim_hw.h"
+#include "cycfg_capsense.h"
+#include "timestamp.h"
+#include "rtos_tasks.h"
+
+#if RTOS_EN
+#include "FreeRTOS.h"
+#include "task.h"
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define SIM_CPU_HZ               (48000000u)
+#define SIM_NS_PER_MS            (1000000uLL)
+#define SIM_NS_PER_S             (1000000000uLL)
+
+/* Default run time, overridden by the SIM_SECONDS environment variable */
+#define SIM_SECONDS_DEFAULT      (10u)
+
+/* Conversion time of both sensors */
+#define SIM_SCAN_NS              (500000uLL)
+
+/* Longest host sleep of the idle hook */
+#define SIM_SLEEP_NS             (100000uLL)
+
+/* Touch pattern: every SIM_TOUCH_PERIOD_MS, sensor n is touched from
+ * n * SIM_TOUCH_PERIOD_MS / 2 for SIM_TOUCH_MS
+ */
+#define SIM_TOUCH_PERIOD_MS      (1000u)
+#define SIM_TOUCH_MS             (300u)
+
+/* Raw count model */
+#define SIM_RAW_BASE             (800u)
+#define SIM_RAW_NOISE            (3u)
+#define SIM_RAW_SIGNAL           (200u)
+#define SIM_CP_FF                (12000u)
+
+/* LEDs of the board, driven by the first two buttons */
+#define SIM_LED_COUNT            (2u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Invariants, in the order of the violation counters */
+typedef enum
+{
+    CHECK_SCAN_BUSY = 0u,    /* scan started while a scan is in flight */
+    CHECK_PROCESS_BUSY,      /* frame processed while a scan is in flight */
+    CHECK_PROCESS_TWICE,     /* frame processed twice */
+    CHECK_TUNER_BUSY,        /* tuner serviced while a scan is in flight */
+    CHECK_BIST_BUSY,         /* BIST while a scan is in flight */
+    CHECK_TUNER_RATE,        /* tuner not serviced once per frame */
+    CHECK_BIST_RATE,         /* BIST not run at its period */
+    CHECK_TOUCHES,           /* touches reported differ from the pattern */
+    CHECK_COUNT
+} check_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+uint32_t SystemCoreClock = SIM_CPU_HZ;
+
+/* Model parameters: the processing thresholds of design.cycapsense, and the
+ * CPU times of the 2-sensor design at 48 MHz for the virtual time build
+ */
+sim_params_t sim_params =
+{
+    .duration_s = SIM_SECONDS_DEFAULT,
+    .resolution = 10u,
+    .finger_th = 80u,
+    .hysteresis = 10u,
+    .noise_th = 40u,
+    .nnoise_th = 40u,
+    .low_bsln_rst = 30u,
+    .on_debounce = 3u,
+    .bsln_coeff = 1u,
+    .mod_div = 1u,
+    .init_mod_cycles = 10u,
+    .entry_cycles = 16u,
+    .systick_cycles = 40u,
+    .csd_isr_cycles = 1200u,
+    .ezi2c_isr_cycles = { 240u, 240u },
+    .scan_setup_cycles = 600u,
+    .process_cycles = 4800u,
+    .tuner_cycles = 600u,
+    .bist_cycles = 0u,
+    .flash_cycles = 960000u,
+    .i2c_hz = 400000u,
+    .poll_us = { 0u, 0u },
+    .read_bytes = { 32u, 64u },
+    .vcd_ms = 20.0,
+    .vcd_path = NULL,
+};
+
+sim_frame_stats_t sim_frame_stats = { .period_min = SIM_NEVER };
+sim_raw_source_t sim_raw_source;
+sim_report_hook_t sim_report_hook;
+sim_frame_hook_t sim_frame_hook;
+
+CySCB_Type sim_scb0;
+CySCB_Type sim_scb1;
+CSD_Type sim_csd;
+GPIO_PRT_Type sim_led_port;
+
+const cy_stc_scb_ezi2c_config_t CYBSP_EZI2C_config =
+{
+    .numberOfAddresses = CY_SCB_EZI2C_TWO_ADDRESSES,
+    .slaveAddress1 = 8u,
+    .slaveAddress2 = 9u,
+    .enableWakeFromSleep = false,
+};
+
+const cy_stc_scb_uart_config_t CYBSP_UART_config;
+
+static cy_stc_capsense_sensor_context_t sim_sns_context[CY_CAPSENSE_SENSOR_COUNT];
+
+/* One button widget per sensor, set up by sim_capsense_config() */
+static cy_stc_capsense_widget_context_t sim_wd_context[CY_CAPSENSE_WIDGET_COUNT];
+static cy_stc_capsense_widget_config_t sim_wd_config[CY_CAPSENSE_WIDGET_COUNT];
+static uint8_t sim_debounce[CY_CAPSENSE_SENSOR_COUNT];
+
+static const cy_stc_capsense_common_config_t sim_common_config =
+{
+    .cpuClkHz = SIM_CPU_HZ,
+    .periClkHz = SIM_CPU_HZ,
+    .numWd = CY_CAPSENSE_WIDGET_COUNT,
+    .numSns = CY_CAPSENSE_SENSOR_COUNT,
+};
+
+static cy_stc_capsense_common_context_t sim_common_context;
+
+cy_stc_capsense_context_t cy_capsense_context =
+{
+    .ptrCommonConfig = &sim_common_config,
+    .ptrCommonContext = &sim_common_context,
+    .ptrWdConfig = sim_wd_config,
+};
+
+cy_stc_capsense_tuner_t cy_capsense_tuner;
+
+static const char *check_names[CHECK_COUNT] =
+{
+    "scan_busy", "process_busy", "process_twice", "tuner_busy", "bist_busy",
+    "tuner_rate", "bist_rate", "touches"
+};
+
+static SysTick_Type sim_systick_regs;
+static SCB_Type sim_scb_regs;
+
+/* Interrupt vectors registered by the application */
+static cy_israddress sim_systick_vector;
+static cy_israddress sim_csd_vector;
+
+/* Host time of the next SysTick interrupt and of the last millisecond tick */
+static uint64_t sim_tick_next_ns;
+static volatile uint64_t sim_tick_ns;
+
+static uint64_t sim_start_ns;
+static uint64_t sim_end_ns;
+
+/* CSD state: a scan is in flight until scan_end_ns, raw counts of the scan */
+static volatile bool sim_scan_busy;
+static uint64_t sim_scan_end_ns;
+static uint16_t sim_scan_raw[CY_CAPSENSE_SENSOR_COUNT];
+#if !SIM_VIRTUAL_TIME
+static bool sim_in_isr;
+#endif
+static bool sim_frame_processed = true;
+static uint32_t sim_rng = 1u;
+
+/* Statistics */
+static uint32_t sim_violations[CHECK_COUNT];
+static uint64_t sim_scan_start_ns;
+static uint32_t sim_tuner_count;
+static uint32_t sim_bist_count;
+static uint32_t sim_presses[SIM_LED_COUNT];
+static uint32_t sim_led_state = (1u << SIM_LED_COUNT) - 1u;
+
+#if SIM_VIRTUAL_TIME
+/* Sensor in conversion and start of the first conversion of the scan */
+static uint32_t sim_scan_sensor;
+static uint64_t sim_conv_start_ns;
+#endif
+
+/* Touch log and register map dump, see sim_log_touches() and sim_dump_regs() */
+static FILE *sim_log;
+static uint8_t *sim_regs;
+static uint32_t sim_regs_size;
+
+/*******************************************************************************
+* Function Name: sim_now_ns
+********************************************************************************
+* Summary:
+*  Returns the host monotonic time, or the virtual time with
+*  SIM_VIRTUAL_TIME.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint64_t - time in nanoseconds
+*
+*******************************************************************************/
+uint64_t sim_now_ns(void)
+{
+#if SIM_VIRTUAL_TIME
+    uint64_t cycles = sim_time_cycles();
+
+    return (((cycles / SystemCoreClock) * SIM_NS_PER_S) +
+            (((cycles % SystemCoreClock) * SIM_NS_PER_S) / SystemCoreClock));
+#else
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (((uint64_t)ts.tv_sec * SIM_NS_PER_S) + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: sim_sleep_ns
+********************************************************************************
+* Summary:
+*  Sleeps on the host for the given time. In virtual time the CPU busy waits
+*  for it, as Cy_SysLib_Delay() does.
+*
+* Parameters:
+*  ns - sleep time in nanoseconds
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_sleep_ns(uint64_t ns)
+{
+#if SIM_VIRTUAL_TIME
+    sim_run(SIM_REGION_WAIT, (ns * (SystemCoreClock / 1000000u)) / 1000u);
+#else
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)(ns / SIM_NS_PER_S);
+    ts.tv_nsec = (long)(ns % SIM_NS_PER_S);
+    (void)nanosleep(&ts, NULL);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: sim_violation
+********************************************************************************
+* Summary:
+*  Counts a violation of an invariant and reports the first one.
+*
+* Parameters:
+*  check - violated invariant
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_violation(check_t check)
+{
+    if (0u == sim_violations[check])
+    {
+        printf("violation %s at %.3f s\n", check_names[check],
+               (double)(sim_now_ns() - sim_start_ns) / (double)SIM_NS_PER_S);
+    }
+    sim_violations[check]++;
+}
+
+/*******************************************************************************
+* Function Name: sim_touched
+********************************************************************************
+* Summary:
+*  Returns the finger state of a sensor in the touch pattern. The touches of
+*  the sensors are spread over the period and none is in progress at the
+*  start, when the baselines are seeded.
+*
+* Parameters:
+*  sns_index - sensor index
+*  ms - time since the start of the simulation in milliseconds
+*
+* Return:
+*  bool - true if the finger is on the sensor
+*
+*******************************************************************************/
+static bool sim_touched(uint32_t sns_index, uint64_t ms)
+{
+    uint64_t start = ((uint64_t)(sns_index + 1u) * SIM_TOUCH_PERIOD_MS) / (CY_CAPSENSE_SENSOR_COUNT + 1u);
+    uint64_t phase = (ms + SIM_TOUCH_PERIOD_MS - start) % SIM_TOUCH_PERIOD_MS;
+
+    return (phase < SIM_TOUCH_MS);
+}
+
+/*******************************************************************************
+* Function Name: sim_pattern_raw
+********************************************************************************
+* Summary:
+*  Default raw count source: SIM_RAW_BASE with uniform noise, plus
+*  SIM_RAW_SIGNAL while the touch pattern has a finger on the sensor.
+*
+* Parameters:
+*  sns_index - sensor index
+*  now_ns - time of the end of the conversion
+*
+* Return:
+*  uint16_t - raw count
+*
+*******************************************************************************/
+static uint16_t sim_pattern_raw(uint32_t sns_index, uint64_t now_ns)
+{
+    uint16_t raw;
+
+    sim_rng = (sim_rng * 1103515245u) + 12345u;
+    raw = (uint16_t)((SIM_RAW_BASE - SIM_RAW_NOISE) + ((sim_rng >> 16u) % ((2u * SIM_RAW_NOISE) + 1u)));
+    if (sim_touched(sns_index, (now_ns - sim_start_ns) / SIM_NS_PER_MS))
+    {
+        raw += SIM_RAW_SIGNAL;
+    }
+
+    return (raw);
+}
+
+/*******************************************************************************
+* Function Name: sim_latch_raw
+********************************************************************************
+* Summary:
+*  Latches the raw count of a sensor at the end of its conversion, limited to
+*  the maximum raw count of the widget.
+*
+* Parameters:
+*  sns_index - sensor index
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_latch_raw(uint32_t sns_index)
+{
+    uint16_t raw = sim_raw_source(sns_index, sim_now_ns());
+    uint16_t max = sim_wd_context[sns_index].maxRawCount;
+
+    sim_scan_raw[sns_index] = (raw > max) ? max : raw;
+}
+
+/*******************************************************************************
+* Function Name: sim_capsense_config
+********************************************************************************
+* Summary:
+*  Sets up one button widget per sensor with the scan resolution, processing
+*  thresholds and modulator clock divider of sim_params.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_capsense_config(void)
+{
+    uint32_t i;
+
+    for (i = 0u; i < CY_CAPSENSE_WIDGET_COUNT; i++)
+    {
+        sim_wd_context[i].resolution = (uint16_t)sim_params.resolution;
+        sim_wd_context[i].maxRawCount = (uint16_t)((1uL << sim_params.resolution) - 1u);
+        sim_wd_context[i].fingerTh = (uint16_t)sim_params.finger_th;
+        sim_wd_context[i].hysteresis = (uint16_t)sim_params.hysteresis;
+        sim_wd_context[i].noiseTh = (uint16_t)sim_params.noise_th;
+        sim_wd_context[i].nNoiseTh = (uint16_t)sim_params.nnoise_th;
+        sim_wd_context[i].lowBslnRst = (uint16_t)sim_params.low_bsln_rst;
+        sim_wd_context[i].onDebounce = (uint8_t)sim_params.on_debounce;
+        sim_wd_context[i].bslnCoeff = (uint8_t)sim_params.bsln_coeff;
+        sim_wd_config[i].ptrWdContext = &sim_wd_context[i];
+        sim_wd_config[i].ptrSnsContext = &sim_sns_context[i];
+        sim_wd_config[i].ptrDebounceArr = &sim_debounce[i];
+        sim_wd_config[i].numSns = 1u;
+    }
+    sim_common_context.modCsdClk = (uint8_t)sim_params.mod_div;
+
+    if (NULL == sim_raw_source)
+    {
+        sim_raw_source = sim_pattern_raw;
+    }
+}
+
+#if SIM_VIRTUAL_TIME
+/*******************************************************************************
+* Function Name: sim_conv_cycles
+********************************************************************************
+* Summary:
+*  Returns the CPU cycles of the conversion of a sensor: the sense clock
+*  periods of its resolution plus the modulator initialization, at the
+*  modulator clock divider of the common context.
+*
+* Parameters:
+*  context - CapSense context
+*  sns_index - sensor index
+*
+* Return:
+*  uint64_t - conversion time in CPU cycles
+*
+*******************************************************************************/
+static uint64_t sim_conv_cycles(const cy_stc_capsense_context_t *context, uint32_t sns_index)
+{
+    uint64_t periods = ((1uLL << context->ptrWdConfig[sns_index].ptrWdContext->resolution) - 1u) +
+                       sim_params.init_mod_cycles;
+
+    return (periods * context->ptrCommonContext->modCsdClk);
+}
+#endif /* SIM_VIRTUAL_TIME */
+
+/*******************************************************************************
+* Function Name: sim_log_touches
+********************************************************************************
+* Summary:
+*  Appends the touch state of the processed frame to the SIM_LOG file, in the
+*  format of "touch_history.py --frames".
+*
+* Parameters:
+*  context - CapSense context
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_log_touches(const cy_stc_capsense_context_t *context)
+{
+    uint32_t i;
+
+    if (NULL == sim_log)
+    {
+        return;
+    }
+
+    fprintf(sim_log, "%lu", (unsigned long)sim_frame_stats.frames);
+    for (i = 0u; i < CY_CAPSENSE_SENSOR_COUNT; i++)
+    {
+        fprintf(sim_log, ",%u", context->ptrWdConfig[i].ptrSnsContext->status & CY_CAPSENSE_SNS_TOUCH_STATUS_MASK);
+    }
+    fprintf(sim_log, "\n");
+}
+
+/*******************************************************************************
+* Function Name: sim_dump_regs
+********************************************************************************
+* Summary:
+*  Writes the EZI2C buffer, the register map with HOST_REGS_EN, to the SIM_DUMP
+*  file as a host would read it.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_dump_regs(void)
+{
+    const char *path = getenv("SIM_DUMP");
+    FILE *file;
+
+    if ((NULL == path) || (NULL == sim_regs))
+    {
+        return;
+    }
+
+    file = fopen(path, "wb");
+    if (NULL != file)
+    {
+        (void)fwrite(sim_regs, 1u, sim_regs_size, file);
+        (void)fclose(file);
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_report
+********************************************************************************
+* Summary:
+*  Checks the rates against the elapsed time, prints the summary, then the
+*  results of sim_report_hook, and ends the simulation. The exit code is 1 if
+*  any invariant or check of the hook failed.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_report(void)
+{
+    uint64_t elapsed_ms = (sim_now_ns() - sim_start_ns) / SIM_NS_PER_MS;
+    uint32_t expected_presses = (uint32_t)(elapsed_ms / SIM_TOUCH_PERIOD_MS);
+    uint32_t expected_bist;
+    uint32_t total = 0u;
+    uint32_t i;
+
+    /* The tuner is serviced after every frame, the last one may be pending */
+    if ((sim_tuner_count + 1u) < sim_frame_stats.frames)
+    {
+        sim_violation(CHECK_TUNER_RATE);
+    }
+
+#if RTOS_EN
+    expected_bist = (uint32_t)(elapsed_ms / RTOS_DIAG_PERIOD_MS);
+#else
+    expected_bist = sim_frame_stats.frames;
+#endif
+    if ((sim_bist_count + 1u < expected_bist) || (sim_bist_count > expected_bist + 1u))
+    {
+        sim_violation(CHECK_BIST_RATE);
+    }
+
+    /* Another raw count source has its own touches */
+    for (i = 0u; (sim_pattern_raw == sim_raw_source) && (i < SIM_LED_COUNT); i++)
+    {
+        if ((sim_presses[i] + 1u < expected_presses) || (sim_presses[i] > expected_presses + 1u))
+        {
+            sim_violation(CHECK_TOUCHES);
+        }
+    }
+
+    printf("%s: %llu ms, %lu frames\n", RTOS_EN ? "rtos" : "superloop",
+           (unsigned long long)elapsed_ms, (unsigned long)sim_frame_stats.frames);
+    if (sim_frame_stats.scans > 1u)
+    {
+        printf("frame period: mean %.1f us, max %.1f us\n",
+               (double)sim_frame_stats.period_sum / (1000.0 * (double)(sim_frame_stats.scans - 1u)),
+               (double)sim_frame_stats.period_max / 1000.0);
+    }
+    if (sim_frame_stats.frames > 0u)
+    {
+        printf("scan end to processing: mean %.1f us, max %.1f us\n",
+               (double)sim_frame_stats.latency_sum / (1000.0 * (double)sim_frame_stats.frames),
+               (double)sim_frame_stats.latency_max / 1000.0);
+    }
+#if LOOP_STATS_EN
+    if (loop_stats.frames > 0u)
+    {
+        printf("loop_stats: %lu frames, wake mean %.1f us max %.1f us, busy mean %.1f us max %.1f us, "
+               "%.2f switches per frame\n",
+               (unsigned long)loop_stats.frames,
+               (double)loop_stats.wake_cycles_sum / ((double)loop_stats.frames * (SystemCoreClock / 1e6)),
+               (double)loop_stats.wake_cycles_max / (SystemCoreClock / 1e6),
+               (double)loop_stats.busy_cycles_sum / ((double)loop_stats.frames * (SystemCoreClock / 1e6)),
+               (double)loop_stats.busy_cycles_max / (SystemCoreClock / 1e6),
+               (double)loop_stats.switches / (double)loop_stats.frames);
+    }
+#endif
+    printf("tuner %lu, bist %lu (expected %lu), presses %lu/%lu",
+           (unsigned long)sim_tuner_count, (unsigned long)sim_bist_count,
+           (unsigned long)expected_bist, (unsigned long)sim_presses[0],
+           (unsigned long)sim_presses[1]);
+    if (sim_pattern_raw == sim_raw_source)
+    {
+        printf(" (expected %lu)", (unsigned long)expected_presses);
+    }
+    printf("\n");
+
+    for (i = 0u; i < CHECK_COUNT; i++)
+    {
+        printf("%s%s %lu", (0u == i) ? "violations: " : ", ", check_names[i],
+               (unsigned long)sim_violations[i]);
+        total += sim_violations[i];
+    }
+    printf("\n");
+
+    if (NULL != sim_report_hook)
+    {
+        total += sim_report_hook();
+    }
+    fflush(stdout);
+
+    sim_dump_regs();
+    if (NULL != sim_log)
+    {
+        (void)fclose(sim_log);
+    }
+
+    exit((0u == total) ? 0 : 1);
+}
+
+#if !SIM_VIRTUAL_TIME
+/*******************************************************************************
+* Function Name: sim_csd_poll
+********************************************************************************
+* Summary:
+*  Ends the scan in flight if its conversion time has passed: latches the raw
+*  counts of the touch pattern and calls the CSD interrupt handler of the
+*  application.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_csd_poll(void)
+{
+    uint64_t now = sim_now_ns();
+    uint32_t i;
+
+    if (!sim_scan_busy || sim_in_isr || (now < sim_scan_end_ns))
+    {
+        return;
+    }
+
+    for (i = 0u; i < CY_CAPSENSE_SENSOR_COUNT; i++)
+    {
+        sim_latch_raw(i);
+    }
+
+    sim_in_isr = true;
+    if (NULL != sim_csd_vector)
+    {
+        sim_csd_vector();
+    }
+    sim_in_isr = false;
+}
+#endif /* !SIM_VIRTUAL_TIME */
+
+/*******************************************************************************
+* Function Name: sim_assert_failed
+********************************************************************************
+* Summary:
+*  CY_ASSERT() handler, ends the simulation.
+*
+* Parameters:
+*  file - source file of the assertion
+*  line - line of the assertion
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_assert_failed(const char *file, int line)
+{
+    printf("assertion failed at %s:%d\n", file, line);
+    fflush(stdout);
+    exit(2);
+}
+
+/*******************************************************************************
+* Function Name: sim_systick
+********************************************************************************
+* Summary:
+*  Updates the SysTick counter from the host time and returns its registers.
+*  While a SysTick vector is installed and the counter is enabled, the elapsed
+*  periods are delivered to the vector as in timestamp_init(). After
+*  timestamp_start_kernel_tick() the kernel tick hook advances timestamp_ms
+*  and the counter runs from the time that value last changed. In virtual
+*  time sim_time.c runs the counter and its interrupt.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  SysTick_Type * - the SysTick registers
+*
+*******************************************************************************/
+SysTick_Type *sim_systick(void)
+{
+#if SIM_VIRTUAL_TIME
+    sim_systick_sync(&sim_systick_regs);
+
+    return (&sim_systick_regs);
+#else
+    uint64_t now = sim_now_ns();
+    uint64_t cycles;
+
+    if ((NULL != sim_systick_vector) && (0u != (sim_systick_regs.CTRL & SysTick_CTRL_ENABLE_Msk)))
+    {
+        while (now >= sim_tick_next_ns)
+        {
+            sim_tick_ns = sim_tick_next_ns;
+            sim_tick_next_ns += SIM_NS_PER_MS;
+            sim_systick_vector();
+        }
+    }
+
+    cycles = ((now - sim_tick_ns) * (SIM_CPU_HZ / 1000000u)) / 1000u;
+    if (cycles > sim_systick_regs.LOAD)
+    {
+        cycles = sim_systick_regs.LOAD;
+    }
+    sim_systick_regs.VAL = sim_systick_regs.LOAD - (uint32_t)cycles;
+
+    return (&sim_systick_regs);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: sim_kernel_tick
+********************************************************************************
+* Summary:
+*  Records the host time of a kernel tick. Called by the kernel right before
+*  the tick hook advances timestamp_ms.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_kernel_tick(void)
+{
+    sim_tick_ns = sim_now_ns();
+}
+
+/*******************************************************************************
+* Function Name: sim_scb
+********************************************************************************
+* Summary:
+*  Returns the SCB registers. In host time no SysTick interrupt is ever
+*  pending, ticks are delivered when SysTick is read. In virtual time ICSR
+*  shows a SysTick interrupt held off by a critical section.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  SCB_Type * - the SCB registers
+*
+*******************************************************************************/
+SCB_Type *sim_scb(void)
+{
+#if SIM_VIRTUAL_TIME
+    sim_systick_sync(&sim_systick_regs);
+    sim_scb_regs.ICSR = sim_irq_pending(SysTick_IRQn) ? SCB_ICSR_PENDSTSET_Msk : 0u;
+#else
+    sim_scb_regs.ICSR = 0u;
+#endif
+
+    return (&sim_scb_regs);
+}
+
+cy_rslt_t cybsp_init(void)
+{
+    const char *seconds = getenv("SIM_SECONDS");
+    const char *log = getenv("SIM_LOG");
+    uint32_t i;
+
+    if (NULL != seconds)
+    {
+        sim_params.duration_s = atof(seconds);
+    }
+
+    sim_capsense_config();
+#if SIM_VIRTUAL_TIME
+    sim_time_init();
+    sim_time_end((uint64_t)(sim_params.duration_s * SystemCoreClock));
+#endif
+
+    sim_start_ns = sim_now_ns();
+    sim_tick_next_ns = sim_start_ns + SIM_NS_PER_MS;
+    sim_tick_ns = sim_start_ns;
+    sim_end_ns = sim_start_ns + (uint64_t)(sim_params.duration_s * SIM_NS_PER_S);
+
+    if (NULL != log)
+    {
+        sim_log = fopen(log, "w");
+        if (NULL != sim_log)
+        {
+            fprintf(sim_log, "frame");
+            for (i = 0u; i < CY_CAPSENSE_SENSOR_COUNT; i++)
+            {
+                fprintf(sim_log, ",sns%lu", (unsigned long)i);
+            }
+            fprintf(sim_log, "\n");
+        }
+    }
+
+    return (CY_RSLT_SUCCESS);
+}
+
+void NVIC_EnableIRQ(IRQn_Type irq) { (void)irq; }
+void NVIC_DisableIRQ(IRQn_Type irq) { (void)irq; }
+void NVIC_ClearPendingIRQ(IRQn_Type irq) { (void)irq; }
+
+void NVIC_SetPriority(IRQn_Type irq, uint32_t priority)
+{
+#if SIM_VIRTUAL_TIME
+    sim_irq_priority(irq, priority);
+#else
+    (void)irq;
+    (void)priority;
+#endif
+}
+
+cy_en_sysint_status_t Cy_SysInt_Init(const cy_stc_sysint_t *config, cy_israddress isr)
+{
+    if (csd_interrupt_IRQn == config->intrSrc)
+    {
+        sim_csd_vector = isr;
+    }
+#if SIM_VIRTUAL_TIME
+    sim_irq_vector(config->intrSrc, isr);
+    sim_irq_priority(config->intrSrc, config->intrPriority);
+#endif
+
+    return (CY_SYSINT_SUCCESS);
+}
+
+cy_israddress Cy_SysInt_SetVector(IRQn_Type irq, cy_israddress isr)
+{
+    cy_israddress prev = NULL;
+
+    if (SysTick_IRQn == irq)
+    {
+        prev = sim_systick_vector;
+        sim_systick_vector = isr;
+    }
+#if SIM_VIRTUAL_TIME
+    sim_irq_vector(irq, isr);
+#endif
+
+    return (prev);
+}
+
+uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+#if SIM_VIRTUAL_TIME
+    return (sim_primask_set());
+#else
+#if RTOS_EN
+    taskENTER_CRITICAL();
+#endif
+
+    return (0u);
+#endif
+}
+
+void Cy_SysLib_ExitCriticalSection(uint32_t saved)
+{
+#if SIM_VIRTUAL_TIME
+    sim_primask_restore(saved);
+#else
+    (void)saved;
+#if RTOS_EN
+    taskEXIT_CRITICAL();
+#endif
+#endif
+}
+
+void Cy_SysLib_Delay(uint32_t ms) { sim_sleep_ns((uint64_t)ms * SIM_NS_PER_MS); }
+void Cy_SysLib_DelayUs(uint16_t us) { sim_sleep_ns((uint64_t)us * 1000u); }
+
+/*******************************************************************************
+* Function Name: Cy_SysPm_CpuEnterSleep
+********************************************************************************
+* Summary:
+*  Sleeps on the host until the scan in flight ends, or for SIM_SLEEP_NS, and
+*  delivers the CSD interrupt. With RTOS_EN it is called by the idle hook,
+*  which is the only task ready while a scan runs. In virtual time it waits
+*  for the next interrupt as WFI does.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void Cy_SysPm_CpuEnterSleep(void)
+{
+#if SIM_VIRTUAL_TIME
+    sim_wait();
+#else
+    uint64_t now = sim_now_ns();
+    uint64_t ns = SIM_SLEEP_NS;
+
+    if (sim_scan_busy && (sim_scan_end_ns > now) && ((sim_scan_end_ns - now) < ns))
+    {
+        ns = sim_scan_end_ns - now;
+    }
+    if (!sim_scan_busy || (sim_scan_end_ns > now))
+    {
+        sim_sleep_ns(ns);
+    }
+
+    sim_csd_poll();
+#endif
+}
+
+cy_en_syspm_status_t Cy_SysPm_CpuEnterDeepSleep(void)
+{
+    Cy_SysPm_CpuEnterSleep();
+
+    return (CY_SYSPM_SUCCESS);
+}
+
+bool Cy_SysPm_RegisterCallback(cy_stc_syspm_callback_t *handler) { (void)handler; return (true); }
+
+void Cy_GPIO_Write(GPIO_PRT_Type *base, uint32_t pin, uint32_t value)
+{
+    uint32_t mask = 1uL << pin;
+
+    (void)base;
+
+    /* Count the presses at the edge of the LED turning on */
+    if ((CYBSP_LED_STATE_ON == value) && (0u != (sim_led_state & mask)))
+    {
+        sim_presses[pin]++;
+    }
+    sim_led_state = (CYBSP_LED_STATE_ON == value) ? (sim_led_state & ~mask) : (sim_led_state | mask);
+}
+
+void Cy_GPIO_Inv(GPIO_PRT_Type *base, uint32_t pin) { (void)base; (void)pin; }
+uint32_t Cy_GPIO_Read(GPIO_PRT_Type *base, uint32_t pin) { (void)base; (void)pin; return (0u); }
+
+cy_en_scb_ezi2c_status_t Cy_SCB_EZI2C_Init(CySCB_Type *base, const cy_stc_scb_ezi2c_config_t *config,
+                                           cy_stc_scb_ezi2c_context_t *context)
+{
+    (void)base;
+    (void)config;
+    (void)context;
+
+    return (CY_SCB_EZI2C_SUCCESS);
+}
+
+void Cy_SCB_EZI2C_Enable(CySCB_Type *base) { (void)base; }
+
+void Cy_SCB_EZI2C_SetBuffer1(CySCB_Type const *base, uint8_t *buffer, uint32_t size,
+                             uint32_t rwBoundary, cy_stc_scb_ezi2c_context_t *context)
+{
+    (void)base;
+    (void)rwBoundary;
+    context->buf1 = buffer;
+    context->buf1Size = size;
+    sim_regs = buffer;
+    sim_regs_size = size;
+}
+
+void Cy_SCB_EZI2C_SetBuffer2(CySCB_Type const *base, uint8_t *buffer, uint32_t size,
+                             uint32_t rwBoundary, cy_stc_scb_ezi2c_context_t *context)
+{
+    (void)base;
+    (void)rwBoundary;
+    context->buf2 = buffer;
+    context->buf2Size = size;
+}
+
+/*******************************************************************************
+* Function Name: Cy_SCB_EZI2C_Interrupt
+********************************************************************************
+* Summary:
+*  In virtual time, handles the byte of the master that owns the bus and
+*  flags the end of its read for Cy_SCB_EZI2C_GetActivity(). The host reads
+*  the second buffer when one is set, the Tuner the first one.
+*
+* Parameters:
+*  base - SCB block
+*  context - EZI2C context
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void Cy_SCB_EZI2C_Interrupt(CySCB_Type *base, cy_stc_scb_ezi2c_context_t *context)
+{
+#if SIM_VIRTUAL_TIME
+    int32_t master = sim_i2c_isr();
+
+    if ((SIM_MASTER_HOST == master) && (NULL != context->buf2))
+    {
+        context->status |= CY_SCB_EZI2C_STATUS_READ2;
+    }
+    else if (master >= 0)
+    {
+        context->status |= CY_SCB_EZI2C_STATUS_READ1;
+    }
+    else
+    {
+        /* The read goes on */
+    }
+#else
+    (void)context;
+#endif
+    (void)base;
+}
+
+uint32_t Cy_SCB_EZI2C_GetActivity(CySCB_Type const *base, cy_stc_scb_ezi2c_context_t *context)
+{
+    uint32_t status = context->status;
+
+    (void)base;
+    context->status = 0u;
+
+    return (status);
+}
+
+cy_en_syspm_status_t Cy_SCB_EZI2C_DeepSleepCallback(cy_stc_syspm_callback_params_t *params,
+                                                    cy_en_syspm_callback_mode_t mode)
+{
+    (void)params;
+    (void)mode;
+
+    return (CY_SYSPM_SUCCESS);
+}
+
+void Cy_SCB_UART_Init(CySCB_Type *base, const cy_stc_scb_uart_config_t *config,
+                      cy_stc_scb_uart_context_t *context)
+{
+    (void)base;
+    (void)config;
+    (void)context;
+}
+
+void Cy_SCB_UART_Enable(CySCB_Type *base) { (void)base; }
+void Cy_SCB_UART_PutString(CySCB_Type *base, const char *string) { (void)base; fputs(string, stdout); }
+
+cy_en_flashdrv_status_t Cy_Flash_WriteRow(uint32_t rowAddr, const uint32_t *data)
+{
+    (void)rowAddr;
+    (void)data;
+
+#if SIM_VIRTUAL_TIME
+    /* The CPU runs the SROM routine for the whole row write */
+    sim_run(SIM_REGION_FLASH, sim_params.flash_cycles);
+#endif
+
+    return (CY_FLASH_DRV_SUCCESS);
+}
+
+cy_capsense_status_t Cy_CapSense_Init(cy_stc_capsense_context_t *context)
+{
+    (void)context;
+
+    return (CY_CAPSENSE_STATUS_SUCCESS);
+}
+
+cy_capsense_status_t Cy_CapSense_Enable(cy_stc_capsense_context_t *context)
+{
+    return (Cy_CapSense_InitializeAllBaselines(context));
+}
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_ScanAllWidgets
+********************************************************************************
+* Summary:
+*  Starts a scan of both sensors that ends after SIM_SCAN_NS. Records the frame
+*  period and ends the simulation after SIM_SECONDS. In virtual time the scan
+*  setup is charged to the CPU and the sensors are converted one after the
+*  other, each conversion ends with a CSD interrupt.
+*
+* Parameters:
+*  context - CapSense context
+*
+* Return:
+*  cy_capsense_status_t - CY_CAPSENSE_STATUS_SUCCESS
+*
+*******************************************************************************/
+cy_capsense_status_t Cy_CapSense_ScanAllWidgets(cy_stc_capsense_context_t *context)
+{
+    uint64_t now = sim_now_ns();
+    uint64_t period;
+
+    (void)context;
+
+    if (sim_scan_busy)
+    {
+        sim_violation(CHECK_SCAN_BUSY);
+        return (CY_CAPSENSE_STATUS_SUCCESS);
+    }
+
+    if (now >= sim_end_ns)
+    {
+        sim_report();
+    }
+
+    if (0u != sim_frame_stats.scans)
+    {
+        period = now - sim_scan_start_ns;
+        sim_frame_stats.period_sum += period;
+        if (period < sim_frame_stats.period_min)
+        {
+            sim_frame_stats.period_min = period;
+        }
+        if (period > sim_frame_stats.period_max)
+        {
+            sim_frame_stats.period_max = period;
+        }
+    }
+    sim_frame_stats.scans++;
+    sim_scan_start_ns = now;
+
+#if SIM_VIRTUAL_TIME
+    sim_run(SIM_REGION_SCAN_SETUP, sim_params.scan_setup_cycles);
+
+    sim_scan_sensor = 0u;
+    sim_scan_busy = true;
+    sim_conv_start_ns = sim_now_ns();
+    sim_csd_convert(sim_conv_cycles(context, 0u));
+#else
+    sim_scan_end_ns = now + SIM_SCAN_NS;
+    sim_scan_busy = true;
+#endif
+
+    return (CY_CAPSENSE_STATUS_SUCCESS);
+}
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_IsBusy
+********************************************************************************
+* Summary:
+*  Returns the scan state. Polling ends a scan whose conversion time has
+*  passed, as the interrupt would. In virtual time a busy poll runs the CPU
+*  up to the next event.
+*
+* Parameters:
+*  context - CapSense context
+*
+* Return:
+*  uint32_t - CY_CAPSENSE_BUSY or CY_CAPSENSE_NOT_BUSY
+*
+*******************************************************************************/
+uint32_t Cy_CapSense_IsBusy(const cy_stc_capsense_context_t *context)
+{
+    (void)context;
+
+#if SIM_VIRTUAL_TIME
+    if (sim_scan_busy)
+    {
+        sim_spin();
+    }
+#else
+    sim_csd_poll();
+#endif
+
+    return (sim_scan_busy ? CY_CAPSENSE_BUSY : CY_CAPSENSE_NOT_BUSY);
+}
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_InterruptHandler
+********************************************************************************
+* Summary:
+*  Ends the scan with the latched raw counts. In virtual time it handles the
+*  end of one conversion: stores the raw count of the sensor and starts the
+*  next one, the last sensor ends the scan.
+*
+* Parameters:
+*  base - CSD block
+*  context - CapSense context
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void Cy_CapSense_InterruptHandler(const CSD_Type *base, cy_stc_capsense_context_t *context)
+{
+#if SIM_VIRTUAL_TIME
+    uint64_t scan;
+
+    (void)base;
+
+    sim_run(SIM_REGION_WAIT, sim_params.csd_isr_cycles);
+
+    sim_latch_raw(sim_scan_sensor);
+    context->ptrWdConfig[sim_scan_sensor].ptrSnsContext->raw = sim_scan_raw[sim_scan_sensor];
+    sim_scan_sensor++;
+    if (sim_scan_sensor < CY_CAPSENSE_SENSOR_COUNT)
+    {
+        sim_csd_convert(sim_conv_cycles(context, sim_scan_sensor));
+        return;
+    }
+
+    sim_scan_end_ns = sim_now_ns();
+    scan = sim_scan_end_ns - sim_conv_start_ns;
+    sim_frame_stats.scan_sum += scan;
+    if (scan > sim_frame_stats.scan_max)
+    {
+        sim_frame_stats.scan_max = scan;
+    }
+#else
+    uint32_t i;
+
+    (void)base;
+
+    for (i = 0u; i < CY_CAPSENSE_SENSOR_COUNT; i++)
+    {
+        context->ptrWdConfig[i].ptrSnsContext->raw = sim_scan_raw[i];
+    }
+
+    sim_scan_end_ns = sim_now_ns();
+#endif
+    sim_frame_processed = false;
+    sim_scan_busy = false;
+}
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_ProcessAllWidgets
+********************************************************************************
+* Summary:
+*  Baseline and touch processing of every sensor, following the CapSense
+*  middleware with sensor auto-reset disabled, as in design.cycapsense:
+*  - the baseline follows the raw count through an IIR filter of bslnCoeff /
+*    256 while the difference is below the noise threshold, and is frozen
+*    above it
+*  - a raw count below the baseline by more than the negative noise threshold
+*    for lowBslnRst frames resets the baseline
+*  - touch turns on after onDebounce frames at or above fingerTh +
+*    hysteresis and off below fingerTh - hysteresis
+*  Then calls sim_frame_hook.
+*
+* Parameters:
+*  context - CapSense context
+*
+* Return:
+*  cy_capsense_status_t - CY_CAPSENSE_STATUS_SUCCESS
+*
+*******************************************************************************/
+cy_capsense_status_t Cy_CapSense_ProcessAllWidgets(cy_stc_capsense_context_t *context)
+{
+    uint64_t latency = sim_now_ns() - sim_scan_end_ns;
+    uint32_t i;
+
+    if (sim_scan_busy)
+    {
+        sim_violation(CHECK_PROCESS_BUSY);
+    }
+    if (sim_frame_processed)
+    {
+        sim_violation(CHECK_PROCESS_TWICE);
+    }
+    sim_frame_processed = true;
+
+    sim_frame_stats.frames++;
+    sim_frame_stats.latency_sum += latency;
+    if (latency > sim_frame_stats.latency_max)
+    {
+        sim_frame_stats.latency_max = latency;
+    }
+
+#if SIM_VIRTUAL_TIME
+    sim_run(SIM_REGION_PROCESS, sim_params.process_cycles);
+#endif
+
+    for (i = 0u; i < CY_CAPSENSE_WIDGET_COUNT; i++)
+    {
+        const cy_stc_capsense_widget_config_t *wd = &context->ptrWdConfig[i];
+        const cy_stc_capsense_widget_context_t *wd_cxt = wd->ptrWdContext;
+        cy_stc_capsense_sensor_context_t *sns = wd->ptrSnsContext;
+        uint32_t raw = sns->raw;
+        uint32_t bsln = sns->bsln;
+        uint32_t bsln_q8 = (bsln << 8u) | sns->bslnExt;
+        uint32_t diff = 0u;
+
+        if (raw > bsln)
+        {
+            diff = raw - bsln;
+            sns->negBslnRstCnt = 0u;
+            if (diff < wd_cxt->noiseTh)
+            {
+                bsln_q8 += (((raw << 8u) - bsln_q8) * wd_cxt->bslnCoeff) >> 8u;
+            }
+        }
+        else if ((bsln - raw) > wd_cxt->nNoiseTh)
+        {
+            sns->negBslnRstCnt++;
+            if (sns->negBslnRstCnt >= wd_cxt->lowBslnRst)
+            {
+                bsln_q8 = raw << 8u;
+                sns->negBslnRstCnt = 0u;
+            }
+        }
+        else
+        {
+            sns->negBslnRstCnt = 0u;
+            bsln_q8 -= ((bsln_q8 - (raw << 8u)) * wd_cxt->bslnCoeff) >> 8u;
+        }
+        sns->bsln = (uint16_t)(bsln_q8 >> 8u);
+        sns->bslnExt = (uint8_t)bsln_q8;
+        sns->diff = (uint16_t)diff;
+
+        if (0u != (sns->status & CY_CAPSENSE_SNS_TOUCH_STATUS_MASK))
+        {
+            if (diff < (uint32_t)(wd_cxt->fingerTh - wd_cxt->hysteresis))
+            {
+                sns->status &= (uint8_t)~CY_CAPSENSE_SNS_TOUCH_STATUS_MASK;
+            }
+        }
+        else if (diff >= (uint32_t)(wd_cxt->fingerTh + wd_cxt->hysteresis))
+        {
+            (*wd->ptrDebounceArr)++;
+            if (*wd->ptrDebounceArr >= wd_cxt->onDebounce)
+            {
+                sns->status |= CY_CAPSENSE_SNS_TOUCH_STATUS_MASK;
+                *wd->ptrDebounceArr = 0u;
+            }
+        }
+        else
+        {
+            *wd->ptrDebounceArr = 0u;
+        }
+
+        wd->ptrWdContext->status = (uint8_t)(sns->status & CY_CAPSENSE_WD_ACTIVE_MASK);
+    }
+
+    sim_log_touches(context);
+
+    if (NULL != sim_frame_hook)
+    {
+        sim_frame_hook(context);
+    }
+
+    return (CY_CAPSENSE_STATUS_SUCCESS);
+}
+
+uint32_t Cy_CapSense_IsWidgetActive(uint32_t widgetId, const cy_stc_capsense_context_t *context)
+{
+    return (context->ptrWdConfig[widgetId].ptrWdContext->status & CY_CAPSENSE_WD_ACTIVE_MASK);
+}
+
+uint32_t Cy_CapSense_RunTuner(cy_stc_capsense_context_t *context)
+{
+    (void)context;
+
+    if (sim_scan_busy)
+    {
+        sim_violation(CHECK_TUNER_BUSY);
+    }
+    sim_tuner_count++;
+
+#if SIM_VIRTUAL_TIME
+    sim_run(SIM_REGION_TUNER, sim_params.tuner_cycles);
+#endif
+
+    return (0u);
+}
+
+cy_capsense_status_t Cy_CapSense_CalibrateAllWidgets(cy_stc_capsense_context_t *context)
+{
+    (void)context;
+
+    return (CY_CAPSENSE_STATUS_SUCCESS);
+}
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_InitializeAllBaselines
+********************************************************************************
+* Summary:
+*  Seeds every baseline from the raw count of one conversion, as the
+*  middleware does from a scan.
+*
+* Parameters:
+*  context - CapSense context
+*
+* Return:
+*  cy_capsense_status_t - CY_CAPSENSE_STATUS_SUCCESS
+*
+*******************************************************************************/
+cy_capsense_status_t Cy_CapSense_InitializeAllBaselines(cy_stc_capsense_context_t *context)
+{
+    cy_stc_capsense_sensor_context_t *sns;
+    uint32_t i;
+
+    for (i = 0u; i < CY_CAPSENSE_WIDGET_COUNT; i++)
+    {
+        sns = context->ptrWdConfig[i].ptrSnsContext;
+        sim_latch_raw(i);
+        sns->raw = sim_scan_raw[i];
+        sns->bsln = sim_scan_raw[i];
+        sns->bslnExt = 0u;
+        sns->negBslnRstCnt = 0u;
+        *context->ptrWdConfig[i].ptrDebounceArr = 0u;
+    }
+
+    return (CY_CAPSENSE_STATUS_SUCCESS);
+}
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_MeasureCapacitanceSensor
+********************************************************************************
+* Summary:
+*  BIST measurement of the sensor Cp. main.c measures both buttons in one
+*  round, the round is counted at Button 1, and in virtual time charged there
+*  as bist_cycles.
+*
+* Parameters:
+*  widgetId - widget index
+*  sensorId - sensor index in the widget
+*  ptrValue - receives the Cp in fF
+*  context - CapSense context
+*
+* Return:
+*  cy_en_capsense_bist_status_t - CY_CAPSENSE_BIST_SUCCESS_E, or
+*  CY_CAPSENSE_BIST_HW_BUSY_E while a scan is in flight
+*
+*******************************************************************************/
+cy_en_capsense_bist_status_t Cy_CapSense_MeasureCapacitanceSensor(uint32_t widgetId, uint32_t sensorId,
+                                                                  uint32_t *ptrValue,
+                                                                  cy_stc_capsense_context_t *context)
+{
+    (void)sensorId;
+    (void)context;
+
+    if (sim_scan_busy)
+    {
+        sim_violation(CHECK_BIST_BUSY);
+        return (CY_CAPSENSE_BIST_HW_BUSY_E);
+    }
+
+    *ptrValue = SIM_CP_FF;
+    if (CY_CAPSENSE_BUTTON1_WDGT_ID == widgetId)
+    {
+        sim_bist_count++;
+#if SIM_VIRTUAL_TIME
+        sim_run(SIM_REGION_BIST, sim_params.bist_cycles);
+#endif
+    }
+
+    return (CY_CAPSENSE_BIST_SUCCESS_E);
+}
+
+cy_en_syspm_status_t Cy_CapSense_DeepSleepCallback(cy_stc_syspm_callback_params_t *params,
+                                                   cy_en_syspm_callback_mode_t mode)
+{
+    (void)params;
+    (void)mode;
+
+    return (CY_SYSPM_SUCCESS);
+}
+
+/* [] END OF FILE */
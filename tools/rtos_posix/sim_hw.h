@@ -0,0 +1,219 @@
+/******************************************************************************
+* File Name: sim_hw.h
+*
+* Description: Interface of the simulated hardware of the host build: the model
+*              parameters and statistics of the virtual time build, the virtual time
+*              engine of sim_time.c, and the hooks of the host programs that run the
+*              application on it.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef SIM_HW_H
+#define SIM_HW_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_pdl.h"
+#include "cycfg_capsense.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* With SIM_VIRTUAL_TIME the bare-metal loop runs in virtual time: the stubs
+ * charge CPU cycles, and sim_time.c delivers SysTick, CSD and EZI2C events and
+ * their interrupts in NVIC priority order. Otherwise the host clock is used.
+ */
+#ifndef SIM_VIRTUAL_TIME
+#define SIM_VIRTUAL_TIME         (0u)
+#endif
+
+#define SIM_NEVER                (UINT64_MAX)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Interrupts of the model, in NVIC priority order with the main thread last */
+typedef enum
+{
+    SIM_LEVEL_SYSTICK = 0u,
+    SIM_LEVEL_EZI2C,
+    SIM_LEVEL_CSD,
+    SIM_LEVEL_MAIN,
+    SIM_LEVEL_COUNT
+} sim_level_t;
+
+/* Main thread code regions, charged by the stubs */
+typedef enum
+{
+    SIM_REGION_SCAN_SETUP = 0u,
+    SIM_REGION_WAIT,
+    SIM_REGION_PROCESS,
+    SIM_REGION_TUNER,
+    SIM_REGION_BIST,
+    SIM_REGION_FLASH
+} sim_region_t;
+
+/* I2C masters: the application host on the secondary EZI2C address, or on
+ * the primary one without HOST_REGS_SECOND_ADDR_EN, and the CAPSENSE Tuner
+ * on the primary one
+ */
+typedef enum
+{
+    SIM_MASTER_HOST = 0u,
+    SIM_MASTER_TUNER,
+    SIM_MASTER_COUNT
+} sim_master_t;
+
+/* Model parameters, CPU times in cycles. The scan resolution and the
+ * processing thresholds apply to both builds, the rest to the virtual time
+ * build.
+ */
+typedef struct
+{
+    double duration_s;
+    uint32_t resolution;
+    uint32_t finger_th;
+    uint32_t hysteresis;
+    uint32_t noise_th;
+    uint32_t nnoise_th;
+    uint32_t low_bsln_rst;
+    uint32_t on_debounce;
+    uint32_t bsln_coeff;
+    uint32_t mod_div;
+    uint32_t init_mod_cycles;
+    uint32_t entry_cycles;
+    uint32_t systick_cycles;
+    uint32_t csd_isr_cycles;
+    uint32_t ezi2c_isr_cycles[SIM_MASTER_COUNT];
+    uint32_t scan_setup_cycles;
+    uint32_t process_cycles;
+    uint32_t tuner_cycles;
+    uint32_t bist_cycles;
+    uint32_t flash_cycles;
+    uint32_t i2c_hz;
+    uint32_t poll_us[SIM_MASTER_COUNT];
+    uint32_t read_bytes[SIM_MASTER_COUNT];
+    double vcd_ms;
+    const char *vcd_path;
+} sim_params_t;
+
+/* Statistics of one interrupt level or of the main thread */
+typedef struct
+{
+    uint64_t count;
+    uint64_t busy;
+    uint64_t latency_sum;
+    uint64_t latency_max;
+} sim_level_stats_t;
+
+/* I2C statistics per master, times in cycles */
+typedef struct
+{
+    uint64_t transactions;
+    uint64_t bytes;
+    uint64_t isr_busy;
+    uint64_t stretch_sum;
+    uint64_t stretch_max;
+    uint64_t wait_sum;
+    uint64_t wait_max;
+} sim_i2c_stats_t;
+
+/* Frame statistics of the scan loop, times in nanoseconds */
+typedef struct
+{
+    uint32_t frames;
+    uint32_t scans;
+    uint64_t period_sum;
+    uint64_t period_min;
+    uint64_t period_max;
+    uint64_t scan_sum;
+    uint64_t scan_max;
+    uint64_t latency_sum;
+    uint64_t latency_max;
+} sim_frame_stats_t;
+
+/* Raw count of a sensor at the end of its conversion */
+typedef uint16_t (*sim_raw_source_t)(uint32_t sns_index, uint64_t now_ns);
+
+/* Called by sim_report() before the summary ends the program, returns the
+ * number of failed checks of the host program
+ */
+typedef uint32_t (*sim_report_hook_t)(void);
+
+/* Called by Cy_CapSense_ProcessAllWidgets() after every processed frame */
+typedef void (*sim_frame_hook_t)(const cy_stc_capsense_context_t *context);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern sim_params_t sim_params;
+extern sim_frame_stats_t sim_frame_stats;
+extern sim_level_stats_t sim_level_stats[SIM_LEVEL_COUNT];
+extern sim_i2c_stats_t sim_i2c_stats[SIM_MASTER_COUNT];
+extern sim_raw_source_t sim_raw_source;
+extern sim_report_hook_t sim_report_hook;
+extern sim_frame_hook_t sim_frame_hook;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+uint64_t sim_now_ns(void);
+void sim_report(void);
+
+#if SIM_VIRTUAL_TIME
+/* Virtual time engine, sim_time.c */
+void sim_time_init(void);
+uint64_t sim_time_cycles(void);
+void sim_time_end(uint64_t cycles);
+void sim_run(sim_region_t region, uint64_t cycles);
+void sim_spin(void);
+void sim_wait(void);
+uint32_t sim_primask_set(void);
+void sim_primask_restore(uint32_t saved);
+void sim_irq_vector(IRQn_Type irq, cy_israddress isr);
+void sim_irq_priority(IRQn_Type irq, uint32_t priority);
+bool sim_irq_pending(IRQn_Type irq);
+void sim_systick_sync(SysTick_Type *regs);
+void sim_csd_convert(uint64_t cycles);
+int32_t sim_i2c_isr(void);
+#endif /* SIM_VIRTUAL_TIME */
+
+#endif /* SIM_HW_H */
+
+/* [] END OF FILE */
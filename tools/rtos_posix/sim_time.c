@@ -0,0 +1,1035 @@
+/******************************************************************************
+* File Name: sim_time.c
+*
+* Description: Virtual time engine of the host build: advances a CPU cycle clock by
+*              the cycles charged by the stubs, raises SysTick, CSD conversion and I2C
+*              byte events, and runs the interrupt vectors of the application in NVIC
+*              priority order, with preemption and critical sections.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "sim_hw.h"
+
+#if SIM_VIRTUAL_TIME
+
+#if RTOS_EN
+#error "The virtual time build runs the bare-metal loop only"
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Execution priority of the main thread, below every interrupt */
+#define SIM_PRIORITY_THREAD      (256u)
+
+/* Bytes of a read besides the data: address and offset write, then address */
+#define SIM_I2C_HEADER_BYTES     (3u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+sim_level_stats_t sim_level_stats[SIM_LEVEL_COUNT];
+sim_i2c_stats_t sim_i2c_stats[SIM_MASTER_COUNT];
+
+/* Virtual time in CPU cycles and the end of the simulation */
+static uint64_t sim_cycles;
+static uint64_t sim_end = SIM_NEVER;
+
+/* Execution state: PRIMASK, the running level and its priority */
+static uint32_t sim_primask;
+static uint32_t sim_priority_now = SIM_PRIORITY_THREAD;
+static sim_level_t sim_level_now = SIM_LEVEL_MAIN;
+static sim_region_t sim_region_now = SIM_REGION_WAIT;
+
+/* NVIC state of the interrupts */
+static cy_israddress sim_vector[SIM_LEVEL_MAIN];
+static uint32_t sim_priority[SIM_LEVEL_MAIN];
+static bool sim_pending[SIM_LEVEL_MAIN];
+static uint64_t sim_pend_time[SIM_LEVEL_MAIN];
+
+/* SysTick: registers of sim_hw.c, the values seen at the last access, the
+ * reload value in use and the time of the last reload
+ */
+static SysTick_Type *sim_st_regs;
+static uint32_t sim_st_ctrl;
+static uint32_t sim_st_val;
+static uint32_t sim_st_load;
+static uint64_t sim_st_epoch;
+static uint64_t sim_st_next = SIM_NEVER;
+
+/* End of the CSD conversion in flight */
+static uint64_t sim_csd_end = SIM_NEVER;
+
+/* I2C bus: the master that owns it, the byte in flight and the bytes left,
+ * and the byte whose interrupt stretches the clock
+ */
+static uint64_t sim_byte_cycles;
+static uint64_t sim_byte_end = SIM_NEVER;
+static uint64_t sim_byte_done;
+static uint32_t sim_bytes_left;
+static bool sim_byte_wait_isr;
+static sim_master_t sim_bus_master = SIM_MASTER_HOST;
+static uint64_t sim_poll_cycles[SIM_MASTER_COUNT];
+static uint64_t sim_next_poll[SIM_MASTER_COUNT];
+static uint64_t sim_request[SIM_MASTER_COUNT];
+static bool sim_waiting[SIM_MASTER_COUNT];
+
+/* VCD output of the first vcd_ms milliseconds */
+static FILE *sim_vcd;
+static uint64_t sim_vcd_end;
+static uint64_t sim_vcd_time = SIM_NEVER;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void sim_advance(uint64_t cycles, bool busy);
+static void sim_dispatch(void);
+
+/*******************************************************************************
+* Function Name: sim_vcd_set
+********************************************************************************
+* Summary:
+*  Writes a signal change to the VCD file while inside the recorded window.
+*
+* Parameters:
+*  id - VCD identifier of the signal
+*  value - new value, multi-bit signals are written in binary
+*  width - signal width in bits
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_vcd_set(char id, uint32_t value, uint32_t width)
+{
+    uint32_t bit;
+
+    if ((NULL == sim_vcd) || (sim_cycles > sim_vcd_end))
+    {
+        return;
+    }
+    if (sim_cycles != sim_vcd_time)
+    {
+        fprintf(sim_vcd, "#%llu\n", (unsigned long long)((sim_cycles * 1000u) / (SystemCoreClock / 1000000u)));
+        sim_vcd_time = sim_cycles;
+    }
+    if (1u == width)
+    {
+        fprintf(sim_vcd, "%u%c\n", value, id);
+    }
+    else
+    {
+        fputc('b', sim_vcd);
+        for (bit = width; bit > 0u; bit--)
+        {
+            fputc(((value >> (bit - 1u)) & 1u) ? '1' : '0', sim_vcd);
+        }
+        fprintf(sim_vcd, " %c\n", id);
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_vcd_open
+********************************************************************************
+* Summary:
+*  Creates the VCD file of sim_params.vcd_path and declares the signals.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_vcd_open(void)
+{
+    sim_vcd = fopen(sim_params.vcd_path, "w");
+    if (NULL == sim_vcd)
+    {
+        perror(sim_params.vcd_path);
+        exit(2);
+    }
+    sim_vcd_end = (uint64_t)(sim_params.vcd_ms * (SystemCoreClock / 1000.0));
+
+    fprintf(sim_vcd, "$timescale 1ns $end\n$scope module pmg1 $end\n");
+    fprintf(sim_vcd, "$var wire 1 s isr_systick $end\n");
+    fprintf(sim_vcd, "$var wire 1 e isr_ezi2c $end\n");
+    fprintf(sim_vcd, "$var wire 1 c isr_csd $end\n");
+    fprintf(sim_vcd, "$var wire 3 m main_region $end\n");
+    fprintf(sim_vcd, "$var wire 2 p cpu_level $end\n");
+    fprintf(sim_vcd, "$var wire 1 v csd_conversion $end\n");
+    fprintf(sim_vcd, "$var wire 1 b i2c_byte $end\n");
+    fprintf(sim_vcd, "$upscope $end\n$enddefinitions $end\n");
+
+    sim_vcd_set('m', sim_region_now, 3u);
+    sim_vcd_set('p', sim_level_now, 2u);
+}
+
+/*******************************************************************************
+* Function Name: sim_level_of
+********************************************************************************
+* Summary:
+*  Returns the model level of an interrupt.
+*
+* Parameters:
+*  irq - interrupt number
+*
+* Return:
+*  sim_level_t - level, SIM_LEVEL_MAIN for an interrupt outside the model
+*
+*******************************************************************************/
+static sim_level_t sim_level_of(IRQn_Type irq)
+{
+    sim_level_t level = SIM_LEVEL_MAIN;
+
+    if (SysTick_IRQn == irq)
+    {
+        level = SIM_LEVEL_SYSTICK;
+    }
+    else if (scb_0_interrupt_IRQn == irq)
+    {
+        level = SIM_LEVEL_EZI2C;
+    }
+    else if (csd_interrupt_IRQn == irq)
+    {
+        level = SIM_LEVEL_CSD;
+    }
+    else
+    {
+        /* Not modelled */
+    }
+
+    return (level);
+}
+
+/*******************************************************************************
+* Function Name: sim_pend
+********************************************************************************
+* Summary:
+*  Sets an interrupt pending. A request while the interrupt is already pending
+*  is merged, as in the NVIC.
+*
+* Parameters:
+*  level - interrupt level
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_pend(sim_level_t level)
+{
+    if (!sim_pending[level])
+    {
+        sim_pending[level] = true;
+        sim_pend_time[level] = sim_cycles;
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_systick_reload
+********************************************************************************
+* Summary:
+*  Reloads the SysTick counter from LOAD now and schedules the next wrap.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_systick_reload(void)
+{
+    sim_st_epoch = sim_cycles;
+    sim_st_load = sim_st_regs->LOAD;
+    sim_st_next = (0u != (sim_st_ctrl & SysTick_CTRL_ENABLE_Msk)) ?
+                  (sim_st_epoch + sim_st_load + 1u) : SIM_NEVER;
+}
+
+/*******************************************************************************
+* Function Name: sim_next_event
+********************************************************************************
+* Summary:
+*  Returns the time of the next hardware event or of the end of the
+*  simulation.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint64_t - time in CPU cycles
+*
+*******************************************************************************/
+static uint64_t sim_next_event(void)
+{
+    uint64_t next = sim_end;
+    uint32_t m;
+
+    if (sim_st_next < next)
+    {
+        next = sim_st_next;
+    }
+    if (sim_csd_end < next)
+    {
+        next = sim_csd_end;
+    }
+    if (sim_byte_end < next)
+    {
+        next = sim_byte_end;
+    }
+    for (m = 0u; m < SIM_MASTER_COUNT; m++)
+    {
+        if (sim_next_poll[m] < next)
+        {
+            next = sim_next_poll[m];
+        }
+    }
+
+    return (next);
+}
+
+/*******************************************************************************
+* Function Name: sim_i2c_start
+********************************************************************************
+* Summary:
+*  Gives the bus to a master and starts the first byte of its read.
+*
+* Parameters:
+*  m - master
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_i2c_start(sim_master_t m)
+{
+    sim_bus_master = m;
+    sim_bytes_left = SIM_I2C_HEADER_BYTES + sim_params.read_bytes[m];
+    sim_byte_end = sim_cycles + sim_byte_cycles;
+    sim_i2c_stats[m].transactions++;
+    sim_vcd_set('b', 1u, 1u);
+}
+
+/*******************************************************************************
+* Function Name: sim_fire_events
+********************************************************************************
+* Summary:
+*  Handles the hardware events due now: SysTick wraps, the end of a CSD
+*  conversion, the end of an I2C byte and the reads of the masters. A master
+*  that finds the bus busy waits for the stop of the other transaction; a
+*  poll that falls while the previous read of the same master still runs is
+*  skipped. Ends the simulation at its end time.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_fire_events(void)
+{
+    uint32_t m;
+
+    if (sim_cycles >= sim_end)
+    {
+        sim_report();
+    }
+
+    if (sim_cycles == sim_st_next)
+    {
+        /* LOAD written since the last reload takes effect now */
+        sim_systick_reload();
+        sim_st_regs->VAL = sim_st_load;
+        sim_st_val = sim_st_load;
+        if (0u != (sim_st_ctrl & SysTick_CTRL_TICKINT_Msk))
+        {
+            sim_pend(SIM_LEVEL_SYSTICK);
+        }
+    }
+
+    if (sim_cycles == sim_csd_end)
+    {
+        sim_csd_end = SIM_NEVER;
+        sim_vcd_set('v', 0u, 1u);
+        sim_pend(SIM_LEVEL_CSD);
+    }
+
+    if (sim_cycles == sim_byte_end)
+    {
+        sim_byte_end = SIM_NEVER;
+        sim_byte_done = sim_cycles;
+        sim_bytes_left--;
+        sim_byte_wait_isr = true;
+        sim_i2c_stats[sim_bus_master].bytes++;
+        sim_vcd_set('b', 0u, 1u);
+        sim_pend(SIM_LEVEL_EZI2C);
+    }
+
+    for (m = 0u; m < SIM_MASTER_COUNT; m++)
+    {
+        if (sim_cycles != sim_next_poll[m])
+        {
+            continue;
+        }
+
+        sim_next_poll[m] += sim_poll_cycles[m];
+        if ((0u == sim_bytes_left) && !sim_byte_wait_isr)
+        {
+            sim_i2c_start((sim_master_t)m);
+        }
+        else if ((sim_bus_master != m) && !sim_waiting[m])
+        {
+            /* Arbitration: the master waits for the stop */
+            sim_waiting[m] = true;
+            sim_request[m] = sim_cycles;
+        }
+        else
+        {
+            /* The previous read of this master is still running */
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_i2c_release
+********************************************************************************
+* Summary:
+*  Ends the clock stretch of the byte whose EZI2C interrupt has returned, and
+*  starts the next byte, or at the stop gives the bus to a waiting master.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_i2c_release(void)
+{
+    sim_i2c_stats_t *stats = &sim_i2c_stats[sim_bus_master];
+    uint64_t stretch = sim_cycles - sim_byte_done;
+    uint64_t wait;
+    uint32_t m;
+
+    if (!sim_byte_wait_isr)
+    {
+        return;
+    }
+    sim_byte_wait_isr = false;
+
+    stats->stretch_sum += stretch;
+    if (stretch > stats->stretch_max)
+    {
+        stats->stretch_max = stretch;
+    }
+
+    if (0u != sim_bytes_left)
+    {
+        sim_byte_end = sim_cycles + sim_byte_cycles;
+        sim_vcd_set('b', 1u, 1u);
+        return;
+    }
+
+    for (m = 0u; m < SIM_MASTER_COUNT; m++)
+    {
+        if (sim_waiting[m])
+        {
+            sim_waiting[m] = false;
+            wait = sim_cycles - sim_request[m];
+            sim_i2c_stats[m].wait_sum += wait;
+            if (wait > sim_i2c_stats[m].wait_max)
+            {
+                sim_i2c_stats[m].wait_max = wait;
+            }
+            sim_i2c_start((sim_master_t)m);
+            break;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_take
+********************************************************************************
+* Summary:
+*  Runs the vector of a pending interrupt at its priority: the exception
+*  entry, the SysTick handler cost, then the application handler, whose stubs
+*  charge their own cycles. A byte interrupt releases the I2C clock when the
+*  handler returns.
+*
+* Parameters:
+*  level - interrupt level
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_take(sim_level_t level)
+{
+    sim_level_stats_t *stats = &sim_level_stats[level];
+    uint32_t priority = sim_priority_now;
+    sim_level_t prev = sim_level_now;
+    uint64_t latency = sim_cycles - sim_pend_time[level];
+    char id = (SIM_LEVEL_SYSTICK == level) ? 's' : (SIM_LEVEL_EZI2C == level) ? 'e' : 'c';
+
+    sim_pending[level] = false;
+    stats->count++;
+    stats->latency_sum += latency;
+    if (latency > stats->latency_max)
+    {
+        stats->latency_max = latency;
+    }
+
+    sim_priority_now = sim_priority[level];
+    sim_level_now = level;
+    sim_vcd_set(id, 1u, 1u);
+    sim_vcd_set('p', level, 2u);
+
+    sim_advance((uint64_t)sim_params.entry_cycles +
+                ((SIM_LEVEL_SYSTICK == level) ? sim_params.systick_cycles : 0u), true);
+    if (NULL != sim_vector[level])
+    {
+        sim_vector[level]();
+    }
+    if (SIM_LEVEL_EZI2C == level)
+    {
+        sim_i2c_release();
+    }
+
+    sim_vcd_set(id, 0u, 1u);
+    sim_vcd_set('p', prev, 2u);
+    sim_priority_now = priority;
+    sim_level_now = prev;
+}
+
+/*******************************************************************************
+* Function Name: sim_dispatch
+********************************************************************************
+* Summary:
+*  Runs the pending interrupts with a higher priority than the running code,
+*  highest first, unless PRIMASK is set. On equal priority the lower exception
+*  number wins, as in the NVIC.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_dispatch(void)
+{
+    uint32_t level;
+    uint32_t best;
+
+    while (0u == sim_primask)
+    {
+        best = SIM_LEVEL_MAIN;
+        for (level = 0u; level < SIM_LEVEL_MAIN; level++)
+        {
+            if (sim_pending[level] && (sim_priority[level] < sim_priority_now) &&
+                ((SIM_LEVEL_MAIN == best) || (sim_priority[level] < sim_priority[best])))
+            {
+                best = level;
+            }
+        }
+        if (SIM_LEVEL_MAIN == best)
+        {
+            break;
+        }
+        sim_take((sim_level_t)best);
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_step
+********************************************************************************
+* Summary:
+*  Advances the time to the next event or by the given cycles, whichever
+*  comes first, and handles the events due then.
+*
+* Parameters:
+*  cycles - longest step
+*  busy - the running level executes during the step
+*
+* Return:
+*  uint64_t - cycles advanced
+*
+*******************************************************************************/
+static uint64_t sim_step(uint64_t cycles, bool busy)
+{
+    uint64_t next = sim_next_event();
+    uint64_t step = cycles;
+
+    if (SIM_NEVER == next)
+    {
+        printf("deadlock: no event left at %.6f s\n", (double)sim_cycles / SystemCoreClock);
+        fflush(stdout);
+        exit(2);
+    }
+    if ((next - sim_cycles) < step)
+    {
+        step = next - sim_cycles;
+    }
+
+    sim_cycles += step;
+    if (busy)
+    {
+        sim_level_stats[sim_level_now].busy += step;
+    }
+    if (sim_cycles == next)
+    {
+        sim_fire_events();
+    }
+
+    return (step);
+}
+
+/*******************************************************************************
+* Function Name: sim_advance
+********************************************************************************
+* Summary:
+*  Executes the given CPU cycles at the running level. Interrupts that become
+*  pending meanwhile preempt it, so it ends later by their run time.
+*
+* Parameters:
+*  cycles - CPU cycles
+*  busy - count the cycles as load of the running level
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sim_advance(uint64_t cycles, bool busy)
+{
+    uint64_t remaining = cycles;
+
+    if (NULL != sim_st_regs)
+    {
+        sim_systick_sync(sim_st_regs);
+    }
+
+    while (0u != remaining)
+    {
+        remaining -= sim_step(remaining, busy);
+        sim_dispatch();
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_time_init
+********************************************************************************
+* Summary:
+*  Starts the virtual time at 0 with the model parameters of sim_params:
+*  I2C byte time and master periods, and the VCD file if requested. The
+*  Tuner starts half a period after the host.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_time_init(void)
+{
+    uint32_t m;
+
+    sim_cycles = 0u;
+    sim_byte_cycles = ((uint64_t)SystemCoreClock * 9u) / sim_params.i2c_hz;
+
+    for (m = 0u; m < SIM_MASTER_COUNT; m++)
+    {
+        sim_poll_cycles[m] = ((uint64_t)sim_params.poll_us[m] * SystemCoreClock) / 1000000u;
+        sim_next_poll[m] = SIM_NEVER;
+        if (0u != sim_poll_cycles[m])
+        {
+            sim_next_poll[m] = (SIM_MASTER_HOST == m) ? sim_poll_cycles[m] : ((sim_poll_cycles[m] * 3u) / 2u);
+        }
+    }
+
+    for (m = 0u; m < SIM_LEVEL_MAIN; m++)
+    {
+        sim_priority[m] = 0u;
+    }
+
+    if (NULL != sim_params.vcd_path)
+    {
+        sim_vcd_open();
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_time_cycles
+********************************************************************************
+* Summary:
+*  Returns the virtual time.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint64_t - time in CPU cycles
+*
+*******************************************************************************/
+uint64_t sim_time_cycles(void)
+{
+    return (sim_cycles);
+}
+
+/*******************************************************************************
+* Function Name: sim_time_end
+********************************************************************************
+* Summary:
+*  Sets the end of the simulation, sim_report() is called when it is reached.
+*
+* Parameters:
+*  cycles - end time in CPU cycles
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_time_end(uint64_t cycles)
+{
+    sim_end = cycles;
+}
+
+/*******************************************************************************
+* Function Name: sim_run
+********************************************************************************
+* Summary:
+*  Charges CPU cycles to the running code. In the main thread the cycles are
+*  shown as the given region in the VCD file.
+*
+* Parameters:
+*  region - main thread region
+*  cycles - CPU cycles
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_run(sim_region_t region, uint64_t cycles)
+{
+    sim_region_t prev = sim_region_now;
+    bool main_thread = (SIM_LEVEL_MAIN == sim_level_now);
+
+    if (main_thread)
+    {
+        sim_region_now = region;
+        sim_vcd_set('m', region, 3u);
+    }
+
+    sim_advance(cycles, true);
+
+    if (main_thread)
+    {
+        sim_region_now = prev;
+        sim_vcd_set('m', prev, 3u);
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_spin
+********************************************************************************
+* Summary:
+*  Busy wait of the main thread polling a status, such as the free-running
+*  loop polling Cy_CapSense_IsBusy(): runs to the next event and its
+*  interrupts. Returns at once with PRIMASK set, the caller then sleeps, and
+*  in an interrupt handler, which only reads the status.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_spin(void)
+{
+    if ((0u != sim_primask) || (SIM_LEVEL_MAIN != sim_level_now))
+    {
+        return;
+    }
+
+    if (NULL != sim_st_regs)
+    {
+        sim_systick_sync(sim_st_regs);
+    }
+    (void)sim_step(SIM_NEVER, true);
+    sim_dispatch();
+}
+
+/*******************************************************************************
+* Function Name: sim_wait
+********************************************************************************
+* Summary:
+*  WFI: idles until an interrupt is pending, which wakes the CPU even with
+*  PRIMASK set, and runs it unless PRIMASK is set.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_wait(void)
+{
+    uint32_t level;
+    bool pending = false;
+
+    if (NULL != sim_st_regs)
+    {
+        sim_systick_sync(sim_st_regs);
+    }
+
+    while (!pending)
+    {
+        for (level = 0u; level < SIM_LEVEL_MAIN; level++)
+        {
+            pending = pending || sim_pending[level];
+        }
+        if (!pending)
+        {
+            (void)sim_step(SIM_NEVER, false);
+        }
+    }
+
+    sim_dispatch();
+}
+
+/*******************************************************************************
+* Function Name: sim_primask_set
+********************************************************************************
+* Summary:
+*  Masks all interrupts, as Cy_SysLib_EnterCriticalSection().
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - previous PRIMASK
+*
+*******************************************************************************/
+uint32_t sim_primask_set(void)
+{
+    uint32_t saved = sim_primask;
+
+    sim_primask = 1u;
+
+    return (saved);
+}
+
+/*******************************************************************************
+* Function Name: sim_primask_restore
+********************************************************************************
+* Summary:
+*  Restores PRIMASK and runs the interrupts that became pending meanwhile.
+*
+* Parameters:
+*  saved - PRIMASK returned by sim_primask_set()
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_primask_restore(uint32_t saved)
+{
+    sim_primask = saved;
+    sim_dispatch();
+}
+
+/*******************************************************************************
+* Function Name: sim_irq_vector
+********************************************************************************
+* Summary:
+*  Installs the application handler of an interrupt.
+*
+* Parameters:
+*  irq - interrupt number
+*  isr - handler
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_irq_vector(IRQn_Type irq, cy_israddress isr)
+{
+    sim_level_t level = sim_level_of(irq);
+
+    if (SIM_LEVEL_MAIN != level)
+    {
+        sim_vector[level] = isr;
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_irq_priority
+********************************************************************************
+* Summary:
+*  Sets the NVIC priority of an interrupt, 0 is the highest.
+*
+* Parameters:
+*  irq - interrupt number
+*  priority - priority
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_irq_priority(IRQn_Type irq, uint32_t priority)
+{
+    sim_level_t level = sim_level_of(irq);
+
+    if (SIM_LEVEL_MAIN != level)
+    {
+        sim_priority[level] = priority;
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_irq_pending
+********************************************************************************
+* Summary:
+*  Returns the pending state of an interrupt.
+*
+* Parameters:
+*  irq - interrupt number
+*
+* Return:
+*  bool - true while pending
+*
+*******************************************************************************/
+bool sim_irq_pending(IRQn_Type irq)
+{
+    sim_level_t level = sim_level_of(irq);
+
+    return ((SIM_LEVEL_MAIN != level) && sim_pending[level]);
+}
+
+/*******************************************************************************
+* Function Name: sim_systick_sync
+********************************************************************************
+* Summary:
+*  Brings the SysTick registers to the current time. A write to VAL or
+*  enabling the counter since the last access reloads the counter from LOAD;
+*  a write to LOAD alone takes effect at the next wrap. No time passes between
+*  a register write of the application and the next access or engine call,
+*  so the reload time is exact.
+*
+* Parameters:
+*  regs - SysTick registers
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_systick_sync(SysTick_Type *regs)
+{
+    bool enabled = (0u != (regs->CTRL & SysTick_CTRL_ENABLE_Msk));
+    bool was_enabled = (0u != (sim_st_ctrl & SysTick_CTRL_ENABLE_Msk));
+
+    sim_st_regs = regs;
+
+    if ((regs->VAL != sim_st_val) || (enabled != was_enabled))
+    {
+        sim_st_ctrl = regs->CTRL;
+        sim_systick_reload();
+    }
+    sim_st_ctrl = regs->CTRL;
+
+    if (enabled)
+    {
+        regs->VAL = sim_st_load - (uint32_t)((sim_cycles - sim_st_epoch) % ((uint64_t)sim_st_load + 1u));
+    }
+    sim_st_val = regs->VAL;
+}
+
+/*******************************************************************************
+* Function Name: sim_csd_convert
+********************************************************************************
+* Summary:
+*  Starts a CSD conversion, the CSD interrupt becomes pending at its end.
+*
+* Parameters:
+*  cycles - conversion time in CPU cycles
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void sim_csd_convert(uint64_t cycles)
+{
+    sim_csd_end = sim_cycles + cycles;
+    sim_vcd_set('v', 1u, 1u);
+}
+
+/*******************************************************************************
+* Function Name: sim_i2c_isr
+********************************************************************************
+* Summary:
+*  Charges the EZI2C interrupt cost of the master that owns the bus. Called by
+*  Cy_SCB_EZI2C_Interrupt(). The ISR load of the master includes the
+*  exception entry, which sim_take() has charged already.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int32_t - master whose read ends with this byte, -1 otherwise
+*
+*******************************************************************************/
+int32_t sim_i2c_isr(void)
+{
+    sim_master_t m = sim_bus_master;
+    uint32_t cycles = sim_params.ezi2c_isr_cycles[m];
+
+    sim_i2c_stats[m].isr_busy += (uint64_t)sim_params.entry_cycles + cycles;
+    sim_advance(cycles, true);
+
+    return ((sim_byte_wait_isr && (0u == sim_bytes_left)) ? (int32_t)m : -1);
+}
+
+#endif /* SIM_VIRTUAL_TIME */
+
+/* [] END OF FILE */
@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+"""Models neighboring boards that couple into each other while scanning.
+
+Every board scans once per schedule period. A scan picks up coupled noise
+from every neighbor whose scan overlaps it, scaled by the overlap and by the
+distance between the boards. The board logic follows scan_slot.c: a sync
+point moves the schedule, the measured period corrects the board clock
+error, and scans start at the next start of the board's slot.
+
+Modes:
+    free      every board scans on its own clock, no schedule
+    nocorr    host sync every --host-sync periods, period not corrected
+    host      host sync every --host-sync periods with period correction,
+              the host sends the period number with the sync
+    gpio      sync edge on a shared line at every period
+"""
+
+import argparse
+import bisect
+import math
+import random
+
+MODES = ("free", "nocorr", "host", "gpio")
+
+
+class Board:
+    def __init__(self, rng, index, args, mode):
+        self.rng = rng
+        self.index = index
+        self.args = args
+        self.mode = mode
+        self.rate = 1.0 + rng.uniform(-args.drift_ppm, args.drift_ppm) * 1e-6
+        self.offset = rng.uniform(0.0, 1.0)
+        self.period = args.period
+        self.epoch = self.local(0.0) + rng.uniform(0.0, args.period)
+        self.synced = False
+        self.slot = index % args.slots
+
+    def local(self, t):
+        return self.rate * t + self.offset
+
+    def true(self, local):
+        return (local - self.offset) / self.rate
+
+    def sync(self, local_epoch, index, correct):
+        if self.synced:
+            elapsed = local_epoch - self.epoch
+            if index is None:
+                # Sync edge: the number of periods is inferred from the time
+                periods = int(elapsed / self.period + 0.5)
+                if periods > 8:
+                    periods = 0
+            else:
+                periods = index - self.period_index
+            if correct and periods > 0:
+                measured = elapsed / periods
+                if abs(measured - self.args.period) < self.args.period / 16.0:
+                    self.period += (measured - self.period) / 4.0
+        self.epoch = local_epoch
+        self.period_index = index
+        self.synced = True
+
+    def next_start(self, now):
+        if self.mode == "free":
+            return now + self.period - ((now - self.epoch) % self.period)
+        slot_start = self.epoch + self.period * self.slot / self.args.slots
+        since = now - slot_start
+        if since < 0:
+            return now + ((-since) % self.period)
+        return now + self.period - (since % self.period)
+
+    def run(self, sync_times):
+        """Returns the scan intervals in true time."""
+        scans = []
+        k = 0
+        now = self.local(0.0)
+        while True:
+            # Apply the syncs that happened before the board looks at the schedule
+            while k < len(sync_times) and sync_times[k][0] <= self.true(now):
+                t, index, err = sync_times[k]
+                self.sync(self.local(t) + err, index, self.mode != "nocorr")
+                k += 1
+            start = self.next_start(now)
+            t0 = self.true(start)
+            if t0 > self.args.duration:
+                return scans
+            scans.append((t0, t0 + self.args.scan / self.rate))
+            now = start + self.args.scan + self.args.process
+
+
+def sync_schedule(rng, args, mode):
+    if mode == "gpio":
+        step, jitter = 1, args.gpio_jitter
+    elif mode in ("host", "nocorr"):
+        step, jitter = args.host_sync, args.host_jitter
+    else:
+        return []
+    # The host sends the period number with the sync command
+    times = []
+    index = 0
+    while index * args.period < args.duration:
+        times.append((index * args.period, None if mode == "gpio" else index,
+                      rng.gauss(0.0, jitter)))
+        index += step
+    return times
+
+
+def overlap(scans, start, end):
+    """Overlapping time of [start, end) with the sorted scans of one board.
+    The scans of a board do not overlap, so only the one before start can
+    reach into the interval."""
+    i = max(0, bisect.bisect_left(scans, (start, 0.0)) - 1)
+    total = 0.0
+    while i < len(scans) and scans[i][0] < end:
+        total += max(0.0, min(end, scans[i][1]) - max(start, scans[i][0]))
+        i += 1
+    return total
+
+
+def simulate(args, mode):
+    rng = random.Random(args.seed)
+    boards = [Board(rng, i, args, mode) for i in range(args.boards)]
+    all_scans = []
+    for board in boards:
+        # Each board sees the shared sync edge or its own host sync command
+        all_scans.append(board.run(sync_schedule(rng, args, mode)))
+
+    noise = []
+    hit = 0
+    total = 0
+    for i, scans in enumerate(all_scans):
+        for start, end in scans:
+            coupled = 0.0
+            for j, other in enumerate(all_scans):
+                if i != j:
+                    share = overlap(other, start, end) / (end - start)
+                    coupled += share * args.coupling / (abs(i - j) ** 2)
+            if coupled > 0.0:
+                hit += 1
+            total += 1
+            noise.append(rng.gauss(0.0, args.noise) + coupled * rng.choice((-1.0, 1.0)))
+
+    rms = math.sqrt(sum(n * n for n in noise) / len(noise))
+    return hit / float(total), rms
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--boards", type=int, default=4)
+    parser.add_argument("--slots", type=int, default=4)
+    parser.add_argument("--duration", type=float, default=60.0, help="seconds")
+    parser.add_argument("--period", type=float, default=0.01, help="schedule period, seconds")
+    parser.add_argument("--scan", type=float, default=1.5e-3, help="scan time per frame, seconds")
+    parser.add_argument("--process", type=float, default=0.5e-3, help="processing time, seconds")
+    parser.add_argument("--drift-ppm", type=float, default=20000.0, help="max board clock error")
+    parser.add_argument("--host-sync", type=int, default=50, help="periods between host syncs")
+    parser.add_argument("--host-jitter", type=float, default=150e-6, help="host sync error, seconds")
+    parser.add_argument("--gpio-jitter", type=float, default=2e-6, help="sync edge latency jitter, seconds")
+    parser.add_argument("--noise", type=float, default=1.0, help="own noise, counts rms")
+    parser.add_argument("--coupling", type=float, default=8.0, help="noise from an adjacent scan, counts")
+    parser.add_argument("--signal", type=float, default=50.0, help="touch signal, counts")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    if args.slots * (args.scan + args.process) > args.period:
+        print("warning: slots do not fit into the period")
+
+    print("mode    overlapped  noise rms  SNR")
+    for mode in MODES:
+        hit, rms = simulate(args, mode)
+        print("%-7s %9.1f%% %10.2f %6.1f" % (mode, hit * 100.0, rms, args.signal / rms))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,858 @@
+/******************************************************************************
+* File Name: soak_sim.c
+*
+* Description: Host soak test of the firmware in virtual time. Runs scenarios
+*              with drift, noise and touch patterns in parallel through the
+*              bare-metal loop of main.c, with the health checks of health.c and
+*              the CapSense processing model of rtos_posix/sim_hw.c, and checks
+*              the reported touches against the true finger state. Build with:
+*              make -C tools/rtos_posix soak_sim
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "cycfg_capsense.h"
+#include "host_regs.h"
+#include "sim_hw.h"
+
+#if !HEALTH_EN
+#error "The soak test reads the health block, build it with HEALTH_EN"
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define GAUSS_TABLE_SIZE     (4096u)
+#define DRIFT_UPDATE_US      (10000u)
+#define US_PER_HOUR          (3600.0e6)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Checks, in the order of the violation counters. The device checks are read
+ * from the health block of the register map, the host checks use the true
+ * finger state of the scenario.
+ */
+typedef enum
+{
+    CHECK_STUCK = 0u,     /* host: touch reported with no finger for longer than stuck_ms */
+    CHECK_LONG,           /* device: touch reported for longer than HEALTH_STUCK_TOUCH_MS */
+    CHECK_MISSED,         /* host: finger present for longer than missed_ms, no touch */
+    CHECK_BSLN_RANGE,     /* device: baseline outside the HEALTH_BSLN_* bounds */
+    CHECK_BSLN_TRACK,     /* host: baseline away from the untouched raw count */
+    CHECK_BUDGET,         /* device: frame time above HEALTH_FRAME_BUDGET_US */
+    CHECK_COUNT
+} check_t;
+
+/* Scenario generator settings, amplitudes in raw counts */
+typedef struct
+{
+    const char *name;
+    double noise;          /* raw count noise sigma */
+    double burst_rate_h;   /* noise bursts per hour */
+    double burst_noise;    /* noise sigma during a burst */
+    double burst_ms;       /* burst length */
+    double slow_amp;       /* daily temperature cycle */
+    double fast_amp;       /* short temperature cycle */
+    double fast_period_s;
+    double step_rate_h;    /* sudden raw count steps (water film, lid) per hour */
+    double step_amp;       /* step size, sign is random */
+    double touch_rate_h;   /* touches per sensor per hour */
+    double touch_mean_s;   /* mean touch duration */
+    double touch_max_s;
+    double stall_rate_h;   /* main-loop stalls per hour */
+    double stall_ms;
+} scenario_t;
+
+/* Soak parameters, the processing thresholds are in sim_params */
+typedef struct
+{
+    double hours;
+    double cal_percent;
+    double signal_min;
+    double signal_max;
+    double stuck_ms;
+    double missed_ms;
+    double bsln_track;
+    uint32_t seed;
+    const char *only;
+} soak_params_t;
+
+/* Scenario state of a sensor and its host checks */
+typedef struct
+{
+    double base;
+    double step;
+    double finger;
+    uint64_t touch_end;
+    uint64_t next_touch;
+    uint64_t finger_since;
+    uint64_t stuck_since;
+} sensor_t;
+
+/* Result of one scenario, passed from the worker process to the parent */
+typedef struct
+{
+    uint64_t frames;
+    double hours;
+    uint64_t touches;
+    uint64_t violations[CHECK_COUNT];
+    double first_violation_h;
+    double max_period_us;
+    double max_bsln_err;
+    double max_touch_s;
+} soak_result_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+int app_main(void);
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+static const scenario_t scenarios[] =
+{
+    /* name          noise burst       slow  fast           step       touch              stall */
+    { "quiet",        3.0,  0.0, 0.0, 0.0,   0.0,  0.0,   0.0, 0.0,  0.0, 30.0,  0.4, 5.0,   0.0,  0.0 },
+    { "thermal",      3.0,  0.0, 0.0, 0.0,  60.0, 20.0, 600.0, 0.0,  0.0, 30.0,  0.4, 5.0,   0.0,  0.0 },
+    { "noisy",       10.0, 60.0,30.0,50.0,  20.0,  0.0,   0.0, 0.0,  0.0, 30.0,  0.4, 5.0,   0.0,  0.0 },
+    { "long_press",   3.0,  0.0, 0.0, 0.0,  60.0, 20.0, 300.0, 0.0,  0.0, 20.0, 10.0,60.0,   0.0,  0.0 },
+    { "steps",        3.0,  0.0, 0.0, 0.0,  20.0,  0.0,   0.0, 2.0, 90.0, 30.0,  0.4, 5.0,   0.0,  0.0 },
+    { "stalls",       3.0,  0.0, 0.0, 0.0,   0.0,  0.0,   0.0, 0.0,  0.0, 30.0,  0.4, 5.0,  10.0, 25.0 },
+};
+
+#define SCENARIO_COUNT       (sizeof(scenarios) / sizeof(scenarios[0]))
+
+static soak_params_t prm =
+{
+    .hours = 24.0,
+    .cal_percent = 85.0,
+    .signal_min = 110.0,
+    .signal_max = 200.0,
+    .stuck_ms = 1000.0,
+    .missed_ms = 200.0,
+    .bsln_track = 40.0,
+    .seed = 1u,
+    .only = NULL,
+};
+
+static const char *check_names[CHECK_COUNT] =
+{
+    "stuck", "long", "missed", "bsln_range", "bsln_track", "budget"
+};
+
+static float gauss_table[GAUSS_TABLE_SIZE];
+static uint64_t rng_state;
+
+/* State of the scenario run by this worker process */
+static const scenario_t *soak_sc;
+static sensor_t soak_sensor[CY_CAPSENSE_SENSOR_COUNT];
+static soak_result_t soak_res;
+static bool soak_failed;
+static int soak_fd;
+static double soak_drift;
+static double soak_noise;
+static uint64_t soak_next_env;
+static uint64_t soak_next_burst;
+static uint64_t soak_burst_end;
+static uint64_t soak_next_stall;
+
+/*******************************************************************************
+* Function Name: rng_next
+********************************************************************************
+* Summary:
+*  xorshift64* generator.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint64_t - next random value
+*
+*******************************************************************************/
+static inline uint64_t rng_next(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1DuLL;
+}
+
+/*******************************************************************************
+* Function Name: rng_uniform
+********************************************************************************
+* Summary:
+*  Returns a uniform value in [0, 1).
+*
+* Parameters:
+*  void
+*
+* Return:
+*  double
+*
+*******************************************************************************/
+static inline double rng_uniform(void)
+{
+    return (double)(rng_next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/*******************************************************************************
+* Function Name: rng_gauss
+********************************************************************************
+* Summary:
+*  Returns a standard normal value from the precomputed table.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  double
+*
+*******************************************************************************/
+static inline double rng_gauss(void)
+{
+    return gauss_table[rng_next() >> 52];
+}
+
+/*******************************************************************************
+* Function Name: rng_exp_us
+********************************************************************************
+* Summary:
+*  Returns the time to the next event of a Poisson process.
+*
+* Parameters:
+*  rate_h - events per hour, 0 for never
+*
+* Return:
+*  uint64_t - interval in microseconds
+*
+*******************************************************************************/
+static uint64_t rng_exp_us(double rate_h)
+{
+    if (rate_h <= 0.0)
+    {
+        return UINT64_MAX / 2u;
+    }
+    return (uint64_t)(-log(1.0 - rng_uniform()) * US_PER_HOUR / rate_h);
+}
+
+/*******************************************************************************
+* Function Name: soak_first
+********************************************************************************
+* Summary:
+*  Records the virtual time of the first failed check.
+*
+* Parameters:
+*  now - virtual time in microseconds
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void soak_first(uint64_t now)
+{
+    if (!soak_failed)
+    {
+        soak_failed = true;
+        soak_res.first_violation_h = now / US_PER_HOUR;
+    }
+}
+
+/*******************************************************************************
+* Function Name: violation
+********************************************************************************
+* Summary:
+*  Counts a failed host check.
+*
+* Parameters:
+*  check - failed check
+*  now - virtual time in microseconds
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void violation(check_t check, uint64_t now)
+{
+    soak_first(now);
+    soak_res.violations[check]++;
+}
+
+/*******************************************************************************
+* Function Name: soak_env
+********************************************************************************
+* Summary:
+*  Updates the slow environment changes every DRIFT_UPDATE_US: the
+*  temperature cycles and the noise bursts.
+*
+* Parameters:
+*  now - virtual time in microseconds
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void soak_env(uint64_t now)
+{
+    double t_s = now * 1.0e-6;
+
+    if (now < soak_next_env)
+    {
+        return;
+    }
+    soak_next_env = now + DRIFT_UPDATE_US;
+
+    soak_drift = soak_sc->slow_amp * sin(t_s * (2.0 * M_PI / 86400.0));
+    if (soak_sc->fast_period_s > 0.0)
+    {
+        soak_drift += soak_sc->fast_amp * sin(t_s * (2.0 * M_PI / soak_sc->fast_period_s));
+    }
+
+    if (now >= soak_next_burst)
+    {
+        soak_burst_end = now + (uint64_t)(soak_sc->burst_ms * 1000.0);
+        soak_next_burst = now + rng_exp_us(soak_sc->burst_rate_h);
+    }
+    soak_noise = (now < soak_burst_end) ? soak_sc->burst_noise : soak_sc->noise;
+}
+
+/*******************************************************************************
+* Function Name: soak_raw
+********************************************************************************
+* Summary:
+*  Raw count source of the scenario, called at the end of every conversion:
+*  the sensor base level with drift, steps, the finger signal of the touch
+*  pattern and noise.
+*
+* Parameters:
+*  sns_index - sensor index
+*  now_ns - virtual time of the end of the conversion
+*
+* Return:
+*  uint16_t - raw count, limited to the maximum raw count by sim_hw.c
+*
+*******************************************************************************/
+static uint16_t soak_raw(uint32_t sns_index, uint64_t now_ns)
+{
+    const scenario_t *sc = soak_sc;
+    sensor_t *sns = &soak_sensor[sns_index];
+    uint64_t now = now_ns / 1000u;
+    double value;
+
+    soak_env(now);
+
+    if (now >= sns->next_touch)
+    {
+        double dur = -log(1.0 - rng_uniform()) * sc->touch_mean_s;
+
+        if (dur > sc->touch_max_s)
+        {
+            dur = sc->touch_max_s;
+        }
+        sns->finger = prm.signal_min + rng_uniform() * (prm.signal_max - prm.signal_min);
+        sns->touch_end = now + (uint64_t)(dur * 1.0e6);
+        sns->next_touch = sns->touch_end + rng_exp_us(sc->touch_rate_h);
+        sns->finger_since = now;
+        soak_res.touches++;
+
+        /* A step happens at most once per touch gap, as a lid or water film would */
+        if ((sc->step_rate_h > 0.0) && (rng_uniform() < (sc->step_rate_h / sc->touch_rate_h)))
+        {
+            sns->step += (rng_uniform() < 0.5) ? sc->step_amp : -sc->step_amp;
+            if (fabs(sns->step) > (2.0 * sc->step_amp))
+            {
+                sns->step = 0.0;
+            }
+        }
+    }
+    if ((0.0 != sns->finger) && (now >= sns->touch_end))
+    {
+        sns->finger = 0.0;
+    }
+
+    value = sns->base + soak_drift + sns->step + sns->finger + soak_noise * rng_gauss();
+    if (value < 0.0)
+    {
+        value = 0.0;
+    }
+
+    return ((value > UINT16_MAX) ? UINT16_MAX : (uint16_t)value);
+}
+
+/*******************************************************************************
+* Function Name: soak_frame
+********************************************************************************
+* Summary:
+*  Host checks of every processed frame against the true finger state, the
+*  time of the first device check failure, and the main-loop stalls of the
+*  scenario, which run at the end of the processing.
+*
+* Parameters:
+*  context - CapSense context
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void soak_frame(const cy_stc_capsense_context_t *context)
+{
+    const cy_stc_capsense_sensor_context_t *sns_ctx;
+    uint64_t now = sim_now_ns() / 1000u;
+    uint64_t stuck_us = (uint64_t)(prm.stuck_ms * 1000.0);
+    uint64_t missed_us = (uint64_t)(prm.missed_ms * 1000.0);
+    sensor_t *sns;
+    bool touched;
+    double err;
+    uint32_t i;
+
+    for (i = 0u; i < CY_CAPSENSE_SENSOR_COUNT; i++)
+    {
+        sns = &soak_sensor[i];
+        sns_ctx = context->ptrWdConfig[i].ptrSnsContext;
+        touched = (0u != (sns_ctx->status & CY_CAPSENSE_SNS_TOUCH_STATUS_MASK));
+
+        if (touched && (0.0 == sns->finger))
+        {
+            if (0u == sns->stuck_since)
+            {
+                sns->stuck_since = now;
+            }
+            if ((now - sns->stuck_since) > stuck_us)
+            {
+                violation(CHECK_STUCK, now);
+            }
+        }
+        else
+        {
+            sns->stuck_since = 0u;
+        }
+
+        if ((0.0 != sns->finger) && !touched && ((now - sns->finger_since) > missed_us))
+        {
+            violation(CHECK_MISSED, now);
+        }
+
+        if (0.0 == sns->finger)
+        {
+            err = fabs((sns_ctx->bsln + (sns_ctx->bslnExt / 256.0)) - (sns->base + soak_drift + sns->step));
+            if (err > soak_res.max_bsln_err)
+            {
+                soak_res.max_bsln_err = err;
+            }
+            if (err > prm.bsln_track)
+            {
+                violation(CHECK_BSLN_TRACK, now);
+            }
+        }
+    }
+
+    if (0u != host_regs.health.flags)
+    {
+        soak_first(now);
+    }
+
+    if (now >= soak_next_stall)
+    {
+        soak_next_stall = now + rng_exp_us(soak_sc->stall_rate_h);
+        sim_run(SIM_REGION_PROCESS, (uint64_t)(soak_sc->stall_ms * (SystemCoreClock / 1000.0)));
+    }
+}
+
+/*******************************************************************************
+* Function Name: soak_report
+********************************************************************************
+* Summary:
+*  Adds the device checks of the health block to the result at the end of
+*  the run and passes the result to the parent.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - 0, the parent evaluates the result
+*
+*******************************************************************************/
+static uint32_t soak_report(void)
+{
+    const health_t *health = &host_regs.health;
+
+    soak_res.frames = sim_frame_stats.frames;
+    soak_res.hours = sim_now_ns() / (US_PER_HOUR * 1000.0);
+    soak_res.violations[CHECK_LONG] = health->violations[HEALTH_CHECK_STUCK_TOUCH];
+    soak_res.violations[CHECK_BSLN_RANGE] = (uint64_t)health->violations[HEALTH_CHECK_BSLN_LOW] +
+                                            health->violations[HEALTH_CHECK_BSLN_HIGH];
+    soak_res.violations[CHECK_BUDGET] = health->violations[HEALTH_CHECK_FRAME_BUDGET];
+    soak_res.max_period_us = health->max_frame_us;
+    soak_res.max_touch_s = health->max_touch_ms * 1.0e-3;
+    if (0u != health->flags)
+    {
+        soak_first(sim_now_ns() / 1000u);
+    }
+
+    if (write(soak_fd, &soak_res, sizeof(soak_res)) != (ssize_t)sizeof(soak_res))
+    {
+        _exit(2);
+    }
+
+    return (0u);
+}
+
+/*******************************************************************************
+* Function Name: run_scenario
+********************************************************************************
+* Summary:
+*  Runs one scenario for prm.hours of virtual time in the worker process.
+*  main.c is built with its main() renamed to app_main(); sim_report() ends
+*  the process after soak_report() has passed the result.
+*
+* Parameters:
+*  sc - scenario
+*  index - scenario index, selects the random seed
+*  fd - pipe to the parent
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void run_scenario(const scenario_t *sc, uint32_t index, int fd)
+{
+    double cal = ((1uL << sim_params.resolution) - 1u) * prm.cal_percent / 100.0;
+    uint32_t i;
+
+    soak_sc = sc;
+    soak_fd = fd;
+    soak_noise = sc->noise;
+    rng_state = 0x9E3779B97F4A7C15uLL * (prm.seed + index + 1u);
+
+    for (i = 0u; i < CY_CAPSENSE_SENSOR_COUNT; i++)
+    {
+        soak_sensor[i].base = cal + (rng_uniform() - 0.5) * 20.0;
+        soak_sensor[i].next_touch = rng_exp_us(sc->touch_rate_h);
+    }
+    soak_next_burst = rng_exp_us(sc->burst_rate_h);
+    soak_next_stall = rng_exp_us(sc->stall_rate_h);
+
+    sim_params.duration_s = prm.hours * 3600.0;
+    sim_raw_source = soak_raw;
+    sim_frame_hook = soak_frame;
+    sim_report_hook = soak_report;
+
+    (void)app_main();
+
+    /* app_main() does not return */
+    _exit(2);
+}
+
+/*******************************************************************************
+* Function Name: parse_args
+********************************************************************************
+* Summary:
+*  Reads name=value parameters from the command line.
+*
+* Parameters:
+*  argc, argv - command line
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void parse_args(int argc, char **argv)
+{
+    static const struct
+    {
+        const char *name;
+        double *value;
+    } dparams[] =
+    {
+        { "hours", &prm.hours },
+        { "cal_percent", &prm.cal_percent },
+        { "signal_min", &prm.signal_min },
+        { "signal_max", &prm.signal_max },
+        { "stuck_ms", &prm.stuck_ms },
+        { "missed_ms", &prm.missed_ms },
+        { "bsln_track", &prm.bsln_track },
+    };
+    static const struct
+    {
+        const char *name;
+        uint32_t *value;
+    } uparams[] =
+    {
+        { "resolution", &sim_params.resolution },
+        { "finger_th", &sim_params.finger_th },
+        { "hysteresis", &sim_params.hysteresis },
+        { "noise_th", &sim_params.noise_th },
+        { "nnoise_th", &sim_params.nnoise_th },
+        { "low_bsln_rst", &sim_params.low_bsln_rst },
+        { "on_debounce", &sim_params.on_debounce },
+        { "bsln_coeff", &sim_params.bsln_coeff },
+        { "process_cycles", &sim_params.process_cycles },
+        { "seed", &prm.seed },
+    };
+    const char *val;
+    size_t len;
+    size_t i;
+    int arg;
+    int found;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        val = strchr(argv[arg], '=');
+        if (NULL == val)
+        {
+            fprintf(stderr, "usage: %s [name=value ...], see README.md\n", argv[0]);
+            exit(2);
+        }
+        len = (size_t)(val - argv[arg]);
+        val++;
+        found = 0;
+
+        if ((4u == len) && (0 == strncmp(argv[arg], "only", 4u)))
+        {
+            prm.only = val;
+            found = 1;
+        }
+        for (i = 0u; !found && (i < (sizeof(dparams) / sizeof(dparams[0]))); i++)
+        {
+            if ((strlen(dparams[i].name) == len) && (0 == strncmp(argv[arg], dparams[i].name, len)))
+            {
+                *dparams[i].value = atof(val);
+                found = 1;
+            }
+        }
+        for (i = 0u; !found && (i < (sizeof(uparams) / sizeof(uparams[0]))); i++)
+        {
+            if ((strlen(uparams[i].name) == len) && (0 == strncmp(argv[arg], uparams[i].name, len)))
+            {
+                *uparams[i].value = (uint32_t)strtoul(val, NULL, 0);
+                found = 1;
+            }
+        }
+        if (!found)
+        {
+            fprintf(stderr, "unknown parameter: %s\n", argv[arg]);
+            exit(2);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs every scenario in its own process, at most one per CPU core at a
+*  time, and prints one summary line per scenario. The workers print the
+*  summary of the scan loop checks only when a single scenario is selected.
+*  Returns 1 if any check failed.
+*
+* Parameters:
+*  argc, argv - command line
+*
+* Return:
+*  int
+*
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    soak_result_t results[SCENARIO_COUNT];
+    int fds[SCENARIO_COUNT];
+    pid_t pids[SCENARIO_COUNT];
+    int codes[SCENARIO_COUNT];
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    long running = 0;
+    uint32_t started = 0u;
+    uint32_t i;
+    uint32_t c;
+    int pipefd[2];
+    int status;
+    int failed = 0;
+    pid_t pid;
+
+    parse_args(argc, argv);
+
+    for (i = 0u; i < GAUSS_TABLE_SIZE; i++)
+    {
+        /* Inverse normal CDF at the bin centers through erfc bisection */
+        double p = (i + 0.5) / GAUSS_TABLE_SIZE;
+        double lo = -8.0;
+        double hi = 8.0;
+
+        for (c = 0u; c < 60u; c++)
+        {
+            double mid = 0.5 * (lo + hi);
+
+            if ((0.5 * erfc(-mid / M_SQRT2)) < p)
+            {
+                lo = mid;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        gauss_table[i] = (float)(0.5 * (lo + hi));
+    }
+
+    memset(pids, 0, sizeof(pids));
+    memset(codes, 0, sizeof(codes));
+    fflush(stdout);
+    for (i = 0u; i < SCENARIO_COUNT; i++)
+    {
+        if ((NULL != prm.only) && (0 != strcmp(prm.only, scenarios[i].name)))
+        {
+            continue;
+        }
+
+        /* Wait for a free core */
+        while (running >= cores)
+        {
+            pid = wait(&status);
+            for (c = 0u; c < SCENARIO_COUNT; c++)
+            {
+                if (pid == pids[c])
+                {
+                    codes[c] = WIFEXITED(status) ? WEXITSTATUS(status) : 2;
+                }
+            }
+            running--;
+        }
+
+        if (0 != pipe(pipefd))
+        {
+            perror("pipe");
+            return 2;
+        }
+        pid = fork();
+        if (0 == pid)
+        {
+            close(pipefd[0]);
+            if ((NULL == prm.only) && (NULL == freopen("/dev/null", "w", stdout)))
+            {
+                _exit(2);
+            }
+            run_scenario(&scenarios[i], i, pipefd[1]);
+        }
+        close(pipefd[1]);
+        fds[i] = pipefd[0];
+        pids[i] = pid;
+        running++;
+        started++;
+    }
+
+    if (0u == started)
+    {
+        fprintf(stderr, "no scenario matches\n");
+        return 2;
+    }
+
+    while ((pid = wait(&status)) > 0)
+    {
+        for (c = 0u; c < SCENARIO_COUNT; c++)
+        {
+            if (pid == pids[c])
+            {
+                codes[c] = WIFEXITED(status) ? WEXITSTATUS(status) : 2;
+            }
+        }
+    }
+
+    printf("%-11s %7s %8s %8s", "scenario", "hours", "frames", "touches");
+    for (c = 0u; c < CHECK_COUNT; c++)
+    {
+        printf(" %10s", check_names[c]);
+    }
+    printf(" %8s %9s %8s %8s\n", "first_h", "period_us", "bsln_err", "touch_s");
+
+    for (i = 0u; i < SCENARIO_COUNT; i++)
+    {
+        uint64_t total = 0u;
+
+        if (0 == pids[i])
+        {
+            continue;
+        }
+        if (read(fds[i], &results[i], sizeof(results[i])) != (ssize_t)sizeof(results[i]))
+        {
+            fprintf(stderr, "%s: worker failed\n", scenarios[i].name);
+            failed = 1;
+            continue;
+        }
+        close(fds[i]);
+
+        printf("%-11s %7.1f %7.3gM %8llu", scenarios[i].name, results[i].hours,
+               results[i].frames * 1.0e-6, (unsigned long long)results[i].touches);
+        for (c = 0u; c < CHECK_COUNT; c++)
+        {
+            printf(" %10llu", (unsigned long long)results[i].violations[c]);
+            total += results[i].violations[c];
+        }
+        if (0u != total)
+        {
+            printf(" %8.3f", results[i].first_violation_h);
+            failed = 1;
+        }
+        else
+        {
+            printf(" %8s", "-");
+        }
+        printf(" %9.0f %8.1f %8.1f\n", results[i].max_period_us, results[i].max_bsln_err,
+               results[i].max_touch_s);
+    }
+
+    for (i = 0u; i < SCENARIO_COUNT; i++)
+    {
+        if ((0 != pids[i]) && (0 != codes[i]))
+        {
+            printf("%s: scan loop checks failed, run it with only=%s for the summary\n",
+                   scenarios[i].name, scenarios[i].name);
+            failed = 1;
+        }
+    }
+
+    return failed;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+"""Estimates the offset and drift of the device clock from sync exchanges.
+
+One exchange:
+    t1  host time before writing HOST_CMD_TIME_SYNC to the mailbox
+    t4  host time after the write has completed
+    d   device time latched by the EZI2C ISR at the end of the write, read
+        later from the sync block
+
+The device time lies between t1 and t4. Exchanges with a short round trip
+bound it tightly, so the estimator keeps a window of recent exchanges, drops
+the ones with a long round trip, and fits device time against host time with
+a least-squares line. The line maps the time stamps of the frame block to host
+time.
+
+The --simulate option runs several devices with drifting clocks and a host
+with jittery transfers, and reports how well their frames are aligned on the
+host time line.
+"""
+
+import argparse
+import random
+
+DEVICE_WRAP = 1 << 32
+
+
+class ClockEstimator:
+    def __init__(self, window=128, keep=0.25):
+        self.window = window
+        self.keep = keep
+        self.samples = []
+        self.wraps = 0
+        self.last_device = None
+        self.rate = 1e6
+        self.offset = 0.0
+
+    def _unwrap(self, device_us):
+        if self.last_device is not None and device_us < self.last_device:
+            self.wraps += 1
+        self.last_device = device_us
+        return device_us + self.wraps * DEVICE_WRAP
+
+    def add(self, t1, t4, device_us):
+        """Adds one exchange. t1 and t4 are host times in seconds."""
+        self.samples.append(((t1 + t4) / 2.0, t4 - t1, self._unwrap(device_us)))
+        self.samples = self.samples[-self.window:]
+        self._fit()
+
+    def _fit(self):
+        count = max(1, int(len(self.samples) * self.keep))
+        good = sorted(self.samples, key=lambda s: s[1])[:count]
+        if len(good) < 2:
+            host, _, device = good[0]
+            self.offset = device - self.rate * host
+            return
+
+        n = float(len(good))
+        mh = sum(s[0] for s in good) / n
+        md = sum(s[2] for s in good) / n
+        shh = sum((s[0] - mh) ** 2 for s in good)
+        if shh > 0.0:
+            self.rate = sum((s[0] - mh) * (s[2] - md) for s in good) / shh
+        self.offset = md - self.rate * mh
+
+    def to_host(self, device_us):
+        """Converts a device time stamp close to the last exchange to host seconds."""
+        unwrapped = device_us + self.wraps * DEVICE_WRAP
+        if self.last_device is not None and device_us > self.last_device + DEVICE_WRAP // 2:
+            unwrapped -= DEVICE_WRAP
+        return (unwrapped - self.offset) / self.rate
+
+    def drift_ppm(self):
+        return (self.rate / 1e6 - 1.0) * 1e6
+
+
+class SimDevice:
+    """Device clock with an initial offset, a frequency error and a slow
+    random walk of the frequency error, as seen with an uncalibrated IMO."""
+
+    def __init__(self, rng, drift_ppm, wander_ppm):
+        self.rng = rng
+        self.start = rng.uniform(0.0, 5.0)
+        self.ppm = rng.uniform(-drift_ppm, drift_ppm)
+        self.wander = wander_ppm
+        self.elapsed = 0.0
+        self.last_host = 0.0
+
+    def advance(self, host):
+        step = max(host - self.last_host, 0.0)
+        self.ppm += self.rng.gauss(0.0, self.wander) * step ** 0.5
+        self.elapsed += step * (1.0 + self.ppm * 1e-6)
+        self.last_host = host
+
+    def now_us(self, host):
+        self.advance(host)
+        return int((self.start + self.elapsed) * 1e6) % DEVICE_WRAP
+
+
+def simulate(args):
+    rng = random.Random(args.seed)
+    devices = [SimDevice(rng, args.drift_ppm, args.wander_ppm) for _ in range(args.devices)]
+    estimators = [ClockEstimator() for _ in devices]
+    errors = [[] for _ in devices]
+    pair_errors = []
+
+    host = 0.0
+    next_sync = 0.0
+    while host < args.duration:
+        host += args.frame_period
+        if host >= next_sync:
+            for dev, est in zip(devices, estimators):
+                # Host stack latency before the transfer and after it, the
+                # transfer itself, and the ISR latency on the device
+                t1 = host
+                start = t1 + rng.expovariate(1.0 / args.jitter)
+                end = start + args.transfer
+                d = dev.now_us(end + 5e-6)
+                t4 = end + rng.expovariate(1.0 / args.jitter)
+                est.add(t1, t4, d)
+            next_sync += args.sync_period
+            continue
+
+        if host < args.settle:
+            continue
+
+        # All devices sense the same event at the same host time
+        mapped = []
+        for i, (dev, est) in enumerate(zip(devices, estimators)):
+            m = est.to_host(dev.now_us(host))
+            errors[i].append(abs(m - host))
+            mapped.append(m)
+        pair_errors.append(max(mapped) - min(mapped))
+
+    def p99(values):
+        values = sorted(values)
+        return values[int(0.99 * (len(values) - 1))]
+
+    for i, (dev, est) in enumerate(zip(devices, estimators)):
+        print("device %d: true drift %+8.1f ppm, estimated %+8.1f ppm, "
+              "error p99 %7.1f us, max %7.1f us" %
+              (i, dev.ppm, est.drift_ppm(), p99(errors[i]) * 1e6, max(errors[i]) * 1e6))
+    print("cross-device alignment: p99 %.1f us, max %.1f us" %
+          (p99(pair_errors) * 1e6, max(pair_errors) * 1e6))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--simulate", action="store_true", help="run the drift simulation")
+    parser.add_argument("--devices", type=int, default=4)
+    parser.add_argument("--duration", type=float, default=600.0, help="seconds")
+    parser.add_argument("--settle", type=float, default=30.0, help="seconds before scoring")
+    parser.add_argument("--frame-period", type=float, default=0.01, help="seconds")
+    parser.add_argument("--sync-period", type=float, default=0.5, help="seconds")
+    parser.add_argument("--transfer", type=float, default=150e-6, help="write duration, seconds")
+    parser.add_argument("--jitter", type=float, default=1e-3, help="mean host latency, seconds")
+    parser.add_argument("--drift-ppm", type=float, default=20000.0, help="max frequency error")
+    parser.add_argument("--wander-ppm", type=float, default=1.0, help="frequency random walk per sqrt(s)")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    if args.simulate:
+        simulate(args)
+    else:
+        parser.print_help()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,301 @@
+/******************************************************************************
+* File Name: timing_sim.c
+*
+* Description: Host timing model of the scan loop: the bare-metal loop of
+*              main.c runs on the simulated hardware of rtos_posix in virtual
+*              time, with the CPU time of the middleware, the CSD conversion
+*              time, the I2C byte timing and NVIC preemption modelled by
+*              rtos_posix/sim_time.c.
+*              Build with: make -C tools/rtos_posix timing_sim
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cycfg_capsense.h"
+#include "sim_hw.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Read period of the application host by default, in microseconds */
+#define TIMING_POLL_US_DEFAULT   (10000u)
+
+/* Simulated time by default, one hour */
+#define TIMING_SECONDS_DEFAULT   (3600.0)
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+int app_main(void);
+
+/*******************************************************************************
+* Function Name: timing_us
+********************************************************************************
+* Summary:
+*  Converts CPU cycles to microseconds.
+*
+* Parameters:
+*  cycles - time in CPU cycles
+*
+* Return:
+*  double - time in microseconds
+*
+*******************************************************************************/
+static double timing_us(double cycles)
+{
+    return ((cycles * 1e6) / SystemCoreClock);
+}
+
+/*******************************************************************************
+* Function Name: timing_report
+********************************************************************************
+* Summary:
+*  Prints the timing tables after the summary of sim_report(): the frame
+*  period and scan time, the I2C clock stretch per master and the load and
+*  entry latency of every interrupt level.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  uint32_t - 0, the model has no pass criteria of its own
+*
+*******************************************************************************/
+static uint32_t timing_report(void)
+{
+    static const char *masters[SIM_MASTER_COUNT] = { "host", "tuner" };
+    static const char *levels[SIM_LEVEL_COUNT] = { "systick", "ezi2c_isr", "csd_isr", "main" };
+    const sim_frame_stats_t *fs = &sim_frame_stats;
+    double now = (double)sim_time_cycles();
+    double conv = (double)(((1uLL << sim_params.resolution) - 1u) + sim_params.init_mod_cycles) *
+                  sim_params.mod_div;
+    uint32_t m;
+    uint32_t lvl;
+
+    printf("simulated %.1f s, %lu frames, %llu I2C transactions\n", now / SystemCoreClock,
+           (unsigned long)fs->frames,
+           (unsigned long long)(sim_i2c_stats[SIM_MASTER_HOST].transactions +
+                                sim_i2c_stats[SIM_MASTER_TUNER].transactions));
+    if (fs->scans > 1u)
+    {
+        printf("frame period   min %8.1f  mean %8.1f  max %8.1f us\n",
+               (double)fs->period_min / 1000.0,
+               (double)fs->period_sum / (1000.0 * (double)(fs->scans - 1u)),
+               (double)fs->period_max / 1000.0);
+    }
+    if (0u != fs->frames)
+    {
+        printf("scan time      nominal %6.1f  mean %8.1f  max %8.1f us\n",
+               timing_us((conv + sim_params.csd_isr_cycles) * CY_CAPSENSE_SENSOR_COUNT),
+               (double)fs->scan_sum / (1000.0 * (double)fs->frames),
+               (double)fs->scan_max / 1000.0);
+    }
+
+    if ((0u != sim_i2c_stats[SIM_MASTER_HOST].bytes) && (0u == sim_params.poll_us[SIM_MASTER_TUNER]))
+    {
+        printf("I2C stretch    mean %8.2f  max %8.2f us per byte\n",
+               timing_us((double)sim_i2c_stats[SIM_MASTER_HOST].stretch_sum /
+                         (double)sim_i2c_stats[SIM_MASTER_HOST].bytes),
+               timing_us((double)sim_i2c_stats[SIM_MASTER_HOST].stretch_max));
+    }
+    else if (0u != sim_params.poll_us[SIM_MASTER_TUNER])
+    {
+        printf("address  transactions  isr_load  stretch mean    max  bus wait mean     max (us)\n");
+        for (m = 0u; m < SIM_MASTER_COUNT; m++)
+        {
+            const sim_i2c_stats_t *is = &sim_i2c_stats[m];
+
+            if (0u == is->bytes)
+            {
+                continue;
+            }
+            printf("%-7s %13llu %8.3f%% %13.2f %6.2f %14.2f %7.2f\n", masters[m],
+                   (unsigned long long)is->transactions,
+                   ((double)is->isr_busy * 100.0) / now,
+                   timing_us((double)is->stretch_sum / (double)is->bytes),
+                   timing_us((double)is->stretch_max),
+                   timing_us((double)is->wait_sum / (double)is->transactions),
+                   timing_us((double)is->wait_max));
+        }
+    }
+    else
+    {
+        /* No I2C traffic */
+    }
+
+    printf("level          count       load   latency mean     max (us)\n");
+    for (lvl = 0u; lvl < SIM_LEVEL_COUNT; lvl++)
+    {
+        const sim_level_stats_t *ls = &sim_level_stats[lvl];
+
+        printf("%-10s %10llu %9.2f%%", levels[lvl], (unsigned long long)ls->count,
+               ((double)ls->busy * 100.0) / now);
+        if ((lvl < SIM_LEVEL_MAIN) && (0u != ls->count))
+        {
+            printf(" %10.2f %10.2f", timing_us((double)ls->latency_sum / (double)ls->count),
+                   timing_us((double)ls->latency_max));
+        }
+        printf("\n");
+    }
+
+    return (0u);
+}
+
+/*******************************************************************************
+* Function Name: parse_args
+********************************************************************************
+* Summary:
+*  Reads the name=value parameters of the command line into sim_params.
+*
+* Parameters:
+*  argc, argv - command line
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void parse_args(int argc, char **argv)
+{
+    static const struct
+    {
+        const char *name;
+        uint32_t *value;
+    } params[] =
+    {
+        { "cpu_hz", &SystemCoreClock },
+        { "resolution", &sim_params.resolution },
+        { "mod_div", &sim_params.mod_div },
+        { "init_mod_cycles", &sim_params.init_mod_cycles },
+        { "entry_cycles", &sim_params.entry_cycles },
+        { "systick_cycles", &sim_params.systick_cycles },
+        { "csd_isr_cycles", &sim_params.csd_isr_cycles },
+        { "ezi2c_isr_cycles", &sim_params.ezi2c_isr_cycles[SIM_MASTER_HOST] },
+        { "ezi2c_isr2_cycles", &sim_params.ezi2c_isr_cycles[SIM_MASTER_TUNER] },
+        { "scan_setup_cycles", &sim_params.scan_setup_cycles },
+        { "process_cycles", &sim_params.process_cycles },
+        { "tuner_cycles", &sim_params.tuner_cycles },
+        { "bist_cycles", &sim_params.bist_cycles },
+        { "flash_cycles", &sim_params.flash_cycles },
+        { "i2c_hz", &sim_params.i2c_hz },
+        { "poll_us", &sim_params.poll_us[SIM_MASTER_HOST] },
+        { "read_bytes", &sim_params.read_bytes[SIM_MASTER_HOST] },
+        { "poll2_us", &sim_params.poll_us[SIM_MASTER_TUNER] },
+        { "read2_bytes", &sim_params.read_bytes[SIM_MASTER_TUNER] },
+    };
+    char *eq;
+    size_t len;
+    size_t i;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        eq = strchr(argv[arg], '=');
+        if (NULL == eq)
+        {
+            fprintf(stderr, "usage: %s [name=value ...], see README.md\n", argv[0]);
+            exit(1);
+        }
+        len = (size_t)(eq - argv[arg]);
+
+        if ((strlen("duration_s") == len) && (0 == strncmp(argv[arg], "duration_s", len)))
+        {
+            sim_params.duration_s = atof(eq + 1);
+        }
+        else if ((strlen("vcd") == len) && (0 == strncmp(argv[arg], "vcd", len)))
+        {
+            sim_params.vcd_path = eq + 1;
+        }
+        else if ((strlen("vcd_ms") == len) && (0 == strncmp(argv[arg], "vcd_ms", len)))
+        {
+            sim_params.vcd_ms = atof(eq + 1);
+        }
+        else if ((strlen("sensors") == len) && (0 == strncmp(argv[arg], "sensors", len)))
+        {
+            /* main.c sizes its buffers from the CapSense configuration */
+            fprintf(stderr, "sensors is set at build time: make timing_sim SENSORS=%s\n", eq + 1);
+            exit(1);
+        }
+        else
+        {
+            for (i = 0u; i < (sizeof(params) / sizeof(params[0])); i++)
+            {
+                if ((strlen(params[i].name) == len) && (0 == strncmp(argv[arg], params[i].name, len)))
+                {
+                    *params[i].value = (uint32_t)strtoul(eq + 1, NULL, 0);
+                    break;
+                }
+            }
+            if (i == (sizeof(params) / sizeof(params[0])))
+            {
+                fprintf(stderr, "unknown parameter: %s\n", argv[arg]);
+                exit(1);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Sets up the model and runs the application. main.c is built with its main()
+*  renamed to app_main(); sim_report() prints the timing tables through the
+*  report hook and ends the program when the simulated time is over.
+*
+* Parameters:
+*  argc, argv - command line
+*
+* Return:
+*  int
+*
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    sim_params.duration_s = TIMING_SECONDS_DEFAULT;
+    sim_params.poll_us[SIM_MASTER_HOST] = TIMING_POLL_US_DEFAULT;
+    sim_report_hook = timing_report;
+
+    parse_args(argc, argv);
+
+    return (app_main());
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+"""Expands the touch history block of a register map dump.
+
+Each history entry holds the touch mask of all sensors and the number of
+consecutive frames with that mask. The newest entry ends at the frame
+sequence number of the block, so the frame range of every entry is known.
+
+Usage:
+    touch_history.py dump.bin            list the runs
+    touch_history.py --frames dump.bin   one CSV line per frame
+"""
+
+import argparse
+import sys
+
+import hostregs
+
+
+def read_history(regs):
+    offset = regs.block(hostregs.BLOCK_TOUCH_HISTORY)
+    if offset is None:
+        raise ValueError("the firmware was built without TOUCH_HISTORY_EN")
+
+    seq, capacity, head, count, sensors, run_bits = regs.unpack("IHHHBB", offset)
+    entries = regs.unpack("%dI" % capacity, offset + 12)
+    seq_end = regs.unpack("I", offset + 12 + 4 * capacity)[0]
+    if seq != seq_end:
+        raise ValueError("torn read, the block changed during the transfer")
+
+    runs = []
+    for i in range(count):
+        entry = entries[(head + i) % capacity]
+        runs.append((entry >> run_bits, entry & ((1 << run_bits) - 1)))
+
+    # Assign frame numbers backwards from the newest entry
+    result = []
+    last = seq
+    for mask, length in reversed(runs):
+        result.append((last - length + 1, last, mask))
+        last -= length
+    result.reverse()
+    return sensors, result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dump", help="binary dump of the register map")
+    parser.add_argument("--frames", action="store_true", help="expand to one line per frame")
+    args = parser.parse_args()
+
+    try:
+        sensors, runs = read_history(hostregs.load(args.dump))
+    except ValueError as err:
+        sys.exit(str(err))
+
+    if args.frames:
+        print("frame," + ",".join("sns%d" % s for s in range(sensors)))
+        for first, last, mask in runs:
+            bits = ",".join(str((mask >> s) & 1) for s in range(sensors))
+            for frame in range(first, last + 1):
+                print("%d,%s" % (frame, bits))
+    else:
+        print("first,last,frames,mask")
+        for first, last, mask in runs:
+            print("%d,%d,%d,0x%X" % (first, last, last - first + 1, mask))
+
+
+if __name__ == "__main__":
+    main()
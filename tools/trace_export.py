@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""Converts the trace block of a register map dump to Chrome trace JSON.
+
+Freeze the trace with HOST_CMD_TRACE_FREEZE before reading the register map,
+so that no event is overwritten during the transfer. The output opens in
+chrome://tracing and in the Perfetto UI (ui.perfetto.dev).
+
+Usage:
+    trace_export.py dump.bin > trace.json
+"""
+
+import argparse
+import json
+import sys
+
+import hostregs
+
+# Event ID: (name, track, phase). B and E mark the start and end of a
+# duration, i marks an instant.
+EVENTS = {
+    0x01: ("capsense_isr", "capsense_isr", "B"),
+    0x02: ("capsense_isr", "capsense_isr", "E"),
+    0x03: ("ezi2c_isr", "ezi2c_isr", "B"),
+    0x04: ("ezi2c_isr", "ezi2c_isr", "E"),
+    0x05: ("scan_start", "main", "i"),
+    0x06: ("process", "main", "B"),
+    0x07: ("process", "main", "E"),
+    0x08: ("tuner", "main", "B"),
+    0x09: ("tuner", "main", "E"),
+    0x0A: ("bist", "main", "B"),
+    0x0B: ("bist", "main", "E"),
+    0x0C: ("host_cmd", "main", "i"),
+}
+
+TRACKS = ["main", "capsense_isr", "ezi2c_isr"]
+
+STAMP_BITS = 24
+
+
+def read_trace(regs):
+    offset = regs.block(hostregs.BLOCK_TRACE)
+    if offset is None:
+        raise ValueError("the firmware was built without TRACE_EN")
+
+    head, clock_hz, capacity, cost, time_shift, frozen = regs.unpack("IIHHBB", offset)
+    entries = regs.unpack("%dI" % capacity, offset + 16)
+
+    count = min(head, capacity)
+    events = [entries[i % capacity] for i in range(head - count, head)]
+    return events, clock_hz, time_shift, frozen, cost
+
+
+def to_chrome(events, clock_hz, time_shift):
+    us_per_tick = (1 << time_shift) * 1e6 / clock_hz
+    mask = (1 << STAMP_BITS) - 1
+
+    out = []
+    for tid, name in enumerate(TRACKS):
+        out.append({"ph": "M", "name": "thread_name", "pid": 0, "tid": tid,
+                    "args": {"name": name}})
+
+    ticks = 0
+    last = None
+    depth = dict((track, 0) for track in TRACKS)
+    for event in events:
+        stamp = event & mask
+        if last is not None:
+            ticks += (stamp - last) & mask
+        last = stamp
+
+        name, track, phase = EVENTS.get(event >> STAMP_BITS,
+                                        ("event_0x%02X" % (event >> STAMP_BITS), "main", "i"))
+        # The oldest events may end durations that began before the trace
+        if phase == "B":
+            depth[track] += 1
+        elif phase == "E":
+            if depth[track] == 0:
+                continue
+            depth[track] -= 1
+
+        record = {"name": name, "ph": phase, "ts": ticks * us_per_tick,
+                  "pid": 0, "tid": TRACKS.index(track)}
+        if phase == "i":
+            record["s"] = "t"
+        out.append(record)
+    return {"traceEvents": out, "displayTimeUnit": "ns"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dump", help="binary dump of the register map")
+    args = parser.parse_args()
+
+    try:
+        events, clock_hz, time_shift, frozen, cost = read_trace(hostregs.load(args.dump))
+    except ValueError as err:
+        sys.exit(str(err))
+
+    if not frozen:
+        sys.stderr.write("warning: the trace was not frozen, the oldest events may be torn\n")
+    sys.stderr.write("%d events, %d cycles per event\n" % (len(events), cost))
+    json.dump(to_chrome(events, clock_hz, time_shift), sys.stdout, indent=1)
+
+
+if __name__ == "__main__":
+    main()
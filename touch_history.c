@@ -0,0 +1,169 @@
+/******************************************************************************
+* File Name: touch_history.c
+*
+* Description: This file contains the run-length coded touch activity history.
+*              The touch state of every sensor is kept for thousands of frames in
+*              a few hundred bytes by storing one entry per change of the touch
+*              mask instead of one entry per frame.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdbool.h>
+#include <string.h>
+#include "touch_history.h"
+
+#if TOUCH_HISTORY_EN
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+/* History storage, provided by the register map */
+static touch_history_t *touch_history;
+
+/*******************************************************************************
+* Function Name: touch_history_init
+********************************************************************************
+* Summary:
+*  Clears the history.
+*
+* Parameters:
+*  history - storage of the history
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void touch_history_init(touch_history_t *history)
+{
+    touch_history = history;
+
+    memset(history, 0, sizeof(touch_history_t));
+    history->capacity = TOUCH_HISTORY_ENTRIES;
+    history->sensors = CY_CAPSENSE_SENSOR_COUNT;
+    history->run_bits = TOUCH_HISTORY_RUN_BITS;
+}
+
+/*******************************************************************************
+* Function Name: touch_history_update
+********************************************************************************
+* Summary:
+*  Adds the touch state of the processed frame. Extends the newest entry while
+*  the touch mask is unchanged, otherwise starts a new entry and overwrites the
+*  oldest one when the ring is full.
+*
+* Parameters:
+*  frame - frame sequence number
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void touch_history_update(uint32_t frame)
+{
+    const cy_stc_capsense_widget_config_t *wd_cfg;
+    touch_history_t *history = touch_history;
+    uint32_t mask = 0u;
+    uint32_t sns_index = 0u;
+    bool mask_changed = true;
+    uint32_t newest;
+    uint32_t entry;
+    uint32_t wd;
+    uint32_t sns;
+
+    for (wd = 0u; wd < CY_CAPSENSE_WIDGET_COUNT; wd++)
+    {
+        wd_cfg = &cy_capsense_context.ptrWdConfig[wd];
+
+        for (sns = 0u; sns < wd_cfg->numSns; sns++)
+        {
+            if (0u != (wd_cfg->ptrSnsContext[sns].status & CY_CAPSENSE_SNS_TOUCH_STATUS_MASK))
+            {
+                mask |= (1uL << sns_index);
+            }
+            sns_index++;
+        }
+    }
+
+    /* seq_end first and seq last, see host_regs_publish_frame() */
+    history->seq_end = frame;
+    __DMB();
+
+    if (0u != history->count)
+    {
+        newest = (uint32_t)history->head + history->count - 1u;
+        if (newest >= TOUCH_HISTORY_ENTRIES)
+        {
+            newest -= TOUCH_HISTORY_ENTRIES;
+        }
+        entry = history->entry[newest];
+
+        if (((entry >> TOUCH_HISTORY_RUN_BITS) == mask) &&
+            ((entry & TOUCH_HISTORY_RUN_MAX) < TOUCH_HISTORY_RUN_MAX))
+        {
+            history->entry[newest] = entry + 1u;
+            mask_changed = false;
+        }
+    }
+
+    if (mask_changed)
+    {
+        if (history->count < TOUCH_HISTORY_ENTRIES)
+        {
+            history->count++;
+        }
+        else
+        {
+            history->head = (uint16_t)((history->head + 1u) % TOUCH_HISTORY_ENTRIES);
+        }
+
+        newest = (uint32_t)history->head + history->count - 1u;
+        if (newest >= TOUCH_HISTORY_ENTRIES)
+        {
+            newest -= TOUCH_HISTORY_ENTRIES;
+        }
+        history->entry[newest] = (mask << TOUCH_HISTORY_RUN_BITS) | 1u;
+    }
+
+    __DMB();
+    history->seq = frame;
+}
+
+#endif /* TOUCH_HISTORY_EN */
+
+/* [] END OF FILE */
@@ -0,0 +1,103 @@
+/******************************************************************************
+* File Name: touch_history.h
+*
+* Description: This file contains the interface of the run-length coded touch
+*              activity history.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef TOUCH_HISTORY_H_
+#define TOUCH_HISTORY_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include "cy_pdl.h"
+#include "cycfg_capsense.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Enables the long-horizon touch activity history */
+#ifndef TOUCH_HISTORY_EN
+#define TOUCH_HISTORY_EN                 (0u)
+#endif
+
+/* Number of history entries, 4 bytes each */
+#define TOUCH_HISTORY_ENTRIES            (64u)
+
+/* Each entry holds the touch mask of all sensors in its upper bits and the
+ * number of consecutive frames with that mask in the lower bits.
+ */
+#define TOUCH_HISTORY_RUN_BITS           (32u - CY_CAPSENSE_SENSOR_COUNT)
+#define TOUCH_HISTORY_RUN_MAX            ((1uL << TOUCH_HISTORY_RUN_BITS) - 1u)
+
+#if TOUCH_HISTORY_EN
+
+#if CY_CAPSENSE_SENSOR_COUNT > 16u
+#error "The touch history supports up to 16 sensors"
+#endif
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* History ring. The oldest entry is at head, the newest entry ends at frame
+ * seq. seq and seq_end match when the block was read consistently.
+ */
+typedef struct
+{
+    uint32_t seq;
+    uint16_t capacity;
+    uint16_t head;
+    uint16_t count;
+    uint8_t sensors;
+    uint8_t run_bits;
+    uint32_t entry[TOUCH_HISTORY_ENTRIES];
+    uint32_t seq_end;
+} touch_history_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void touch_history_init(touch_history_t *history);
+void touch_history_update(uint32_t frame);
+
+#endif /* TOUCH_HISTORY_EN */
+
+#endif /* TOUCH_HISTORY_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,119 @@
+/******************************************************************************
+* File Name: trace.c
+*
+* Description: This file contains the event trace buffer. Events from the main
+*              loop and the ISRs are written into a ring that the host downloads
+*              from the register map.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <string.h>
+#include "trace.h"
+
+#if TRACE_EN
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Events recorded to measure the cost of one event */
+#define TRACE_CALIBRATE_EVENTS           (8u)
+
+/*******************************************************************************
+* Global Definitions
+*******************************************************************************/
+/* Trace storage, provided by the register map */
+trace_t *trace_buffer;
+
+/*******************************************************************************
+* Function Name: trace_init
+********************************************************************************
+* Summary:
+*  Clears the trace and measures the cost of one event. Must be called after
+*  timestamp_init() and before the first event.
+*
+* Parameters:
+*  trace - storage of the trace
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void trace_init(trace_t *trace)
+{
+    uint32_t start;
+    uint32_t i;
+
+    memset(trace, 0, sizeof(trace_t));
+    trace->clock_hz = SystemCoreClock;
+    trace->capacity = TRACE_ENTRIES;
+    trace->time_shift = TRACE_TIME_SHIFT;
+    trace_buffer = trace;
+
+    start = timestamp_get_cycles();
+    for (i = 0u; i < TRACE_CALIBRATE_EVENTS; i++)
+    {
+        trace_event(TRACE_EVT_CALIBRATE);
+    }
+    trace->cost_cycles = (uint16_t)((timestamp_get_cycles() - start) / TRACE_CALIBRATE_EVENTS);
+
+    trace->head = 0u;
+}
+
+/*******************************************************************************
+* Function Name: trace_freeze
+********************************************************************************
+* Summary:
+*  Stops or resumes recording, so that the host can download a consistent
+*  trace.
+*
+* Parameters:
+*  freeze - true to stop recording
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void trace_freeze(bool freeze)
+{
+    trace_buffer->frozen = freeze ? 1u : 0u;
+}
+
+#endif /* TRACE_EN */
+
+/* [] END OF FILE */
@@ -0,0 +1,166 @@
+/******************************************************************************
+* File Name: trace.h
+*
+* Description: This file contains the interface of the event trace buffer. Events
+*              are 4 bytes: an 8-bit event ID and a 24-bit time stamp.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+*******************************************************************************/
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_pdl.h"
+#include "timestamp.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Enables the event trace buffer */
+#define TRACE_EN                         (0u)
+
+/* Number of events kept, a power of two */
+#define TRACE_ENTRIES                    (128u)
+
+/* Time stamps count CPU cycles divided by 2^TRACE_TIME_SHIFT. At 48 MHz, 4
+ * gives a resolution of 1/3 us and wraps the 24-bit time stamp after 5.6 s.
+ */
+#define TRACE_TIME_SHIFT                 (4u)
+
+/* Event IDs. BEGIN and END events of one ID pair mark a duration. */
+#define TRACE_EVT_CALIBRATE              (0x00u)
+#define TRACE_EVT_CAPSENSE_ISR_BEGIN     (0x01u)
+#define TRACE_EVT_CAPSENSE_ISR_END       (0x02u)
+#define TRACE_EVT_EZI2C_ISR_BEGIN        (0x03u)
+#define TRACE_EVT_EZI2C_ISR_END          (0x04u)
+#define TRACE_EVT_SCAN_START             (0x05u)
+#define TRACE_EVT_PROCESS_BEGIN          (0x06u)
+#define TRACE_EVT_PROCESS_END            (0x07u)
+#define TRACE_EVT_TUNER_BEGIN            (0x08u)
+#define TRACE_EVT_TUNER_END              (0x09u)
+#define TRACE_EVT_BIST_BEGIN             (0x0Au)
+#define TRACE_EVT_BIST_END               (0x0Bu)
+#define TRACE_EVT_HOST_CMD               (0x0Cu)
+
+#if TRACE_EN
+
+#if (TRACE_ENTRIES & (TRACE_ENTRIES - 1u)) != 0u
+#error "TRACE_ENTRIES must be a power of two"
+#endif
+
+/* Records an event, compiles to nothing when the trace is disabled */
+#define TRACE_EVENT(id)                  trace_event(id)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Trace ring. head counts all events written, the newest one is at
+ * entry[(head - 1) % TRACE_ENTRIES]. Time stamps run at clock_hz >> time_shift.
+ * No events are written while frozen is set. cost_cycles is the measured cost
+ * of one event.
+ */
+typedef struct
+{
+    uint32_t head;
+    uint32_t clock_hz;
+    uint16_t capacity;
+    uint16_t cost_cycles;
+    uint8_t time_shift;
+    uint8_t frozen;
+    uint16_t reserved;
+    uint32_t entry[TRACE_ENTRIES];
+} trace_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern trace_t *trace_buffer;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void trace_init(trace_t *trace);
+void trace_freeze(bool freeze);
+
+/*******************************************************************************
+* Function Name: trace_event
+********************************************************************************
+* Summary:
+*  Records an event with the current time. Can be called from any ISR.
+*
+* Parameters:
+*  id - TRACE_EVT_* event ID
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+__STATIC_INLINE void trace_event(uint32_t id)
+{
+    uint32_t intr_state = Cy_SysLib_EnterCriticalSection();
+    uint32_t ms = timestamp_ms;
+    uint32_t val = SysTick->VAL;
+    uint32_t cycles;
+
+    /* The counter reloaded but the SysTick ISR did not run yet */
+    if (0u != (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk))
+    {
+        val = SysTick->VAL;
+        ms++;
+    }
+
+    if (0u == trace_buffer->frozen)
+    {
+        cycles = (ms * timestamp_cycles_per_ms) + (timestamp_cycles_per_ms - 1u - val);
+        trace_buffer->entry[trace_buffer->head & (TRACE_ENTRIES - 1u)] =
+            (id << 24u) | ((cycles >> TRACE_TIME_SHIFT) & 0x00FFFFFFu);
+        trace_buffer->head++;
+    }
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+}
+
+#else
+#define TRACE_EVENT(id)                  ((void)0)
+#endif /* TRACE_EN */
+
+#endif /* TRACE_H_ */
+
+/* [] END OF FILE */